@@ -0,0 +1,279 @@
+#include "AhoCorasick.h"
+#include <algorithm>
+#include <map>
+#include <set>
+
+AhoCorasick::AhoCorasick(const std::vector<std::vector<std::string>>& literals)
+	: numClasses(0), maxLength(0), numPatterns((int)literals.size())
+{
+	std::set<char> inputs;
+	std::set<char> startBytes;
+	for (const std::vector<std::string>& alternatives : literals)
+	{
+		for (const std::string& literal : alternatives)
+		{
+			inputs.insert(literal.begin(), literal.end());
+			startBytes.insert(literal[0]);
+		}
+	}
+
+	byteClasses = ByteClasses(inputs);
+	numClasses = byteClasses.NumClasses();
+
+	// build the trie with a map of children for each state, then pack the maps into arrays
+	std::vector<std::map<uint8_t, uint32_t>> children(1);
+	std::vector<std::vector<int>> statePatterns(1);
+	for (int pattern = 0; pattern < numPatterns; ++pattern)
+	{
+		for (const std::string& literal : literals[pattern])
+		{
+			uint32_t state = ROOT;
+			for (char input : literal)
+			{
+				uint8_t byteClass = byteClasses.Get(input);
+				auto childIt = children[state].find(byteClass);
+				if (childIt == children[state].end())
+				{
+					uint32_t child = (uint32_t)children.size();
+					children.emplace_back();
+					statePatterns.emplace_back();
+					childIt = children[state].emplace(byteClass, child).first;
+				}
+				state = childIt->second;
+			}
+
+			maxLength = std::max(maxLength, literal.size());
+
+			// a pattern can list the same literal twice, but is only reported once
+			if (statePatterns[state].empty() || statePatterns[state].back() != pattern)
+			{
+				statePatterns[state].push_back(pattern);
+			}
+		}
+	}
+
+	size_t numStates = children.size();
+	firstChild.reserve(numStates + 1);
+	firstPattern.reserve(numStates + 1);
+	for (size_t state = 0; state < numStates; ++state)
+	{
+		firstChild.push_back((uint32_t)childStates.size());
+		for (auto& child : children[state])
+		{
+			childClasses.push_back(child.first);
+			childStates.push_back(child.second);
+		}
+
+		firstPattern.push_back((uint32_t)patterns.size());
+		patterns.insert(patterns.end(), statePatterns[state].begin(), statePatterns[state].end());
+	}
+	firstChild.push_back((uint32_t)childStates.size());
+	firstPattern.push_back((uint32_t)patterns.size());
+
+	auto endsLiteral = [&](uint32_t state) { return firstPattern[state] != firstPattern[state + 1]; };
+
+	// the failure link of a string is found from the failure link of the string one shorter, so the
+	// trie is walked breadth first. The queue ends up holding every state in that order
+	failure.assign(numStates, ROOT);
+	longest.assign(numStates, 0);
+	outputLink.assign(numStates, NONE);
+	std::vector<uint32_t> depth(numStates, 0);
+	std::vector<uint32_t> queue = { ROOT };
+	for (size_t i = 0; i < queue.size(); ++i)
+	{
+		uint32_t state = queue[i];
+		for (uint32_t child = firstChild[state]; child < firstChild[state + 1]; ++child)
+		{
+			uint32_t next = childStates[child];
+			failure[next] = state == ROOT ? ROOT : NextSparse(failure[state], childClasses[child]);
+			depth[next] = depth[state] + 1;
+			longest[next] = endsLiteral(next) ? depth[next] : longest[failure[next]];
+			outputLink[next] = endsLiteral(failure[next]) ? failure[next] : outputLink[failure[next]];
+			queue.push_back(next);
+		}
+	}
+
+	// with the failure links followed ahead of time, each input is a single lookup
+	if (numStates * numClasses <= MAX_DENSE_ENTRIES)
+	{
+		table.assign(numStates * numClasses, ROOT);
+		for (uint32_t state : queue)
+		{
+			uint32_t* row = &table[(size_t)state * numClasses];
+			if (state != ROOT)
+			{
+				std::copy_n(&table[(size_t)failure[state] * numClasses], numClasses, row);
+			}
+			for (uint32_t child = firstChild[state]; child < firstChild[state + 1]; ++child)
+			{
+				row[childClasses[child]] = childStates[child];
+			}
+		}
+	}
+
+	if (startBytes.size() <= ByteScanner::MAX_BYTES)
+	{
+		startScanner = ByteScanner(std::string(startBytes.begin(), startBytes.end()));
+		canSkipStart = true;
+	}
+}
+
+uint32_t AhoCorasick::NextSparse(uint32_t state, uint8_t byteClass) const
+{
+	while (true)
+	{
+		const uint8_t* begin = childClasses.data() + firstChild[state];
+		const uint8_t* end = childClasses.data() + firstChild[state + 1];
+		const uint8_t* child = std::lower_bound(begin, end, byteClass);
+		if (child != end && *child == byteClass)
+		{
+			return childStates[child - childClasses.data()];
+		}
+
+		if (state == ROOT)
+		{
+			return ROOT;
+		}
+		state = failure[state];
+	}
+}
+
+size_t AhoCorasick::SkipStart(std::string_view text, size_t from) const
+{
+	if (!canSkipStart)
+	{
+		return from;
+	}
+
+	return from + startScanner.Find(text.data() + from, text.size() - from);
+}
+
+size_t AhoCorasick::Match(std::string_view text, std::vector<Regex::Span>& outMatches) const
+{
+	outMatches.clear();
+
+	size_t start = 0;
+	while (start < text.size())
+	{
+		// the automaton finds matches in the order they end, not the order they start. A match
+		// that starts before the best one found so far must end within maxLength of its start,
+		// so the search can stop once it is past that
+		size_t matchStart = text.size();
+		size_t matchEnd = 0;
+
+		uint32_t state = ROOT;
+		for (size_t i = start; i < text.size() && i < matchStart + maxLength; ++i)
+		{
+			if (state == ROOT && matchEnd == 0)
+			{
+				i = SkipStart(text, i);
+				if (i == text.size())
+				{
+					break;
+				}
+			}
+
+			state = Next(state, text[i]);
+			if (longest[state] != 0)
+			{
+				// the longest literal ending here is the one that starts first
+				size_t begin = i + 1 - longest[state];
+				if (begin < matchStart || (begin == matchStart && i + 1 > matchEnd))
+				{
+					matchStart = begin;
+					matchEnd = i + 1;
+				}
+			}
+		}
+
+		if (matchEnd == 0)
+		{
+			break;
+		}
+
+		outMatches.push_back({ matchStart, matchEnd - matchStart });
+		start = matchEnd;
+	}
+
+	return outMatches.size();
+}
+
+bool AhoCorasick::FindLine(std::string_view text, size_t from, Regex::Span& outLine) const
+{
+	// no literal contains a newline, so a newline always leads back to the root and a match
+	// never spans two lines
+	size_t hit = text.size();
+	uint32_t state = ROOT;
+	for (size_t i = from; i < text.size(); ++i)
+	{
+		if (state == ROOT)
+		{
+			i = SkipStart(text, i);
+			if (i == text.size())
+			{
+				break;
+			}
+		}
+
+		state = Next(state, text[i]);
+		if (longest[state] != 0)
+		{
+			hit = i;
+			break;
+		}
+	}
+
+	if (hit == text.size())
+	{
+		return false;
+	}
+
+	// find the boundaries of the matching line
+	size_t begin = hit;
+	while (begin > from && text[begin - 1] != '\n')
+	{
+		--begin;
+	}
+
+	size_t end = text.find('\n', hit);
+	if (end == std::string_view::npos)
+	{
+		end = text.size();
+	}
+
+	outLine = { begin, end - begin };
+	return true;
+}
+
+size_t AhoCorasick::MatchingPatterns(std::string_view text, std::vector<int>& outPatterns) const
+{
+	outPatterns.clear();
+	std::vector<bool> found(numPatterns, false);
+
+	uint32_t state = ROOT;
+	for (size_t i = 0; i < text.size() && (int)outPatterns.size() < numPatterns; ++i)
+	{
+		state = Next(state, text[i]);
+		if (longest[state] == 0)
+		{
+			continue;
+		}
+
+		// every literal that ends here is this state's string or one of its suffixes
+		uint32_t output = firstPattern[state] != firstPattern[state + 1] ? state : outputLink[state];
+		for (; output != NONE; output = outputLink[output])
+		{
+			for (uint32_t j = firstPattern[output]; j < firstPattern[output + 1]; ++j)
+			{
+				if (!found[patterns[j]])
+				{
+					found[patterns[j]] = true;
+					outPatterns.push_back(patterns[j]);
+				}
+			}
+		}
+	}
+
+	std::sort(outPatterns.begin(), outPatterns.end());
+	return outPatterns.size();
+}
@@ -0,0 +1,145 @@
+#pragma once
+#include "ByteClasses.h"
+#include "ByteScanner.h"
+#include "Regex.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/// <summary>
+/// Finds plain literal strings with the Aho-Corasick algorithm. Used by Regex instead of the NFA
+/// and DFAs when every pattern is an alternation of literals, since a trie of the literals takes
+/// time and memory linear in their total length to build, however many of them there are.
+///
+/// Reports matches the same way as Regex, and like Regex does not modify itself while matching,
+/// so it can be shared by any number of threads.
+/// </summary>
+class AhoCorasick
+{
+private:
+
+	// marks a missing state
+	static constexpr uint32_t NONE = UINT32_MAX;
+
+	// the trie is rooted at the state for the empty string
+	static constexpr uint32_t ROOT = 0;
+
+	// the most entries the dense transition table may have. Bigger automata follow the failure
+	// links while matching instead
+	static const size_t MAX_DENSE_ENTRIES = 1 << 20;
+
+	// only bytes that appear in a literal need a column, every other byte goes back to the root
+	ByteClasses byteClasses;
+	int numClasses;
+
+	// the children of each state in the trie, sorted by byte class. The children of state s are
+	// at childClasses[firstChild[s]] up to childClasses[firstChild[s + 1]]
+	std::vector<uint32_t> firstChild;
+	std::vector<uint8_t> childClasses;
+	std::vector<uint32_t> childStates;
+
+	// the state for the longest proper suffix of each state's string that is also in the trie
+	std::vector<uint32_t> failure;
+
+	// the next state for every state and byte class, with the failure links already followed.
+	// Empty if it would have more than MAX_DENSE_ENTRIES entries
+	std::vector<uint32_t> table;
+
+	// the length of the longest literal that ends at each state, counting literals that are
+	// suffixes of its string. Zero if none ends there
+	std::vector<uint32_t> longest;
+
+	// the ids of the patterns whose literals are exactly each state's string. The patterns of
+	// state s are patterns[firstPattern[s]] up to patterns[firstPattern[s + 1]]
+	std::vector<uint32_t> firstPattern;
+	std::vector<int> patterns;
+
+	// the next state down the failure links whose string is a literal, or NONE
+	std::vector<uint32_t> outputLink;
+
+	size_t maxLength;
+	int numPatterns;
+
+	// finds the bytes that can start a literal, so text that can not is skipped at the root
+	ByteScanner startScanner;
+	bool canSkipStart = false;
+
+	/// <summary>
+	/// Returns the state for the next input by following the failure links, see Next
+	/// </summary>
+	/// <param name="state"></param>
+	/// <param name="byteClass"></param>
+	/// <returns></returns>
+	uint32_t NextSparse(uint32_t state, uint8_t byteClass) const;
+
+	/// <summary>
+	/// Returns the state for the next input
+	/// </summary>
+	/// <param name="state"></param>
+	/// <param name="input"></param>
+	/// <returns></returns>
+	uint32_t Next(uint32_t state, char input) const
+	{
+		uint8_t byteClass = byteClasses.Get(input);
+		return !table.empty() ? table[(size_t)state * numClasses + byteClass] : NextSparse(state, byteClass);
+	}
+
+	/// <summary>
+	/// Returns the offset of the first byte at or after from that could start a literal
+	/// </summary>
+	/// <param name="text"></param>
+	/// <param name="from"></param>
+	/// <returns>The offset, or the size of text if there is none</returns>
+	size_t SkipStart(std::string_view text, size_t from) const;
+
+public:
+
+	/// <summary>
+	/// Builds the automaton for a set of patterns
+	/// </summary>
+	/// <param name="literals">The literals each pattern matches, indexed by the id of the pattern.
+	/// The literals must not be empty, and must not contain a newline.</param>
+	AhoCorasick(const std::vector<std::vector<std::string>>& literals);
+
+	/// <summary>
+	/// Matches a line of text, see Regex::Match
+	/// </summary>
+	/// <param name="text">The line to match, without a line terminator</param>
+	/// <param name="outMatches">Output parameter that is cleared, then filled with the non-overlapping,
+	/// leftmost-longest matches in the order they appear</param>
+	/// <returns>The number of matches found</returns>
+	size_t Match(std::string_view text, std::vector<Regex::Span>& outMatches) const;
+
+	/// <summary>
+	/// Finds the next line in a block of text that contains a match, see Regex::FindLine
+	/// </summary>
+	/// <param name="text">A block of lines, separated by newlines</param>
+	/// <param name="from">The offset into text to search from. Must be the start of a line.</param>
+	/// <param name="outLine">Output parameter that will contain the location of the line, without
+	/// its newline</param>
+	/// <returns>False if no more lines match</returns>
+	bool FindLine(std::string_view text, size_t from, Regex::Span& outLine) const;
+
+	/// <summary>
+	/// Finds which patterns match somewhere in a line, see Regex::MatchingPatterns
+	/// </summary>
+	/// <param name="text">The line to match, without a line terminator</param>
+	/// <param name="outPatterns">Output parameter that is cleared, then filled with the ids of the
+	/// patterns that match, sorted</param>
+	/// <returns>The number of patterns that match</returns>
+	size_t MatchingPatterns(std::string_view text, std::vector<int>& outPatterns) const;
+
+	/// <summary>
+	/// Returns the number of states in the trie
+	/// </summary>
+	/// <returns></returns>
+	int NumStates() const { return (int)failure.size(); }
+
+	/// <summary>
+	/// Returns true if the automaton was small enough to build a dense transition table for
+	/// </summary>
+	/// <returns></returns>
+	bool IsDense() const { return !table.empty(); }
+};
@@ -0,0 +1,23 @@
+#include "Ast.h"
+
+Ast::Ast()
+	: root(-1)
+{ }
+
+int Ast::AddLeaf(Kind kind, char input)
+{
+	nodes.push_back({ kind, input, (int)children.size(), 0 });
+	return (int)nodes.size() - 1;
+}
+
+int Ast::AddNode(Kind kind, const int* nodeChildren, int numChildren)
+{
+	nodes.push_back({ kind, '\0', (int)children.size(), numChildren });
+	children.insert(children.end(), nodeChildren, nodeChildren + numChildren);
+	return (int)nodes.size() - 1;
+}
+
+int Ast::NumNodes() const
+{
+	return (int)nodes.size();
+}
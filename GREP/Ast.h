@@ -0,0 +1,88 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// The syntax tree of a regular expression. The nodes are kept in one array and refer to their
+/// children by index, so building a tree does not allocate each node separately, and passes
+/// over the tree can walk it without following pointers.
+/// </summary>
+class Ast
+{
+public:
+
+	enum class Kind : uint8_t
+	{
+		// matches the empty string
+		Empty,
+
+		// matches the character in input. Regex::LINE_START, Regex::LINE_END and Regex::ANY
+		// stand for ^, $ and .
+		Char,
+
+		// matches each child in turn, or any one of the children
+		Concatenate,
+		Union,
+
+		// matches its one child repeated 0 or more, one or more, or 0 or one times
+		KleeneStar,
+		OneOrMore,
+		Optional
+	};
+
+	struct Node
+	{
+		Kind kind;
+		char input;
+
+		// the children are the nodes listed at these positions of the child array
+		int firstChild;
+		int numChildren;
+	};
+
+private:
+
+	std::vector<Node> nodes;
+	std::vector<int> children;
+	int root;
+
+public:
+
+	Ast();
+
+	/// <summary>
+	/// Adds a node with no children
+	/// </summary>
+	/// <param name="kind">Empty or Char</param>
+	/// <param name="input">The character matched by a Char node</param>
+	/// <returns>The index of the new node</returns>
+	int AddLeaf(Kind kind, char input = '\0');
+
+	/// <summary>
+	/// Adds a node with children that are already in the tree
+	/// </summary>
+	/// <param name="kind"></param>
+	/// <param name="nodeChildren">The indices of the children, in order</param>
+	/// <param name="numChildren"></param>
+	/// <returns>The index of the new node</returns>
+	int AddNode(Kind kind, const int* nodeChildren, int numChildren);
+
+	const Node& GetNode(int node) const { return nodes[node]; }
+
+	/// <summary>
+	/// Returns the index of a child of a node
+	/// </summary>
+	/// <param name="node"></param>
+	/// <param name="i">Which child, counting from 0</param>
+	/// <returns></returns>
+	int Child(int node, int i) const { return children[nodes[node].firstChild + i]; }
+
+	int Root() const { return root; }
+	void SetRoot(int node) { root = node; }
+
+	/// <summary>
+	/// Returns the number of nodes in the tree
+	/// </summary>
+	/// <returns></returns>
+	int NumNodes() const;
+};
@@ -0,0 +1,65 @@
+#include "BinaryReader.h"
+#include <algorithm>
+#include <cstring>
+
+BinaryReader::BinaryReader(std::string_view data)
+	: data(data), offset(0)
+{ }
+
+const char* BinaryReader::Take(size_t count)
+{
+	if (count > data.size() - offset)
+	{
+		offset = data.size();
+		return nullptr;
+	}
+
+	const char* taken = data.data() + offset;
+	offset += count;
+	offset = std::min(offset + (4 - offset % 4) % 4, data.size());
+	return taken;
+}
+
+bool BinaryReader::Word(uint32_t& outValue)
+{
+	const char* bytes = Take(sizeof(uint32_t));
+	if (bytes == nullptr)
+	{
+		return false;
+	}
+
+	std::memcpy(&outValue, bytes, sizeof(uint32_t));
+	return true;
+}
+
+bool BinaryReader::Words(size_t count, const uint32_t*& outWords)
+{
+	if (count > (data.size() - offset) / sizeof(uint32_t))
+	{
+		offset = data.size();
+		return false;
+	}
+
+	// every value starts at a multiple of 4 bytes, so the words are aligned
+	outWords = (const uint32_t*)Take(count * sizeof(uint32_t));
+	return true;
+}
+
+bool BinaryReader::Bytes(size_t count, const char*& outBytes)
+{
+	outBytes = Take(count);
+	return outBytes != nullptr;
+}
+
+bool BinaryReader::String(std::string& outText)
+{
+	uint32_t size;
+	const char* bytes;
+	if (!Word(size) || !Bytes(size, bytes))
+	{
+		return false;
+	}
+
+	outText.assign(bytes, size);
+	return true;
+}
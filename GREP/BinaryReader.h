@@ -0,0 +1,57 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/// <summary>
+/// Reads values written by BinaryWriter. Every read checks that the value lies inside the data, and
+/// fails once it does not, so data that was cut short or is not in the format is safe to read.
+/// </summary>
+class BinaryReader
+{
+private:
+	std::string_view data;
+	size_t offset;
+
+	/// <summary>
+	/// Takes the next count bytes of the data, and skips the padding after them
+	/// </summary>
+	/// <param name="count"></param>
+	/// <returns>The bytes, or null if there are not enough left</returns>
+	const char* Take(size_t count);
+
+public:
+
+	/// <summary>
+	/// Creates a reader over some data
+	/// </summary>
+	/// <param name="data">The data to read. Must start at an address that is a multiple of 4.</param>
+	BinaryReader(std::string_view data);
+
+	bool Word(uint32_t& outValue);
+
+	/// <summary>
+	/// Reads an array of words in place, without copying it
+	/// </summary>
+	/// <param name="count">The number of words in the array</param>
+	/// <param name="outWords">Output parameter that will point at the words in the data</param>
+	/// <returns>False if there are not enough words left</returns>
+	bool Words(size_t count, const uint32_t*& outWords);
+
+	/// <summary>
+	/// Reads an array of bytes in place, without copying it
+	/// </summary>
+	/// <param name="count">The number of bytes in the array</param>
+	/// <param name="outBytes">Output parameter that will point at the bytes in the data</param>
+	/// <returns>False if there are not enough bytes left</returns>
+	bool Bytes(size_t count, const char*& outBytes);
+
+	bool String(std::string& outText);
+
+	/// <summary>
+	/// Returns the offset of the next value in the data
+	/// </summary>
+	/// <returns></returns>
+	size_t Offset() const { return offset; }
+};
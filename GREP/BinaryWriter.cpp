@@ -0,0 +1,32 @@
+#include "BinaryWriter.h"
+
+BinaryWriter::BinaryWriter(std::string& out)
+	: out(out)
+{ }
+
+void BinaryWriter::Align()
+{
+	out.append((4 - out.size() % 4) % 4, '\0');
+}
+
+void BinaryWriter::Word(uint32_t value)
+{
+	out.append((const char*)&value, sizeof(value));
+}
+
+void BinaryWriter::Words(const uint32_t* words, size_t count)
+{
+	out.append((const char*)words, count * sizeof(uint32_t));
+}
+
+void BinaryWriter::Bytes(const void* bytes, size_t count)
+{
+	out.append((const char*)bytes, count);
+	Align();
+}
+
+void BinaryWriter::String(const std::string& text)
+{
+	Word((uint32_t)text.size());
+	Bytes(text.data(), text.size());
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/// <summary>
+/// Appends values to a buffer in the binary format read by BinaryReader. Values are written in the
+/// byte order of this machine, and every value starts at a multiple of 4 bytes from the start of the
+/// buffer, so arrays of words can be used in place once the buffer is read back or mapped.
+/// </summary>
+class BinaryWriter
+{
+private:
+	std::string& out;
+
+	/// <summary>
+	/// Pads the buffer with zeros up to a multiple of 4 bytes
+	/// </summary>
+	void Align();
+
+public:
+
+	/// <summary>
+	/// Creates a writer that appends to a buffer
+	/// </summary>
+	/// <param name="out">The buffer. Its size must be a multiple of 4 bytes.</param>
+	BinaryWriter(std::string& out);
+
+	void Word(uint32_t value);
+
+	/// <summary>
+	/// Writes an array of words, without its length
+	/// </summary>
+	/// <param name="words"></param>
+	/// <param name="count"></param>
+	void Words(const uint32_t* words, size_t count);
+
+	/// <summary>
+	/// Writes an array of bytes, without its length
+	/// </summary>
+	/// <param name="bytes"></param>
+	/// <param name="count"></param>
+	void Bytes(const void* bytes, size_t count);
+
+	/// <summary>
+	/// Writes a string, preceded by its length
+	/// </summary>
+	/// <param name="text"></param>
+	void String(const std::string& text);
+};
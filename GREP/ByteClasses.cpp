@@ -0,0 +1,23 @@
+#include "ByteClasses.h"
+#include "Regex.h"
+
+ByteClasses::ByteClasses()
+	: classes(), representatives(), numClasses(1)
+{ }
+
+ByteClasses::ByteClasses(const std::set<char>& inputs)
+	: classes(), representatives(), numClasses(1)
+{
+	// classes are numbered in byte order, so equal sets of inputs always give equal classes
+	for (int byte = 0; byte < 256; ++byte)
+	{
+		char input = (char)byte;
+		bool isSpecial = input == Regex::LINE_START || input == Regex::LINE_END || input == Regex::ANY;
+		if (!isSpecial && inputs.count(input) != 0)
+		{
+			classes[byte] = (uint8_t)numClasses;
+			representatives[numClasses] = input;
+			numClasses++;
+		}
+	}
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <cstdint>
+#include <set>
+
+/// <summary>
+/// Splits the 256 byte values into classes of bytes that no arrow of an automaton tells apart, so
+/// a transition table needs one column per class instead of one per byte.
+///
+/// Every byte that labels an arrow gets a class of its own. All the other bytes share class 0,
+/// and can only be matched by Regex::ANY. The special symbols used on arrows never stand for
+/// themselves, so bytes with their values are always in class 0.
+/// </summary>
+class ByteClasses
+{
+private:
+	uint8_t classes[256];
+	char representatives[256];
+	int numClasses;
+
+public:
+
+	/// <summary>
+	/// Creates a single class that holds every byte
+	/// </summary>
+	ByteClasses();
+
+	/// <summary>
+	/// Creates the classes for the labels on the arrows of an automaton
+	/// </summary>
+	/// <param name="inputs">Every input that labels an arrow. The special symbols are ignored.</param>
+	ByteClasses(const std::set<char>& inputs);
+
+	/// <summary>
+	/// Returns the class of a byte
+	/// </summary>
+	/// <param name="input"></param>
+	/// <returns></returns>
+	uint8_t Get(char input) const { return classes[(unsigned char)input]; }
+
+	/// <summary>
+	/// Returns a byte that belongs to a class other than class 0. Every byte in such a class is
+	/// the same byte.
+	/// </summary>
+	/// <param name="byteClass"></param>
+	/// <returns></returns>
+	char Representative(int byteClass) const { return representatives[byteClass]; }
+
+	/// <summary>
+	/// Returns the number of classes, including class 0
+	/// </summary>
+	/// <returns></returns>
+	int NumClasses() const { return numClasses; }
+};
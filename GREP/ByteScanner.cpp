@@ -0,0 +1,208 @@
+#include "ByteScanner.h"
+#include <stdexcept>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define GREP_X64
+#include <immintrin.h>
+#endif
+
+// gcc and clang only emit AVX2 instructions in functions that ask for them
+#if defined(GREP_X64) && !defined(_MSC_VER)
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_AVX2
+#endif
+
+#ifdef _MSC_VER
+static int CountTrailingZeros(uint32_t mask)
+{
+	unsigned long index;
+	_BitScanForward(&index, mask);
+	return (int)index;
+}
+#else
+static int CountTrailingZeros(uint32_t mask)
+{
+	return __builtin_ctz(mask);
+}
+#endif
+
+ByteScanner::ByteScanner()
+	: bytes(), numBytes(0), kernel(Kernel::Scalar)
+{ }
+
+ByteScanner::ByteScanner(const std::string& set)
+	: ByteScanner(set, BestKernel())
+{ }
+
+ByteScanner::ByteScanner(const std::string& set, Kernel kernel)
+	: bytes(), numBytes(set.size()), kernel(kernel)
+{
+	if (set.size() > MAX_BYTES)
+	{
+		throw std::invalid_argument("Too many bytes for a ByteScanner");
+	}
+
+	if (!IsSupported(kernel))
+	{
+		throw std::invalid_argument("ByteScanner kernel is not supported by this CPU");
+	}
+
+	// the vector kernels always compare against every slot, so unused slots repeat the first byte
+	for (size_t i = 0; i < MAX_BYTES; ++i)
+	{
+		bytes[i] = set.empty() ? 0 : set[i < set.size() ? i : 0];
+	}
+}
+
+size_t ByteScanner::Find(const char* data, size_t size) const
+{
+	if (numBytes == 0)
+	{
+		return size;
+	}
+
+	switch (kernel)
+	{
+	case Kernel::SSE2:
+		return FindSSE2(data, size);
+	case Kernel::AVX2:
+		return FindAVX2(data, size);
+	default:
+		return FindScalar(data, size);
+	}
+}
+
+size_t ByteScanner::FindScalar(const char* data, size_t size) const
+{
+	for (size_t i = 0; i < size; ++i)
+	{
+		char c = data[i];
+		if (c == bytes[0] || c == bytes[1] || c == bytes[2] || c == bytes[3])
+		{
+			return i;
+		}
+	}
+
+	return size;
+}
+
+#ifdef GREP_X64
+
+size_t ByteScanner::FindSSE2(const char* data, size_t size) const
+{
+	const __m128i b0 = _mm_set1_epi8(bytes[0]);
+	const __m128i b1 = _mm_set1_epi8(bytes[1]);
+	const __m128i b2 = _mm_set1_epi8(bytes[2]);
+	const __m128i b3 = _mm_set1_epi8(bytes[3]);
+
+	size_t i = 0;
+	for (; i + 16 <= size; i += 16)
+	{
+		__m128i block = _mm_loadu_si128((const __m128i*)(data + i));
+		__m128i found = _mm_or_si128(
+			_mm_or_si128(_mm_cmpeq_epi8(block, b0), _mm_cmpeq_epi8(block, b1)),
+			_mm_or_si128(_mm_cmpeq_epi8(block, b2), _mm_cmpeq_epi8(block, b3)));
+
+		uint32_t mask = (uint32_t)_mm_movemask_epi8(found);
+		if (mask != 0)
+		{
+			return i + CountTrailingZeros(mask);
+		}
+	}
+
+	// the last few bytes do not fill a vector
+	return i + FindScalar(data + i, size - i);
+}
+
+TARGET_AVX2 size_t ByteScanner::FindAVX2(const char* data, size_t size) const
+{
+	const __m256i b0 = _mm256_set1_epi8(bytes[0]);
+	const __m256i b1 = _mm256_set1_epi8(bytes[1]);
+	const __m256i b2 = _mm256_set1_epi8(bytes[2]);
+	const __m256i b3 = _mm256_set1_epi8(bytes[3]);
+
+	size_t i = 0;
+	for (; i + 32 <= size; i += 32)
+	{
+		__m256i block = _mm256_loadu_si256((const __m256i*)(data + i));
+		__m256i found = _mm256_or_si256(
+			_mm256_or_si256(_mm256_cmpeq_epi8(block, b0), _mm256_cmpeq_epi8(block, b1)),
+			_mm256_or_si256(_mm256_cmpeq_epi8(block, b2), _mm256_cmpeq_epi8(block, b3)));
+
+		uint32_t mask = (uint32_t)_mm256_movemask_epi8(found);
+		if (mask != 0)
+		{
+			return i + CountTrailingZeros(mask);
+		}
+	}
+
+	// the legacy SSE2 kernel is not used for the tail, switching between it and AVX2 code is slow
+	return i + FindScalar(data + i, size - i);
+}
+
+bool ByteScanner::IsSupported(Kernel kernel)
+{
+	if (kernel != Kernel::AVX2)
+	{
+		// every x64 CPU has SSE2
+		return true;
+	}
+
+#ifdef _MSC_VER
+	// AVX2 needs the CPU to support it, and the OS to save the YMM registers
+	int info[4];
+	__cpuid(info, 0);
+	if (info[0] < 7)
+	{
+		return false;
+	}
+
+	__cpuid(info, 1);
+	bool osxsave = (info[2] & (1 << 27)) != 0;
+	bool avx = (info[2] & (1 << 28)) != 0;
+	if (!osxsave || !avx || (_xgetbv(0) & 6) != 6)
+	{
+		return false;
+	}
+
+	__cpuidex(info, 7, 0);
+	return (info[1] & (1 << 5)) != 0;
+#else
+	return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#else
+
+// without x64 intrinsics the vector kernels are never selected
+size_t ByteScanner::FindSSE2(const char* data, size_t size) const
+{
+	return FindScalar(data, size);
+}
+
+size_t ByteScanner::FindAVX2(const char* data, size_t size) const
+{
+	return FindScalar(data, size);
+}
+
+bool ByteScanner::IsSupported(Kernel kernel)
+{
+	return kernel == Kernel::Scalar;
+}
+
+#endif
+
+ByteScanner::Kernel ByteScanner::BestKernel()
+{
+	static const Kernel best =
+		IsSupported(Kernel::AVX2) ? Kernel::AVX2 :
+		IsSupported(Kernel::SSE2) ? Kernel::SSE2 :
+		Kernel::Scalar;
+
+	return best;
+}
@@ -0,0 +1,94 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/// <summary>
+/// Finds the next occurrence of any of a small set of bytes. Used to skip past text that can not
+/// start a match, so that only candidate positions are fed to a DFA.
+/// </summary>
+class ByteScanner
+{
+public:
+
+	/// <summary>
+	/// The ways a scanner can search. The vector kernels compare 16 or 32 bytes at a time against
+	/// each byte in the set, the scalar kernel checks one byte at a time.
+	/// </summary>
+	enum class Kernel
+	{
+		Scalar,
+		SSE2,
+		AVX2
+	};
+
+	// the most bytes a scanner can search for. Larger sets skip too little text to be worth it
+	static const size_t MAX_BYTES = 4;
+
+	// a scanner only pays off when it skips a lot of text at a time. Once the bytes it stops at
+	// turn out to be common, stepping a dfa through every byte is faster
+	static const size_t MIN_SCANS = 4;
+	static const size_t MIN_AVERAGE_SKIP = 16;
+
+private:
+
+	char bytes[MAX_BYTES];
+	size_t numBytes;
+	Kernel kernel;
+
+	size_t FindScalar(const char* data, size_t size) const;
+	size_t FindSSE2(const char* data, size_t size) const;
+	size_t FindAVX2(const char* data, size_t size) const;
+
+public:
+
+	/// <summary>
+	/// Creates a scanner that finds nothing
+	/// </summary>
+	ByteScanner();
+
+	/// <summary>
+	/// Creates a scanner that finds any of the given bytes, using the fastest kernel this CPU supports
+	/// </summary>
+	/// <param name="set">The bytes to find. Must contain at most MAX_BYTES bytes, duplicates are allowed.</param>
+	ByteScanner(const std::string& set);
+
+	/// <summary>
+	/// Creates a scanner that finds any of the given bytes using a specific kernel
+	/// </summary>
+	/// <param name="set">The bytes to find. Must contain at most MAX_BYTES bytes, duplicates are allowed.</param>
+	/// <param name="kernel">The kernel to search with. Must be supported by this CPU.</param>
+	ByteScanner(const std::string& set, Kernel kernel);
+
+	/// <summary>
+	/// Returns the offset of the first byte in the data that is in the set
+	/// </summary>
+	/// <param name="data"></param>
+	/// <param name="size"></param>
+	/// <returns>The offset of the byte, or size if there is none</returns>
+	size_t Find(const char* data, size_t size) const;
+
+	/// <summary>
+	/// Returns true if a search should keep using a scanner, see MIN_AVERAGE_SKIP
+	/// </summary>
+	/// <param name="numScans">The number of times the search has used the scanner so far</param>
+	/// <param name="numSkipped">The total number of bytes those scans skipped</param>
+	/// <returns></returns>
+	static bool ShouldScan(size_t numScans, size_t numSkipped)
+	{
+		return numScans < MIN_SCANS || numSkipped >= numScans * MIN_AVERAGE_SKIP;
+	}
+
+	/// <summary>
+	/// Returns true if this CPU can run a kernel
+	/// </summary>
+	/// <param name="kernel"></param>
+	/// <returns></returns>
+	static bool IsSupported(Kernel kernel);
+
+	/// <summary>
+	/// Returns the fastest kernel this CPU can run
+	/// </summary>
+	/// <returns></returns>
+	static Kernel BestKernel();
+};
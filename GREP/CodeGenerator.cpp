@@ -0,0 +1,352 @@
+#include "CodeGenerator.h"
+#include "NFABuilder.h"
+#include "Parser.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <sstream>
+
+// the labels of each machine's blocks start with its name, which keeps the generated code readable
+static const char* LabelPrefix(int machine)
+{
+	static const char* prefixes[] = { "search", "reverse", "accept" };
+	return prefixes[machine];
+}
+
+// writes code one tab further in, since the blocks of a function are inside a namespace
+static void WriteIndented(const std::string& code, std::ostream& out)
+{
+	size_t position = 0;
+	while (position < code.size())
+	{
+		size_t end = code.find('\n', position);
+		if (end != position)
+		{
+			out << '\t';
+		}
+		out << code.substr(position, end + 1 - position);
+		position = end + 1;
+	}
+}
+
+// writes a byte as a character literal if it is printable, so the cases can be read
+static std::string ByteLiteral(int byte)
+{
+	if (byte != 0 && byte < 128 && (std::isalnum(byte) || std::strchr(" !#$%&()*+,-./:;<=>?@[]^_`{|}~", byte)))
+	{
+		return std::string("'") + (char)byte + "'";
+	}
+
+	char hex[8];
+	std::snprintf(hex, sizeof(hex), "0x%02x", byte);
+	return hex;
+}
+
+bool CodeGenerator::IsIdentifier(const std::string& name)
+{
+	if (name.empty() || std::isdigit((unsigned char)name[0]))
+	{
+		return false;
+	}
+
+	return std::all_of(name.begin(), name.end(), [](char c) { return std::isalnum((unsigned char)c) || c == '_'; });
+}
+
+void CodeGenerator::WriteStates(const DFA& dfa, Machine machine, const std::vector<uint32_t>& entries, std::ostream& out)
+{
+	const char* prefix = LabelPrefix((int)machine);
+
+	// what a machine does once the dfa dies, there is no block for the dead state
+	const char* onDead = machine == Machine::Search ? "return found;" :
+		machine == Machine::Reverse ? "return matchStart;" : "return false;";
+
+	// only the states the text can lead to get a block, the line markers are only fed at the ends
+	std::vector<uint32_t> states;
+	std::vector<bool> reached(dfa.NumStates() + 1, false);
+	for (uint32_t entry : entries)
+	{
+		if (!dfa.IsDead(entry) && !reached[entry])
+		{
+			reached[entry] = true;
+			states.push_back(entry);
+		}
+	}
+	for (size_t i = 0; i < states.size(); ++i)
+	{
+		for (int byte = 0; byte < 256; ++byte)
+		{
+			uint32_t next = dfa.Next(states[i], (char)byte);
+			if (!dfa.IsDead(next) && !reached[next])
+			{
+				reached[next] = true;
+				states.push_back(next);
+			}
+		}
+	}
+	std::sort(states.begin(), states.end());
+
+	auto jump = [&](uint32_t next)
+	{
+		return dfa.IsDead(next) ? std::string(onDead) : "goto " + std::string(prefix) + std::to_string(next) + ";";
+	};
+
+	for (uint32_t state : states)
+	{
+		out << prefix << state << ":\n";
+
+		// a final state records where the match ends, or starts when running backwards
+		if (dfa.IsAccepting(state))
+		{
+			out << (machine == Machine::Search ? "\tfound = true;\n\toutEnd = i;\n" :
+				machine == Machine::Reverse ? "\tmatchStart = i;\n" : "\treturn true;\n");
+		}
+
+		// the line markers are fed once the text runs out
+		if (machine == Machine::Search)
+		{
+			uint32_t lineEnd = dfa.NextLineEnd(state);
+			out << "\tif (i == size)\n\t{\n";
+			if (!dfa.IsDead(lineEnd) && dfa.IsAccepting(lineEnd))
+			{
+				out << "\t\tfound = true;\n\t\toutEnd = size;\n\t\toutEndsAfterLineEnd = true;\n";
+			}
+			out << "\t\treturn found;\n\t}\n";
+		}
+		else if (machine == Machine::Reverse)
+		{
+			uint32_t lineStart = dfa.NextLineStart(state);
+			out << "\tif (i == start)\n\t{\n";
+			if (!dfa.IsDead(lineStart) && dfa.IsAccepting(lineStart))
+			{
+				out << "\t\tif (start == 0)\n\t\t{\n\t\t\tmatchStart = 0;\n\t\t}\n";
+			}
+			out << "\t\treturn matchStart;\n\t}\n";
+		}
+		else
+		{
+			uint32_t lineEnd = dfa.NextLineEnd(state);
+			bool accepts = !dfa.IsDead(lineEnd) && dfa.IsAccepting(lineEnd);
+			out << "\tif (i == size)\n\t{\n\t\treturn " << (accepts ? "true" : "false") << ";\n\t}\n";
+		}
+
+		// the bytes are grouped by the state they lead to, and the biggest group is the default
+		std::map<uint32_t, std::vector<int>> groups;
+		for (int byte = 0; byte < 256; ++byte)
+		{
+			groups[dfa.Next(state, (char)byte)].push_back(byte);
+		}
+		auto biggest = std::max_element(groups.begin(), groups.end(),
+			[](auto& a, auto& b) { return a.second.size() < b.second.size(); });
+
+		out << "\tswitch (data[" << (machine == Machine::Reverse ? "--i" : "i++") << "])\n\t{\n";
+		for (auto& group : groups)
+		{
+			if (group.first == biggest->first)
+			{
+				continue;
+			}
+
+			out << "\t";
+			for (int byte : group.second)
+			{
+				out << "case " << ByteLiteral(byte) << ": ";
+			}
+			out << jump(group.first) << "\n";
+		}
+		out << "\tdefault: " << jump(biggest->first) << "\n\t}\n\n";
+	}
+}
+
+bool CodeGenerator::Generate(const std::vector<std::string>& patterns, const std::string& name, std::ostream& out)
+{
+	// the dfas are built the way Regex::Compile builds them
+	NFABuilder builder;
+	std::vector<NFABuilder::Fragment> fragments;
+	for (const std::string& pattern : patterns)
+	{
+		Ast ast = Parser::Parse(pattern);
+		fragments.push_back(builder.Add(ast, ast.Root()));
+	}
+
+	NFABuilder::Fragment all = fragments.size() == 1 ? fragments[0] : builder.Union(fragments);
+	NFA nfa = builder.Build(all);
+
+	DFA search = DFA::GenerateEmpty();
+	DFA reverse = DFA::GenerateEmpty();
+	if (!nfa.TryConvertToSearchDFA(MAX_DFA_STATES, search) || !nfa.Reverse().TryConvertToDFA(MAX_DFA_STATES, reverse))
+	{
+		return false;
+	}
+
+	search.Minimize();
+	reverse.Minimize();
+
+	// the code is written to a buffer first, so nothing is written if it fails
+	std::ostringstream code;
+	code << "// Generated by grep --generate " << name << ". Do not edit, generate it again instead.\n";
+	for (const std::string& pattern : patterns)
+	{
+		if (pattern.find('\n') == std::string::npos)
+		{
+			code << "// pattern: " << pattern << "\n";
+		}
+	}
+
+	code << R"(#pragma once
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+namespace )" << name << R"(
+{
+	/// <summary>
+	/// The location of a match in the text that was searched
+	/// </summary>
+	struct Span
+	{
+		size_t offset;
+		size_t length;
+	};
+
+	/// <summary>
+	/// Finds the end of the leftmost-longest match that starts at or after start
+	/// </summary>
+	/// <returns>False if there is none</returns>
+	inline bool FindEnd(std::string_view text, size_t start, size_t& outEnd, bool& outEndsAfterLineEnd)
+	{
+		const unsigned char* data = (const unsigned char*)text.data();
+		size_t size = text.size();
+		size_t i = start;
+		bool found = false;
+		outEnd = 0;
+		outEndsAfterLineEnd = false;
+
+)";
+
+	uint32_t searchStart = search.StartState();
+	uint32_t searchLineStart = search.NextLineStart(searchStart);
+	std::ostringstream states;
+	states << "\tif (start == 0)\n\t{\n\t\t" <<
+		(search.IsDead(searchLineStart) ? std::string("return false;") : "goto search" + std::to_string(searchLineStart) + ";") <<
+		"\n\t}\n\tgoto search" << searchStart << ";\n\n";
+	WriteStates(search, Machine::Search, { searchStart, searchLineStart }, states);
+	WriteIndented(states.str(), code);
+
+	code << R"(	}
+
+	/// <summary>
+	/// Finds the start of the leftmost-longest match that ends at end
+	/// </summary>
+	/// <returns></returns>
+	inline size_t FindStart(std::string_view text, size_t start, size_t end, bool endsAfterLineEnd)
+	{
+		const unsigned char* data = (const unsigned char*)text.data();
+		size_t i = end;
+		size_t matchStart = end;
+
+)";
+
+	uint32_t reverseStart = reverse.StartState();
+	uint32_t reverseLineEnd = reverse.NextLineEnd(reverseStart);
+	states.str("");
+	states << "\tif (endsAfterLineEnd)\n\t{\n\t\t" <<
+		(reverse.IsDead(reverseLineEnd) ? std::string("return matchStart;") : "goto reverse" + std::to_string(reverseLineEnd) + ";") <<
+		"\n\t}\n\tgoto reverse" << reverseStart << ";\n\n";
+	WriteStates(reverse, Machine::Reverse, { reverseStart, reverseLineEnd }, states);
+	WriteIndented(states.str(), code);
+
+	code << R"(	}
+
+	/// <summary>
+	/// Matches a line of text, see Regex::Match
+	/// </summary>
+	/// <param name="text">The line to match, without a line terminator</param>
+	/// <param name="outMatches">Output parameter that is cleared, then filled with the non-overlapping,
+	/// leftmost-longest matches in the order they appear. Empty matches are not reported.</param>
+	/// <returns>The number of matches found</returns>
+	inline size_t Match(std::string_view text, std::vector<Span>& outMatches)
+	{
+		outMatches.clear();
+
+		size_t start = 0;
+		while (start <= text.size())
+		{
+			size_t end;
+			bool endsAfterLineEnd;
+			if (!FindEnd(text, start, end, endsAfterLineEnd))
+			{
+				break;
+			}
+
+			size_t matchStart = FindStart(text, start, end, endsAfterLineEnd);
+			if (end > matchStart)
+			{
+				outMatches.push_back({ matchStart, end - matchStart });
+			}
+
+			// continue after this match, or one past it if it was empty
+			start = end > matchStart ? end : end + 1;
+		}
+
+		return outMatches.size();
+	}
+
+	/// <summary>
+	/// Returns true if Match would find a match in a line, so an empty match does not count
+	/// </summary>
+	/// <param name="text">The line to match, without a line terminator</param>
+	/// <returns></returns>
+	inline bool IsMatch(std::string_view text)
+	{
+)";
+
+	// when the pattern matches the empty string a final state may only end an empty match, so the
+	// matches are found one after another until one is not empty
+	bool matchesEmpty = search.IsAccepting(searchStart) || search.IsAccepting(searchLineStart) ||
+		search.IsAccepting(search.NextLineEnd(searchStart)) || search.IsAccepting(search.NextLineEnd(searchLineStart));
+	if (matchesEmpty)
+	{
+		code << R"(		size_t start = 0;
+		while (start <= text.size())
+		{
+			size_t end;
+			bool endsAfterLineEnd;
+			if (!FindEnd(text, start, end, endsAfterLineEnd))
+			{
+				return false;
+			}
+
+			if (end > FindStart(text, start, end, endsAfterLineEnd))
+			{
+				return true;
+			}
+
+			start = end + 1;
+		}
+
+		return false;
+)";
+	}
+	else
+	{
+		// any final state ends a match that is not empty
+		code << R"(		const unsigned char* data = (const unsigned char*)text.data();
+		size_t size = text.size();
+		size_t i = 0;
+
+)";
+
+		states.str("");
+		states << "\t" << (search.IsDead(searchLineStart) ? std::string("return false;") : "goto accept" + std::to_string(searchLineStart) + ";") << "\n\n";
+		WriteStates(search, Machine::Accept, { searchLineStart }, states);
+		WriteIndented(states.str(), code);
+	}
+
+	code << "\t}\n}\n";
+
+	out << code.str();
+	return true;
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include "DFA.h"
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// Writes C++ code that runs the dfas of a regular expression without a transition table. Each
+/// state becomes a block of code that switches on the next byte and jumps to the block of the next
+/// state, so the compiler sees every transition and the state is kept in the instruction pointer.
+///
+/// The code is written as a header with no dependencies, which declares a namespace holding Match
+/// and IsMatch functions that behave like Regex::Match and Regex::IsMatch.
+/// </summary>
+class CodeGenerator
+{
+private:
+
+	// the most states each dfa may have. Every state is a block of code, so a bigger dfa gives
+	// a file that takes too long to compile
+	static const size_t MAX_DFA_STATES = 2000;
+
+	/// <summary>
+	/// The ways the code for a dfa is run
+	/// </summary>
+	enum class Machine
+	{
+		// finds the end of the leftmost-longest match, like the search loop of Regex::Match
+		Search,
+
+		// runs backwards from the end of a match to find where it started
+		Reverse,
+
+		// stops at the first final state
+		Accept
+	};
+
+	/// <summary>
+	/// Writes the blocks of code for the states of a dfa that the machine can reach
+	/// </summary>
+	/// <param name="dfa"></param>
+	/// <param name="machine"></param>
+	/// <param name="entries">The states the machine can start in</param>
+	/// <param name="out"></param>
+	static void WriteStates(const DFA& dfa, Machine machine, const std::vector<uint32_t>& entries, std::ostream& out);
+
+public:
+
+	/// <summary>
+	/// Returns true if a name can be used as a C++ namespace
+	/// </summary>
+	/// <param name="name"></param>
+	/// <returns></returns>
+	static bool IsIdentifier(const std::string& name);
+
+	/// <summary>
+	/// Writes the code for one or more patterns, which are matched as alternatives like Regex::Parse does
+	/// </summary>
+	/// <param name="patterns">At least one regular expression</param>
+	/// <param name="name">The namespace the code is written in, see IsIdentifier</param>
+	/// <param name="out">The stream to write the code to</param>
+	/// <returns>False if the dfas have too many states to write out, in which case nothing is written</returns>
+	/// <exception cref="ParseError">One of the regular expressions is not valid</exception>
+	static bool Generate(const std::vector<std::string>& patterns, const std::string& name, std::ostream& out);
+};
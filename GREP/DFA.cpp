@@ -1,51 +1,331 @@
 #include "DFA.h"
+#include "BinaryReader.h"
+#include "BinaryWriter.h"
 #include "Regex.h"
 #include <stdexcept>
+#include <algorithm>
+
+const std::vector<int> DFA::NO_PATTERNS;
 
 DFA::DFA(const std::set<int>& q, const std::map<int, std::map<char, int>>& transitions,
-	int q0, const std::set<int>& f)
-	: q(q), transitions(transitions), q0(q0), f(f)
+	int q0, const std::set<int>& f, const std::map<int, std::vector<int>>& patterns)
 {
-	// ensure all states are present in the transition map
+	// give every state a dense row index in the transition table. States only referenced
+	// by the transition map are included, so every transition has a row to point at
+	std::map<int, uint32_t> rows;
 	for (int state : q)
 	{
-		if (transitions.find(state) == transitions.end())
+		rows.emplace(state, 0);
+	}
+	for (auto& stateIt : transitions)
+	{
+		rows.emplace(stateIt.first, 0);
+		for (auto& transitionIt : stateIt.second)
+		{
+			rows.emplace(transitionIt.second, 0);
+		}
+	}
+	rows.emplace(q0, 0);
+
+	uint32_t count = 0;
+	for (auto& row : rows)
+	{
+		row.second = count++;
+	}
+
+	numStates = count;
+	dead = count;
+	start = rows[q0];
+
+	// bytes with no transition of their own share a column
+	std::set<char> inputs;
+	for (auto& stateIt : transitions)
+	{
+		for (auto& transitionIt : stateIt.second)
+		{
+			inputs.insert(transitionIt.first);
+		}
+	}
+	byteClasses = ByteClasses(inputs);
+	numColumns = byteClasses.NumClasses() + 2;
+	lineStartColumn = numColumns - 2;
+	lineEndColumn = numColumns - 1;
+
+	// every entry starts out pointing at the dead state, including the dead state's own row
+	std::vector<uint32_t> newTable((size_t)(numStates + 1) * numColumns, dead);
+	accepting.assign(numStates + 1, 0);
+
+	for (int state : f)
+	{
+		if (rows.find(state) != rows.end())
 		{
-			this->transitions.emplace(std::make_pair(state, std::map<char, int>()));
+			accepting[rows[state]] = 1;
 		}
 	}
+
+	if (!patterns.empty())
+	{
+		this->patterns.assign(numStates + 1, std::vector<int>());
+		for (auto& stateIt : patterns)
+		{
+			if (rows.find(stateIt.first) != rows.end())
+			{
+				this->patterns[rows[stateIt.first]] = stateIt.second;
+			}
+		}
+	}
+
+	for (auto& stateIt : transitions)
+	{
+		uint32_t* row = &newTable[(size_t)rows[stateIt.first] * numColumns];
+		const std::map<char, int>& stateTransitions = stateIt.second;
+
+		// expand the ANY transition into every byte class, it never matches the line markers
+		auto anyIt = stateTransitions.find(Regex::ANY);
+		if (anyIt != stateTransitions.end())
+		{
+			for (int input = 0; input < lineStartColumn; ++input)
+			{
+				row[input] = rows[anyIt->second];
+			}
+		}
+
+		// explicit transitions take priority over ANY
+		for (auto& transitionIt : stateTransitions)
+		{
+			char input = transitionIt.first;
+			if (input == Regex::LINE_START)
+			{
+				row[lineStartColumn] = rows[transitionIt.second];
+			}
+			else if (input == Regex::LINE_END)
+			{
+				row[lineEndColumn] = rows[transitionIt.second];
+			}
+			else if (input != Regex::ANY)
+			{
+				row[byteClasses.Get(input)] = rows[transitionIt.second];
+			}
+		}
+	}
+
+	SetTable(std::move(newTable));
+	currentState = start;
 }
 
-int DFA::NumStates()
+void DFA::SetTable(std::vector<uint32_t> newTable)
 {
-	return q.size();
+	auto storage = std::make_shared<const std::vector<uint32_t>>(std::move(newTable));
+	table = storage->data();
+	tableStorage = storage;
 }
 
-void DFA::BeginSimulation()
+int DFA::NumStates() const
 {
-	currentState = q0;
+	return numStates;
 }
 
-void DFA::OnNext(char input)
+void DFA::Minimize()
 {
-	if (transitions[currentState].find(input) == transitions[currentState].end())
+	// every row of the table is a state here, including the dead state
+	size_t n = (size_t)numStates + 1;
+	size_t columns = (size_t)numColumns;
+
+	// the states that lead to each state on each input. The states leading to state t on input c
+	// are predecessors[first[c * (n + 1) + t]] up to predecessors[first[c * (n + 1) + t + 1]]
+	std::vector<uint32_t> first((size_t)numColumns * (n + 1), 0);
+	std::vector<uint32_t> predecessors((size_t)numColumns * n);
+	for (size_t state = 0; state < n; ++state)
 	{
-		// check if this state has an ANY transition, if so, take it
-		if (transitions[currentState].find(Regex::ANY) != transitions[currentState].end()
-			&& input != Regex::LINE_START && input != Regex::LINE_END)
+		for (size_t input = 0; input < columns; ++input)
 		{
-			input = Regex::ANY;
+			first[input * (n + 1) + table[state * numColumns + input] + 1]++;
 		}
-		else
+	}
+	for (size_t input = 0; input < columns; ++input)
+	{
+		for (size_t state = 0; state < n; ++state)
+		{
+			first[input * (n + 1) + state + 1] += first[input * (n + 1) + state];
+		}
+	}
+
+	std::vector<uint32_t> filled(first.begin(), first.end());
+	for (size_t state = 0; state < n; ++state)
+	{
+		for (size_t input = 0; input < columns; ++input)
+		{
+			uint32_t target = table[state * numColumns + input];
+			predecessors[input * n + filled[input * (n + 1) + target]++] = (uint32_t)state;
+		}
+	}
+
+	// start with the final states and the other states in separate blocks. Final states that
+	// match different patterns are never equivalent, so they start out apart too
+	std::vector<std::vector<uint32_t>> blocks;
+	std::vector<uint32_t> blockOf(n);
+	std::map<std::pair<uint8_t, std::vector<int>>, uint32_t> initialBlocks;
+	for (size_t state = 0; state < n; ++state)
+	{
+		auto inserted = initialBlocks.emplace(
+			std::make_pair(accepting[state], patterns.empty() ? NO_PATTERNS : patterns[state]), (uint32_t)blocks.size());
+		if (inserted.second)
+		{
+			blocks.emplace_back();
+		}
+		blockOf[state] = inserted.first->second;
+		blocks[blockOf[state]].push_back((uint32_t)state);
+	}
+
+	// blocks that still have to be used to split the others
+	std::vector<uint32_t> worklist;
+	std::vector<bool> inWorklist(blocks.size(), true);
+	for (uint32_t block = 0; block < blocks.size(); ++block)
+	{
+		worklist.push_back(block);
+	}
+
+	std::vector<bool> marked(n, false);
+	std::vector<uint32_t> markedStates;
+	std::vector<size_t> numMarked;
+	std::vector<uint32_t> touchedBlocks;
+
+	while (!worklist.empty())
+	{
+		uint32_t splitter = worklist.back();
+		worklist.pop_back();
+		inWorklist[splitter] = false;
+
+		// the splitter itself can be split below, so work from a copy
+		std::vector<uint32_t> splitterStates = blocks[splitter];
+
+		for (size_t input = 0; input < columns; ++input)
+		{
+			// mark every state that leads into the splitter on this input
+			numMarked.resize(blocks.size(), 0);
+			for (uint32_t target : splitterStates)
+			{
+				uint32_t begin = first[input * (n + 1) + target];
+				uint32_t end = first[input * (n + 1) + target + 1];
+				for (uint32_t i = begin; i < end; ++i)
+				{
+					uint32_t state = predecessors[input * n + i];
+					if (!marked[state])
+					{
+						marked[state] = true;
+						markedStates.push_back(state);
+						if (numMarked[blockOf[state]]++ == 0)
+						{
+							touchedBlocks.push_back(blockOf[state]);
+						}
+					}
+				}
+			}
+
+			// split each block that has both marked and unmarked states
+			for (uint32_t block : touchedBlocks)
+			{
+				if (numMarked[block] < blocks[block].size())
+				{
+					uint32_t newBlock = (uint32_t)blocks.size();
+					std::vector<uint32_t> kept;
+					std::vector<uint32_t> moved;
+					for (uint32_t state : blocks[block])
+					{
+						(marked[state] ? moved : kept).push_back(state);
+					}
+					for (uint32_t state : moved)
+					{
+						blockOf[state] = newBlock;
+					}
+					blocks[block] = std::move(kept);
+					blocks.push_back(std::move(moved));
+					inWorklist.push_back(false);
+					numMarked.push_back(0);
+
+					// both halves are needed if the block was waiting, otherwise the smaller half is enough
+					if (inWorklist[block])
+					{
+						worklist.push_back(newBlock);
+						inWorklist[newBlock] = true;
+					}
+					else
+					{
+						uint32_t smaller = blocks[block].size() < blocks[newBlock].size() ? block : newBlock;
+						worklist.push_back(smaller);
+						inWorklist[smaller] = true;
+					}
+				}
+				numMarked[block] = 0;
+			}
+			touchedBlocks.clear();
+
+			for (uint32_t state : markedStates)
+			{
+				marked[state] = false;
+			}
+			markedStates.clear();
+		}
+	}
+
+	// each block becomes one state. The dead state's block keeps the last row
+	uint32_t deadBlock = blockOf[dead];
+	std::vector<uint32_t> rows(blocks.size());
+	uint32_t count = 0;
+	for (uint32_t block = 0; block < blocks.size(); ++block)
+	{
+		if (block != deadBlock)
 		{
-			inErrorState = true;
+			rows[block] = count++;
 		}
 	}
+	rows[deadBlock] = count;
 
-	if (!inErrorState)
+	std::vector<uint32_t> minimizedTable((size_t)(count + 1) * numColumns);
+	std::vector<uint8_t> minimizedAccepting(count + 1);
+	std::vector<std::vector<int>> minimizedPatterns(patterns.empty() ? 0 : count + 1);
+	for (uint32_t block = 0; block < blocks.size(); ++block)
 	{
-		currentState = transitions[currentState][input];
+		// every state in a block has the same transitions, up to the block they lead to
+		size_t state = blocks[block][0];
+		for (size_t input = 0; input < columns; ++input)
+		{
+			minimizedTable[(size_t)rows[block] * numColumns + input] = rows[blockOf[table[state * numColumns + input]]];
+		}
+		minimizedAccepting[rows[block]] = accepting[state];
+		if (!patterns.empty())
+		{
+			minimizedPatterns[rows[block]] = patterns[state];
+		}
 	}
+
+	SetTable(std::move(minimizedTable));
+	accepting = std::move(minimizedAccepting);
+	patterns = std::move(minimizedPatterns);
+	numStates = count;
+	dead = count;
+	start = rows[blockOf[start]];
+	currentState = start;
+}
+
+void DFA::BeginSimulation()
+{
+	currentState = start;
+}
+
+void DFA::OnNext(char input)
+{
+	currentState = Next(currentState, input);
+}
+
+void DFA::OnLineStart()
+{
+	currentState = NextLineStart(currentState);
+}
+
+void DFA::OnLineEnd()
+{
+	currentState = NextLineEnd(currentState);
 }
 
 void DFA::OnNextAll(const std::string& input)
@@ -58,23 +338,149 @@ void DFA::OnNextAll(const std::string& input)
 
 bool DFA::HasAccepted()
 {
-	return f.find(currentState) != f.end();
+	return IsAccepting(currentState);
 }
 
 bool DFA::HasFailed()
 {
-	return inErrorState;
+	return IsDead(currentState);
 }
 
 bool DFA::EndSimulation()
 {
-	bool result = !inErrorState && f.find(currentState) != f.end();
-	currentState = -1;
-	inErrorState = false;
+	bool result = IsAccepting(currentState);
+	currentState = start;
 
 	return result;
 }
 
+void DFA::Serialize(std::string& out) const
+{
+	BinaryWriter writer(out);
+	writer.Word(SERIAL_MAGIC);
+	writer.Word(SERIAL_VERSION);
+	writer.Word((uint32_t)numStates);
+	writer.Word((uint32_t)numColumns);
+	writer.Word(start);
+	writer.Word(dead);
+
+	// the classes are stored as the class of every byte, the representatives follow from those
+	uint8_t classes[256];
+	for (int byte = 0; byte < 256; ++byte)
+	{
+		classes[byte] = byteClasses.Get((char)byte);
+	}
+	writer.Bytes(classes, sizeof(classes));
+
+	writer.Words(table, (size_t)(numStates + 1) * numColumns);
+	writer.Bytes(accepting.data(), accepting.size());
+
+	// the patterns of each state are a count followed by the ids
+	writer.Word(patterns.empty() ? 0 : 1);
+	for (const std::vector<int>& statePatterns : patterns)
+	{
+		writer.Word((uint32_t)statePatterns.size());
+		for (int pattern : statePatterns)
+		{
+			writer.Word((uint32_t)pattern);
+		}
+	}
+}
+
+bool DFA::Load(std::string_view data, size_t& offset, std::shared_ptr<const void> owner, DFA& outDfa)
+{
+	BinaryReader reader(data.substr(std::min(offset, data.size())));
+
+	uint32_t magic, version, numStates, numColumns, start, dead;
+	if (!reader.Word(magic) || magic != SERIAL_MAGIC || !reader.Word(version) || version != SERIAL_VERSION ||
+		!reader.Word(numStates) || !reader.Word(numColumns) || !reader.Word(start) || !reader.Word(dead))
+	{
+		return false;
+	}
+
+	const char* classes;
+	if (!reader.Bytes(256, classes))
+	{
+		return false;
+	}
+
+	// the classes are numbered in byte order, so the bytes with a class of their own give them back
+	std::set<char> inputs;
+	for (int byte = 0; byte < 256; ++byte)
+	{
+		if (classes[byte] != 0)
+		{
+			inputs.insert((char)byte);
+		}
+	}
+	ByteClasses byteClasses(inputs);
+	for (int byte = 0; byte < 256; ++byte)
+	{
+		if (byteClasses.Get((char)byte) != (uint8_t)classes[byte])
+		{
+			return false;
+		}
+	}
+
+	if (numColumns != (uint32_t)byteClasses.NumClasses() + 2 || dead != numStates || start > numStates ||
+		numStates >= UINT32_MAX / numColumns - 1)
+	{
+		return false;
+	}
+
+	// every entry is checked once here, so a damaged table can not lead a simulation out of bounds
+	size_t tableSize = ((size_t)numStates + 1) * numColumns;
+	const uint32_t* table;
+	if (!reader.Words(tableSize, table) ||
+		std::any_of(table, table + tableSize, [&](uint32_t next) { return next > numStates; }))
+	{
+		return false;
+	}
+
+	const char* accepting;
+	uint32_t hasPatterns;
+	if (!reader.Bytes((size_t)numStates + 1, accepting) || !reader.Word(hasPatterns))
+	{
+		return false;
+	}
+
+	std::vector<std::vector<int>> patterns(hasPatterns != 0 ? numStates + 1 : 0);
+	for (std::vector<int>& statePatterns : patterns)
+	{
+		uint32_t count, pattern;
+		if (!reader.Word(count))
+		{
+			return false;
+		}
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			if (!reader.Word(pattern) || pattern > INT32_MAX)
+			{
+				return false;
+			}
+			statePatterns.push_back((int)pattern);
+		}
+	}
+
+	DFA dfa;
+	dfa.byteClasses = byteClasses;
+	dfa.numColumns = (int)numColumns;
+	dfa.lineStartColumn = dfa.numColumns - 2;
+	dfa.lineEndColumn = dfa.numColumns - 1;
+	dfa.numStates = (int)numStates;
+	dfa.table = table;
+	dfa.tableStorage = std::move(owner);
+	dfa.accepting.assign(accepting, accepting + numStates + 1);
+	dfa.patterns = std::move(patterns);
+	dfa.start = start;
+	dfa.dead = dead;
+	dfa.currentState = start;
+
+	outDfa = std::move(dfa);
+	offset += reader.Offset();
+	return true;
+}
+
 DFA DFA::GenerateEmpty()
 {
 	std::set<int> q = { 0 };
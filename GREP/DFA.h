@@ -1,21 +1,66 @@
 #pragma once
+#include "ByteClasses.h"
+
 #include <set>
 #include <map>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
+#include <tuple>
+#include <cstdint>
 
 class DFA
 {
 private:
-	std::set<int> q;
-	std::map<int, std::map<char, int>> transitions;
-	int q0;
-	std::set<int> f;
+	// bytes that no transition tells apart share a column of the transition table
+	ByteClasses byteClasses;
+
+	// number of columns in each row of the transition table. There is one per byte class,
+	// followed by the line start and line end columns. The line markers are never part of the
+	// input text, they are fed to the DFA at the boundaries of a line.
+	int numColumns;
+	int lineStartColumn;
+	int lineEndColumn;
+
+	int numStates;
+
+	// flat transition table, row major. Row i holds the next state for every class of input
+	// received in state i. There is one extra row at the end for the dead state.
+	const uint32_t* table;
+
+	// owns the memory the table lies in. The table is never modified once it is built, so copies
+	// of the DFA share it. For a DFA that was loaded, this is the data it was loaded from.
+	std::shared_ptr<const void> tableStorage;
+
+	// one flag per row of the transition table, nonzero if that state is a final state
+	std::vector<uint8_t> accepting;
+
+	// for a DFA built from several patterns, the ids of the patterns each row matches. Empty
+	// if the DFA was built from one pattern.
+	std::vector<std::vector<int>> patterns;
+
+	uint32_t start;
+	uint32_t dead;
 
-	int currentState = -1;
+	uint32_t currentState;
 
-	// switched to true when dfa enters an unrecoverable error state
-	bool inErrorState = false;
+	static const std::vector<int> NO_PATTERNS;
+
+	// identifies serialized DFAs, and the version of their format
+	static const uint32_t SERIAL_MAGIC = 0x41464447;
+	static const uint32_t SERIAL_VERSION = 1;
+
+	/// <summary>
+	/// Replaces the transition table
+	/// </summary>
+	/// <param name="newTable">The new table, with a row for every state and the dead state</param>
+	void SetTable(std::vector<uint32_t> newTable);
+
+	/// <summary>
+	/// Used by Load to fill in a DFA
+	/// </summary>
+	DFA() = default;
 
 public:
 
@@ -26,14 +71,80 @@ public:
 	/// <param name="transitions">The transition map. Double map that should map state+input to the next state.</param>
 	/// <param name="q0">The start state</param>
 	/// <param name="f">The set of final states</param>
+	/// <param name="patterns">For a DFA built from several patterns, maps each final state to the
+	/// ids of the patterns it matches. See NFA::ConvertToPatternDFA.</param>
 	DFA(const std::set<int>& q, const std::map<int, std::map<char, int>>& transitions,
-		int q0, const std::set<int>& f);
+		int q0, const std::set<int>& f, const std::map<int, std::vector<int>>& patterns = {});
 
 	/// <summary>
 	/// Returns the number of unique states in this DFA
 	/// </summary>
 	/// <returns></returns>
-	int NumStates();
+	int NumStates() const;
+
+	/// <summary>
+	/// Returns the number of byte classes, which is the number of columns in the transition table
+	/// apart from the line markers
+	/// </summary>
+	/// <returns></returns>
+	int NumByteClasses() const { return byteClasses.NumClasses(); }
+
+	/// <summary>
+	/// Merges states that accept the same inputs, using Hopcroft's partition refinement algorithm.
+	/// States that can never reach a final state are merged into the dead state. Final states are
+	/// only merged if they match the same patterns.
+	/// </summary>
+	void Minimize();
+
+	/// <summary>
+	/// Returns the state a simulation begins in
+	/// </summary>
+	/// <returns></returns>
+	uint32_t StartState() const { return start; }
+
+	/// <summary>
+	/// Returns the state for the next input. This is a single lookup into the transition table, and does
+	/// not modify the DFA, so it is safe to use for simulations that keep their own current state.
+	/// </summary>
+	/// <param name="state">The current state</param>
+	/// <param name="input">The next character of input</param>
+	/// <returns>The next state. Equal to the dead state if no transition was defined.</returns>
+	uint32_t Next(uint32_t state, char input) const { return table[state * numColumns + byteClasses.Get(input)]; }
+
+	/// <summary>
+	/// Returns the state after the start of a line, see Next
+	/// </summary>
+	/// <param name="state"></param>
+	/// <returns></returns>
+	uint32_t NextLineStart(uint32_t state) const { return table[state * numColumns + lineStartColumn]; }
+
+	/// <summary>
+	/// Returns the state after the end of a line, see Next
+	/// </summary>
+	/// <param name="state"></param>
+	/// <returns></returns>
+	uint32_t NextLineEnd(uint32_t state) const { return table[state * numColumns + lineEndColumn]; }
+
+	/// <summary>
+	/// Returns true if the state is the dead state. Once in the dead state no input can leave it.
+	/// </summary>
+	/// <param name="state"></param>
+	/// <returns></returns>
+	bool IsDead(uint32_t state) const { return state == dead; }
+
+	/// <summary>
+	/// Returns true if the state is a final state
+	/// </summary>
+	/// <param name="state"></param>
+	/// <returns></returns>
+	bool IsAccepting(uint32_t state) const { return accepting[state] != 0; }
+
+	/// <summary>
+	/// Returns the ids of the patterns a final state matches, sorted
+	/// </summary>
+	/// <param name="state"></param>
+	/// <returns>Empty if the DFA was not built from several patterns</returns>
+	const std::vector<int>& Patterns(uint32_t state) const { return patterns.empty() ? NO_PATTERNS : patterns[state]; }
 
 	/// <summary>
 	/// Starts a simulation. After calling, the DFA will be ready to accept input
@@ -46,6 +157,16 @@ public:
 	/// <param name="input"></param>
 	void OnNext(char input);
 
+	/// <summary>
+	/// Sends the start of a line to the DFA for processing
+	/// </summary>
+	void OnLineStart();
+
+	/// <summary>
+	/// Sends the end of a line to the DFA for processing
+	/// </summary>
+	void OnLineEnd();
+
 	/// <summary>
 	/// Sends a string of input to the DFA for processing.
 	/// </summary>
@@ -71,6 +192,27 @@ public:
 	/// <returns>True if the DFA is in an accept state</returns>
 	bool EndSimulation();
 
+	/// <summary>
+	/// Appends this DFA to a buffer in a binary format, which holds everything the DFA needs to run
+	/// but not the state of a simulation. See Load.
+	/// </summary>
+	/// <param name="out">The buffer. Its size must be a multiple of 4 bytes, and still is afterwards.</param>
+	void Serialize(std::string& out) const;
+
+	/// <summary>
+	/// Reads a DFA written by Serialize. The transition table is used where it lies in the data
+	/// instead of being copied, so loading takes time linear in the number of states, not the size
+	/// of the table. The data must not change while the DFA or any copy of it is in use.
+	/// </summary>
+	/// <param name="data">Data that was written by Serialize, which must start at an address that
+	/// is a multiple of 4</param>
+	/// <param name="offset">The offset of the DFA in the data, which must be a multiple of 4. Set
+	/// to the offset just past it.</param>
+	/// <param name="owner">Keeps the data alive, it is held for as long as the table is in use</param>
+	/// <param name="outDfa">Output parameter that will contain the DFA</param>
+	/// <returns>False if the data does not hold a valid DFA written by this version</returns>
+	static bool Load(std::string_view data, size_t& offset, std::shared_ptr<const void> owner, DFA& outDfa);
+
 	/// <summary>
 	/// Generates a DFA that accepts the empty string
 	/// </summary>
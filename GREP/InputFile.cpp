@@ -0,0 +1,239 @@
+#include "InputFile.h"
+#include <algorithm>
+#include <cstring>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/// <summary>
+/// Finds the end of the last full line in part of a buffer
+/// </summary>
+/// <returns>One past the last newline in data[from, size), or 0 if there is none</returns>
+static size_t EndOfLastLine(const char* data, size_t from, size_t size)
+{
+	for (size_t i = size; i > from; --i)
+	{
+		if (data[i - 1] == '\n')
+		{
+			return i;
+		}
+	}
+
+	return 0;
+}
+
+std::string InputFile::DisplayName(const std::string& path)
+{
+	return path == STDIN_PATH ? "(standard input)" : path;
+}
+
+#ifdef _WIN32
+
+InputFile::InputFile(const std::string& path)
+{
+	if (path == STDIN_PATH)
+	{
+		file = GetStdHandle(STD_INPUT_HANDLE);
+		ownsFile = false;
+	}
+	else
+	{
+		file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+			FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	}
+
+	if (file == INVALID_HANDLE_VALUE || file == nullptr)
+	{
+		return;
+	}
+
+	// only regular files on disk can be mapped
+	LARGE_INTEGER size;
+	if (GetFileType(file) == FILE_TYPE_DISK && GetFileSizeEx(file, &size) && size.QuadPart > 0)
+	{
+		mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mapping != nullptr)
+		{
+			mapped = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+			mappedSize = (size_t)size.QuadPart;
+		}
+	}
+}
+
+InputFile::~InputFile()
+{
+	if (mapped != nullptr)
+	{
+		UnmapViewOfFile(mapped);
+	}
+	if (mapping != nullptr)
+	{
+		CloseHandle(mapping);
+	}
+	if (IsOpen() && ownsFile)
+	{
+		CloseHandle(file);
+	}
+}
+
+bool InputFile::IsOpen()
+{
+	return file != INVALID_HANDLE_VALUE && file != nullptr;
+}
+
+size_t InputFile::Read(char* data, size_t size)
+{
+	// a pipe whose writer has gone reports an error rather than the end of the file
+	DWORD count = 0;
+	if (!IsOpen() || !ReadFile(file, data, (DWORD)std::min(size, (size_t)MAXDWORD), &count, nullptr))
+	{
+		return 0;
+	}
+
+	return count;
+}
+
+#else
+
+InputFile::InputFile(const std::string& path)
+{
+	if (path == STDIN_PATH)
+	{
+		file = STDIN_FILENO;
+		ownsFile = false;
+	}
+	else
+	{
+		file = open(path.c_str(), O_RDONLY);
+	}
+
+	if (file < 0)
+	{
+		return;
+	}
+
+	// only regular files can be mapped
+	struct stat info;
+	if (fstat(file, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0)
+	{
+		void* address = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+		if (address != MAP_FAILED)
+		{
+			madvise(address, (size_t)info.st_size, MADV_SEQUENTIAL);
+			mapped = (const char*)address;
+			mappedSize = (size_t)info.st_size;
+		}
+	}
+}
+
+InputFile::~InputFile()
+{
+	if (mapped != nullptr)
+	{
+		munmap((void*)mapped, mappedSize);
+	}
+	if (file >= 0 && ownsFile)
+	{
+		close(file);
+	}
+}
+
+bool InputFile::IsOpen()
+{
+	return file >= 0;
+}
+
+size_t InputFile::Read(char* data, size_t size)
+{
+	if (!IsOpen())
+	{
+		return 0;
+	}
+
+	ssize_t count;
+	do
+	{
+		count = read(file, data, size);
+	} while (count < 0 && errno == EINTR);
+
+	return count > 0 ? (size_t)count : 0;
+}
+
+#endif
+
+bool InputFile::ReadChunk()
+{
+	size_t count = Read(buffer.data() + filled, CHUNK_SIZE);
+	filled += count;
+	return count > 0;
+}
+
+bool InputFile::IsMapped()
+{
+	return mapped != nullptr;
+}
+
+bool InputFile::NextBlock(std::string_view& outBlock)
+{
+	if (!IsOpen())
+	{
+		return false;
+	}
+
+	if (IsMapped())
+	{
+		if (mappedReturned)
+		{
+			return false;
+		}
+
+		mappedReturned = true;
+		outBlock = std::string_view(mapped, mappedSize);
+		return true;
+	}
+
+	// drop the last block, keeping the partial line after it
+	if (consumed > 0)
+	{
+		std::memmove(buffer.data(), buffer.data() + consumed, filled - consumed);
+		filled -= consumed;
+		consumed = 0;
+	}
+
+	// read until there is a full chunk to return. Pipes return much less than asked for.
+	while (!endOfFile && filled < CHUNK_SIZE)
+	{
+		if (buffer.size() < filled + CHUNK_SIZE)
+		{
+			buffer.resize(filled + CHUNK_SIZE);
+		}
+		endOfFile = !ReadChunk();
+	}
+
+	// end the block after the last full line. A line longer than a chunk
+	// keeps the file being read until the line ends
+	size_t searched = 0;
+	size_t end = EndOfLastLine(buffer.data(), searched, filled);
+	while (end == 0 && !endOfFile)
+	{
+		searched = filled;
+		buffer.resize(filled + CHUNK_SIZE);
+		endOfFile = !ReadChunk();
+		end = EndOfLastLine(buffer.data(), searched, filled);
+	}
+
+	// at the end of the file, the last line might not have a newline
+	consumed = endOfFile ? filled : end;
+
+	outBlock = std::string_view(buffer.data(), consumed);
+	return consumed > 0;
+}
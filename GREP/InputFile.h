@@ -0,0 +1,93 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+
+class InputFile
+{
+private:
+	// contents of the file when it could be memory mapped, null otherwise
+	const char* mapped = nullptr;
+	size_t mappedSize = 0;
+	bool mappedReturned = false;
+
+	// holds the current block when the file is read in chunks. The first 'filled' bytes are valid,
+	// and the first 'consumed' of those were returned by the last call to NextBlock.
+	std::vector<char> buffer;
+	size_t filled = 0;
+	size_t consumed = 0;
+	bool endOfFile = false;
+
+#ifdef _WIN32
+	void* file;
+	void* mapping = nullptr;
+#else
+	int file;
+#endif
+
+	// false for standard input, which is not closed with the file
+	bool ownsFile = true;
+
+	/// <summary>
+	/// Reads up to CHUNK_SIZE more bytes into the buffer.
+	/// </summary>
+	/// <returns>False once the end of the file is reached</returns>
+	bool ReadChunk();
+
+public:
+
+	// size of each read when the file can not be memory mapped
+	static const size_t CHUNK_SIZE = 4 * 1024 * 1024;
+
+	// the path that stands for standard input
+	static constexpr const char* STDIN_PATH = "-";
+
+	/// <summary>
+	/// Returns the name to show for a path in the output and in errors
+	/// </summary>
+	/// <param name="path"></param>
+	/// <returns>The path, or "(standard input)" for STDIN_PATH</returns>
+	static std::string DisplayName(const std::string& path);
+
+	/// <summary>
+	/// Opens a file for reading. Regular files are memory mapped, anything else, such as
+	/// a pipe, is read in large chunks.
+	/// </summary>
+	/// <param name="path">Path to the file, or STDIN_PATH to read standard input</param>
+	InputFile(const std::string& path);
+
+	~InputFile();
+
+	InputFile(const InputFile&) = delete;
+	InputFile& operator=(const InputFile&) = delete;
+
+	/// <summary>
+	/// Returns true if the file was opened successfully
+	/// </summary>
+	/// <returns></returns>
+	bool IsOpen();
+
+	/// <summary>
+	/// Returns true if the file is memory mapped
+	/// </summary>
+	/// <returns></returns>
+	bool IsMapped();
+
+	/// <summary>
+	/// Gets the next block of the file. Blocks only end partway through a line at the end of
+	/// the file. A memory mapped file is returned as one block.
+	/// </summary>
+	/// <param name="outBlock">Output parameter that will view the block. The view is valid until the
+	/// next call to NextBlock, or until the file is destroyed for memory mapped files.</param>
+	/// <returns>False when there are no blocks left</returns>
+	bool NextBlock(std::string_view& outBlock);
+
+	/// <summary>
+	/// Reads the next bytes of the file into a buffer of the caller's, waiting until some arrive.
+	/// Must not be mixed with NextBlock, and reads a memory mapped file from its start.
+	/// </summary>
+	/// <param name="data">The buffer to read into</param>
+	/// <param name="size">The most bytes to read</param>
+	/// <returns>The number of bytes read, or 0 at the end of the file or on an error</returns>
+	size_t Read(char* data, size_t size);
+};
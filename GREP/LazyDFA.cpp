@@ -0,0 +1,125 @@
+#include "LazyDFA.h"
+#include "Regex.h"
+
+LazyDFA::LazyDFA(NFA nfa, NFA::Search search, size_t maxCacheSize)
+	: nfa(std::move(nfa)), search(search), maxCacheSize(maxCacheSize), byteClasses(this->nfa.Inputs())
+{
+	numColumns = byteClasses.NumClasses() + 2;
+	lineStartColumn = numColumns - 2;
+	lineEndColumn = numColumns - 1;
+
+	startRow = this->nfa.StartRow(search);
+	lineStartRow = search == NFA::Search::Leftmost ? this->nfa.LineStartRow() : this->nfa.StepRow(startRow, Regex::LINE_START);
+}
+
+void LazyDFA::Reset(Cache& cache) const
+{
+	cache.table.clear();
+	cache.accepting.clear();
+	cache.patterns.clear();
+	cache.states.clear();
+	cache.rows.clear();
+	cache.size = 0;
+
+	// every transition out of the dead state leads back to it
+	AddState(cache, { 0 });
+	std::fill(cache.table.begin(), cache.table.end(), DEAD);
+
+	AddState(cache, startRow);
+	cache.table[(size_t)START * numColumns + lineStartColumn] = AddState(cache, lineStartRow);
+}
+
+uint32_t LazyDFA::AddState(Cache& cache, const std::vector<int>& row) const
+{
+	auto inserted = cache.states.emplace(row, (uint32_t)cache.rows.size());
+	if (!inserted.second)
+	{
+		return inserted.first->second;
+	}
+
+	cache.rows.push_back(&inserted.first->first);
+	cache.table.resize(cache.table.size() + numColumns, UNKNOWN);
+	cache.accepting.push_back(nfa.IsFinalRow(row) ? 1 : 0);
+	cache.patterns.push_back(search == NFA::Search::EveryMatch ? nfa.RowPatterns(row) : std::vector<int>());
+
+	// the row of the transition table, and the row of the subset construction table stored in the map
+	cache.size += numColumns * sizeof(uint32_t) + row.size() * sizeof(int) + sizeof(row) + 64 +
+		cache.patterns.back().size() * sizeof(int);
+
+	return inserted.first->second;
+}
+
+uint32_t LazyDFA::Compute(Cache& cache, uint32_t state, int column) const
+{
+	// the bytes in class 0 have no arrows of their own, so only ANY matches them
+	char input = Regex::ANY;
+	if (column == lineStartColumn)
+	{
+		input = Regex::LINE_START;
+	}
+	else if (column == lineEndColumn)
+	{
+		input = Regex::LINE_END;
+	}
+	else if (column != 0)
+	{
+		input = byteClasses.Representative(column);
+	}
+
+	std::vector<int> next = nfa.StepRow(*cache.rows[state], input, cache.scratch);
+
+	auto stateIt = cache.states.find(next);
+	if (stateIt == cache.states.end() && cache.size >= maxCacheSize)
+	{
+		// the state being left is renumbered by the flush, so this transition is not stored
+		Reset(cache);
+		cache.numFlushes++;
+		return AddState(cache, next);
+	}
+
+	uint32_t target = stateIt != cache.states.end() ? stateIt->second : AddState(cache, next);
+	cache.table[(size_t)state * numColumns + column] = target;
+
+	return target;
+}
+
+LazyDFA::Runner LazyDFA::Begin() const
+{
+	std::unique_ptr<Cache> cache;
+	{
+		std::lock_guard<std::mutex> lock(poolMutex);
+		if (!pool.empty())
+		{
+			cache = std::move(pool.back());
+			pool.pop_back();
+		}
+	}
+
+	if (!cache)
+	{
+		cache = std::make_unique<Cache>();
+		Reset(*cache);
+	}
+
+	return Runner(*this, std::move(cache));
+}
+
+LazyDFA::Runner::Runner(const LazyDFA& dfa, std::unique_ptr<Cache> cache)
+	: dfa(dfa), cache(std::move(cache))
+{ }
+
+LazyDFA::Runner::Runner(Runner&& other) noexcept
+	: dfa(other.dfa), cache(std::move(other.cache))
+{ }
+
+LazyDFA::Runner::~Runner()
+{
+	// a runner that was moved from has no cache to give back
+	if (!cache)
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(dfa.poolMutex);
+	dfa.pool.push_back(std::move(cache));
+}
@@ -0,0 +1,203 @@
+#pragma once
+#include "ByteClasses.h"
+#include "NFA.h"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+/// <summary>
+/// A DFA whose states are only built from the NFA when the input reaches them. The states are kept
+/// in a cache of limited size, so a pattern whose full DFA would be huge only costs as much time and
+/// memory as the input it is run on needs.
+///
+/// Each thread running the DFA needs its own cache. Caches are kept in a pool and taken out with
+/// Begin, so one LazyDFA can be shared by any number of threads.
+/// </summary>
+class LazyDFA
+{
+public:
+
+	// default limit on the memory used by one cache
+	static const size_t DEFAULT_CACHE_SIZE = 8 * 1024 * 1024;
+
+private:
+
+	// marks transitions that have not been computed yet
+	static constexpr uint32_t UNKNOWN = UINT32_MAX;
+
+	// states that are created first, and created again in the same order whenever the
+	// cache is flushed, so their numbers never change. The state after the start of a
+	// line is created next, so its number never changes either.
+	static constexpr uint32_t DEAD = 0;
+	static constexpr uint32_t START = 1;
+
+	/// <summary>
+	/// The states that have been built so far, and the transitions between them
+	/// </summary>
+	struct Cache
+	{
+		std::vector<uint32_t> table;
+		std::vector<uint8_t> accepting;
+
+		// the ids of the patterns each state matches, for a Search::EveryMatch DFA
+		std::vector<std::vector<int>> patterns;
+
+		// the row of the subset construction table for each state, see NFA::StepRow
+		std::unordered_map<std::vector<int>, uint32_t, NFA::RowHash> states;
+		std::vector<const std::vector<int>*> rows;
+
+		// the space the rows are built in, kept with the cache so each thread has its own
+		NFA::StepScratch scratch;
+
+		// estimate of the memory used by the states
+		size_t size = 0;
+
+		// number of times the cache has filled up and been emptied
+		size_t numFlushes = 0;
+	};
+
+	NFA nfa;
+	NFA::Search search;
+	size_t maxCacheSize;
+
+	// same layout as the transition table of DFA, one column per byte class followed by the
+	// line markers
+	ByteClasses byteClasses;
+	int numColumns;
+	int lineStartColumn;
+	int lineEndColumn;
+
+	// rows of the subset construction table for the start state, and the state after the
+	// start of a line
+	std::vector<int> startRow;
+	std::vector<int> lineStartRow;
+
+	// caches that are not being used by a thread
+	mutable std::mutex poolMutex;
+	mutable std::vector<std::unique_ptr<Cache>> pool;
+
+	/// <summary>
+	/// Empties a cache, leaving only the states that are always present
+	/// </summary>
+	/// <param name="cache"></param>
+	void Reset(Cache& cache) const;
+
+	/// <summary>
+	/// Returns the number of the state for a row, creating it if needed
+	/// </summary>
+	/// <param name="cache"></param>
+	/// <param name="row"></param>
+	/// <returns></returns>
+	uint32_t AddState(Cache& cache, const std::vector<int>& row) const;
+
+	/// <summary>
+	/// Builds the transition for a column of a state's row, and stores it in the cache. Flushes the
+	/// cache first if it is full, in which case every state except the fixed ones is renumbered.
+	/// </summary>
+	/// <param name="cache"></param>
+	/// <param name="state"></param>
+	/// <param name="column">The column in the transition table</param>
+	/// <returns>The next state</returns>
+	uint32_t Compute(Cache& cache, uint32_t state, int column) const;
+
+public:
+
+	/// <summary>
+	/// A cache taken from the pool, with the same interface for running the DFA as the DFA class.
+	/// The cache goes back to the pool when this is destroyed.
+	/// </summary>
+	class Runner
+	{
+	private:
+		friend class LazyDFA;
+
+		const LazyDFA& dfa;
+		std::unique_ptr<Cache> cache;
+
+		Runner(const LazyDFA& dfa, std::unique_ptr<Cache> cache);
+
+	public:
+		~Runner();
+
+		Runner(const Runner&) = delete;
+		Runner& operator=(const Runner&) = delete;
+
+		/// <summary>
+		/// Takes over the cache of another runner, which is left without one
+		/// </summary>
+		/// <param name="other"></param>
+		Runner(Runner&& other) noexcept;
+
+		uint32_t StartState() const { return START; }
+
+		/// <summary>
+		/// Returns the state for the next input, building it if the input has not been seen in
+		/// this state before. The numbers of states other than the start state and the state
+		/// after the start of a line are only valid until the next call.
+		/// </summary>
+		/// <param name="state"></param>
+		/// <param name="input"></param>
+		/// <returns></returns>
+		uint32_t Next(uint32_t state, char input) const
+		{
+			uint8_t column = dfa.byteClasses.Get(input);
+			uint32_t next = cache->table[(size_t)state * dfa.numColumns + column];
+			return next != UNKNOWN ? next : dfa.Compute(*cache, state, column);
+		}
+
+		uint32_t NextLineStart(uint32_t state) const
+		{
+			uint32_t next = cache->table[(size_t)state * dfa.numColumns + dfa.lineStartColumn];
+			return next != UNKNOWN ? next : dfa.Compute(*cache, state, dfa.lineStartColumn);
+		}
+
+		uint32_t NextLineEnd(uint32_t state) const
+		{
+			uint32_t next = cache->table[(size_t)state * dfa.numColumns + dfa.lineEndColumn];
+			return next != UNKNOWN ? next : dfa.Compute(*cache, state, dfa.lineEndColumn);
+		}
+
+		bool IsDead(uint32_t state) const { return state == DEAD; }
+		bool IsAccepting(uint32_t state) const { return cache->accepting[state] != 0; }
+
+		/// <summary>
+		/// Returns the ids of the patterns a final state matches, see DFA::Patterns
+		/// </summary>
+		/// <param name="state"></param>
+		/// <returns></returns>
+		const std::vector<int>& Patterns(uint32_t state) const { return cache->patterns[state]; }
+
+		/// <summary>
+		/// Returns the number of states in the cache
+		/// </summary>
+		/// <returns></returns>
+		size_t NumStates() const { return cache->accepting.size(); }
+
+		/// <summary>
+		/// Returns the number of times the cache has been flushed
+		/// </summary>
+		/// <returns></returns>
+		size_t NumFlushes() const { return cache->numFlushes; }
+	};
+
+	/// <summary>
+	/// Creates a lazy DFA. No states are built until it is run.
+	/// </summary>
+	/// <param name="nfa">The NFA to convert, which is kept. Move an NFA that is not needed
+	/// afterwards into it, a big one is slow to copy.</param>
+	/// <param name="search">How the DFA runs over its input, see NFA::Search</param>
+	/// <param name="maxCacheSize">Limit on the memory used by each cache, in bytes</param>
+	LazyDFA(NFA nfa, NFA::Search search, size_t maxCacheSize = DEFAULT_CACHE_SIZE);
+
+	LazyDFA(const LazyDFA&) = delete;
+	LazyDFA& operator=(const LazyDFA&) = delete;
+
+	/// <summary>
+	/// Takes a cache from the pool, creating one if every cache is in use
+	/// </summary>
+	/// <returns></returns>
+	Runner Begin() const;
+};
@@ -1,44 +1,339 @@
 #include <iostream>
-#include <fstream>
 #include <string>
 #include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <vector>
 #include "Regex.h"
+#include "Parser.h"
+#include "CodeGenerator.h"
+#include "InputFile.h"
+#include "OutputBuffer.h"
+#include "RegexCache.h"
+#include "Searcher.h"
 
-int main(int argc, char* argv[])
+static void PrintUsage()
+{
+	std::cout << "Usage: grep [-r] [-j <threads>] [-q | -l | -c] [-m <num>] [--stats] [--ids] [--cache <dir>] [--highlight <mode>] <regex> [<file>...]" << std::endl;
+	std::cout << "       grep [-r] [-j <threads>] [-q | -l | -c] [-m <num>] [--stats] [--ids] [--cache <dir>] [--highlight <mode>] (-e <regex> | -f <patterns>)... [<file>...]" << std::endl;
+	std::cout << "       grep --generate <name> (<regex> | (-e <regex> | -f <patterns>)...)" << std::endl;
+}
+
+/// <summary>
+/// Reads a file of patterns, one per line
+/// </summary>
+/// <param name="path"></param>
+/// <param name="patterns">The list to add the patterns to</param>
+/// <returns>False if the file could not be read</returns>
+static bool ReadPatterns(const std::string& path, std::vector<std::string>& patterns)
 {
-	if (argc != 3)
+	std::ifstream file(path, std::ios::binary);
+	if (!file)
 	{
-		std::cout << "Usage: grep <regex> <file>" << std::endl;
-		return 0;
+		return false;
+	}
+
+	std::string pattern;
+	while (std::getline(file, pattern))
+	{
+		patterns.push_back(pattern);
+	}
+
+	return true;
+}
+
+/// <summary>
+/// Parses the patterns one at a time, so an error can point into the one it is in
+/// </summary>
+/// <param name="patterns"></param>
+/// <param name="asts">The list to add the parsed patterns to</param>
+/// <returns>False if a pattern is not valid, after the error has been printed</returns>
+static bool ParsePatterns(const std::vector<std::string>& patterns, std::vector<Ast>& asts)
+{
+	for (const std::string& pattern : patterns)
+	{
+		try
+		{
+			asts.push_back(Parser::Parse(pattern));
+		}
+		catch (const ParseError& e)
+		{
+			// point at the problem under the regex
+			std::cerr << "grep: " << e.what() << " at position " << e.Position() << std::endl;
+			std::cerr << "  " << pattern << std::endl;
+			std::cerr << "  " << std::string(e.Position(), ' ') << '^' << std::endl;
+			return false;
+		}
 	}
 
-	std::string regex = argv[1];
-	std::ifstream file(argv[2]);
-	
-	Regex r = Regex::Parse(regex);
+	return true;
+}
+
+int main(int argc, char* argv[])
+{
+	int numThreads = 0;
+	bool recursive = false;
+	bool printStatistics = false;
+	bool printPatterns = false;
+
+	// what is written for each file, and how many matching lines are found in each
+	Searcher::Mode mode = Searcher::Mode::Lines;
+	size_t maxLines = Searcher::NO_LIMIT;
+
+	// matches are colored on a terminal, and written as they are anywhere else
+	OutputBuffer::Highlight highlight = OutputBuffer::IsTerminal(OutputBuffer::STDOUT)
+		? OutputBuffer::Highlight::Color : OutputBuffer::Highlight::None;
+
+	// where compiled patterns are kept between runs, empty if they are not
+	std::string cacheDirectory;
 
-	std::string input;
-	while (std::getline(file, input))
+	// the namespace to write the code for the patterns in, empty unless the code is all that is wanted
+	std::string generateName;
+
+	// the patterns given with -e and -f. If there are none, the first argument after the options is the regex
+	std::vector<std::string> patterns;
+	bool hasPatterns = false;
+
+	// parse the options before the regex
+	int arg = 1;
+	while (arg < argc && argv[arg][0] == '-' && argv[arg][1] != '\0')
 	{
-		std::vector<std::pair<std::string, int>> matches = r.Match(input);
-		if (matches.size() > 0)
+		std::string option = argv[arg++];
+		if (option == "--")
+		{
+			break;
+		}
+		else if (option == "--stats")
+		{
+			printStatistics = true;
+		}
+		else if (option == "--ids")
+		{
+			printPatterns = true;
+		}
+		else if (option == "--cache" && arg < argc)
+		{
+			cacheDirectory = argv[arg++];
+		}
+		else if (option == "--highlight" && arg < argc)
+		{
+			std::string mode = argv[arg++];
+			if (mode == "color")
+			{
+				highlight = OutputBuffer::Highlight::Color;
+			}
+			else if (mode == "upper")
+			{
+				highlight = OutputBuffer::Highlight::UpperCase;
+			}
+			else if (mode == "none")
+			{
+				highlight = OutputBuffer::Highlight::None;
+			}
+			else
+			{
+				PrintUsage();
+				return 0;
+			}
+		}
+		else if (option == "--generate" && arg < argc)
+		{
+			generateName = argv[arg++];
+		}
+		else if (option == "-e" && arg < argc)
+		{
+			patterns.push_back(argv[arg++]);
+			hasPatterns = true;
+		}
+		else if (option == "-f" && arg < argc)
+		{
+			std::string path = argv[arg++];
+			if (!ReadPatterns(path, patterns))
+			{
+				std::cerr << "grep: " << path << ": could not open file" << std::endl;
+				return 1;
+			}
+			hasPatterns = true;
+		}
+		else if (option == "-r")
+		{
+			recursive = true;
+		}
+		else if (option == "-q")
+		{
+			mode = Searcher::Mode::Quiet;
+		}
+		else if (option == "-l")
+		{
+			mode = Searcher::Mode::Files;
+		}
+		else if (option == "-c")
+		{
+			mode = Searcher::Mode::Count;
+		}
+		else if (option == "-m" && arg < argc)
+		{
+			std::string count = argv[arg++];
+			if (count.empty() || count.find_first_not_of("0123456789") != std::string::npos)
+			{
+				PrintUsage();
+				return 0;
+			}
+			maxLines = std::strtoull(count.c_str(), nullptr, 10);
+		}
+		else if (option == "-j" && arg < argc)
 		{
-			// capitalize occurrences of the matches in the line
-			for (auto& match : matches)
+			numThreads = std::atoi(argv[arg++]);
+			if (numThreads < 1)
 			{
-				// convert matches to uppercase
-				int idx = match.second;
-				std::string& text = match.first;
-				std::transform(
-					input.begin() + idx, 
-					input.begin() + idx + text.length(),
-					input.begin() + idx,
-					std::toupper);
+				PrintUsage();
+				return 0;
 			}
+		}
+		else
+		{
+			PrintUsage();
+			return 0;
+		}
+	}
+
+	if (!hasPatterns)
+	{
+		if (arg == argc)
+		{
+			PrintUsage();
+			return 0;
+		}
+		patterns.push_back(argv[arg++]);
+	}
+
+	// the code is written instead of searching, so it takes no files
+	bool hasFiles = arg < argc;
+	if (!generateName.empty() && (hasFiles || !CodeGenerator::IsIdentifier(generateName)))
+	{
+		PrintUsage();
+		return 0;
+	}
+
+	// an empty pattern file gives nothing to match
+	if (patterns.empty())
+	{
+		return 1;
+	}
+
+	if (!generateName.empty())
+	{
+		std::vector<Ast> asts;
+		if (!ParsePatterns(patterns, asts))
+		{
+			return 1;
+		}
+
+		if (!CodeGenerator::Generate(patterns, generateName, std::cout))
+		{
+			std::cerr << "grep: the dfas are too big to generate code for" << std::endl;
+			return 1;
+		}
+		return 0;
+	}
+
+	std::ios::sync_with_stdio(false);
+
+	// standard input is searched if no file is given
+	std::vector<std::string> paths(argv + arg, argv + argc);
+	if (paths.empty())
+	{
+		paths.push_back(InputFile::STDIN_PATH);
+	}
 
-			std::cout << input << "\n";
+	// patterns that were compiled by an earlier run are loaded as they are
+	Regex r;
+	RegexCache cache(cacheDirectory);
+	bool isCached = !cacheDirectory.empty() && cache.Load(patterns, true, r);
+	if (!isCached)
+	{
+		std::vector<Ast> asts;
+		if (!ParsePatterns(patterns, asts))
+		{
+			return 1;
 		}
+
+		r = Regex::Compile(asts);
+		if (!cacheDirectory.empty())
+		{
+			cache.Store(patterns, true, r);
+		}
+	}
+
+	const Regex::Statistics& statistics = r.GetStatistics();
+	if (printStatistics && isCached)
+	{
+		std::cerr << "grep: the dfas were loaded from the cache" << std::endl;
+	}
+
+	if (printStatistics && statistics.literalStates > 0)
+	{
+		std::cerr << "grep: the patterns are plain literals, found with an Aho-Corasick automaton of "
+			<< statistics.literalStates << " states" << std::endl;
+	}
+	else if (printStatistics && statistics.searchStates == 0)
+	{
+		std::cerr << "grep: the dfas are too big to build up front, they are built lazily" << std::endl;
+	}
+	else if (printStatistics)
+	{
+		std::cerr << "grep: search dfa: " << statistics.searchStates << " states, "
+			<< statistics.minimizedSearchStates << " after minimizing" << std::endl;
+		std::cerr << "grep: reverse dfa: " << statistics.reverseStates << " states, "
+			<< statistics.minimizedReverseStates << " after minimizing" << std::endl;
+		std::cerr << "grep: " << statistics.byteClasses << " byte classes" << std::endl;
+	}
+
+	// the Aho-Corasick automaton tells the patterns apart itself
+	bool hasPatternDfa = r.NumPatterns() > 1 && statistics.literalStates == 0;
+	if (printStatistics && hasPatternDfa && statistics.patternStates == 0)
+	{
+		std::cerr << "grep: the pattern dfa is too big to build up front, it is built lazily" << std::endl;
+	}
+	else if (printStatistics && hasPatternDfa)
+	{
+		std::cerr << "grep: pattern dfa: " << statistics.patternStates << " states, "
+			<< statistics.minimizedPatternStates << " after minimizing" << std::endl;
+	}
+
+	// a single file is split between the threads, many files are shared out between them. A
+	// single stream, such as standard input, is read, searched and written by threads of its own
+	std::error_code error;
+	if (paths.size() == 1 && !recursive && !std::filesystem::is_directory(paths[0], error))
+	{
+		InputFile file(paths[0]);
+		if (!file.IsOpen())
+		{
+			std::cerr << "grep: " << InputFile::DisplayName(paths[0]) << ": could not open file" << std::endl;
+			return 1;
+		}
+
+		Searcher searcher(r, numThreads > 0 ? numThreads : 1, printPatterns, highlight, mode, maxLines);
+		size_t numLines = searcher.Search(file, InputFile::DisplayName(paths[0]), OutputBuffer::STDOUT);
+
+		// -q only answers with the exit status
+		return mode == Searcher::Mode::Quiet && numLines == 0 ? 1 : 0;
+	}
+
+	if (numThreads == 0)
+	{
+		numThreads = std::max((int)std::thread::hardware_concurrency(), 1);
+	}
+
+	Searcher searcher(r, numThreads, printPatterns, highlight, mode, maxLines);
+	bool found = false;
+	bool result = searcher.Search(paths, recursive, OutputBuffer::STDOUT, found);
+	if (mode == Searcher::Mode::Quiet)
+	{
+		return found ? 0 : 1;
 	}
 
-	return 0;
-}
\ No newline at end of file
+	return result ? 0 : 1;
+}
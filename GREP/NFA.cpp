@@ -1,408 +1,575 @@
 #include "NFA.h"
+#include "NFABuilder.h"
+#include "Regex.h"
 #include <vector>
 #include <algorithm>
-#include <iterator>
-#include <stack>
+#include <cstdint>
+#include <unordered_map>
 
 NFA::NFA(const std::set<int>& q, const std::map<int, std::map<char, std::set<int>>>& transitions,
 	int q0, int f)
-	: q(q), transitions(transitions), q0(q0), f(f)
+	: q(q), q0(q0), f(f), numIds(0)
 {
-	// ensure all states are present in the transition map, this is an assumption
-	// some of the later methods make
-	for (int state : q)
+	// split the epsilon arrows out of the transition map
+	for (auto& stateIt : transitions)
 	{
-		if (transitions.find(state) == transitions.end())
+		for (auto& transitionIt : stateIt.second)
 		{
-			this->transitions.emplace(std::make_pair(state, std::map<char, std::set<int>>()));
+			if (transitionIt.first == '\0')
+			{
+				epsilonTransitions[stateIt.first].insert(transitionIt.second.begin(), transitionIt.second.end());
+			}
+			else
+			{
+				this->transitions[stateIt.first].emplace(transitionIt);
+			}
 		}
 	}
+
+	ComputeClosures();
 }
 
-int NFA::NumStates()
+NFA::NFA(const std::set<int>& q, const std::map<int, std::map<char, std::set<int>>>& transitions,
+	const std::map<int, std::set<int>>& epsilonTransitions, int q0, int f)
+	: q(q), transitions(transitions), epsilonTransitions(epsilonTransitions), q0(q0), f(f), numIds(0)
 {
-	return q.size();
+	ComputeClosures();
 }
 
-std::set<int> NFA::EpsilonClosure(const std::set<int>& starts)
+void NFA::ComputeClosures()
 {
-	std::set<int> ec;
-
-	// maintain a stack of the chain of states we are searching down,
-	// similar to DFS
-	std::stack<int> stack;
-
-	for (int startState : starts)	// for each start state
+	// ensure all states are present in the transition map, this is an assumption
+	// some of the later methods make
+	for (int state : q)
 	{
-		stack.push(startState);
-		while (!stack.empty())		// until we have completed the traversal and returned to the start state
+		if (transitions.find(state) == transitions.end())
 		{
-			int state = stack.top(); // arrive at the next state in the epsilon closure
-			stack.pop();
-
-			ec.insert(state);		// insert this state into the epsilon closure
-
-			auto epsilonTransitionIt = (std::find_if(transitions[state].begin(), transitions[state].end(), [&](auto& v) {
-				return v.first == '\0';
-			}));					// find the map containing the epsilon transitions for this state
-			if (epsilonTransitionIt != transitions[state].end())
-			{
-				const std::set<int>& epsilonTransitions = epsilonTransitionIt->second;
-				
-				for (int s : epsilonTransitions) // for each state that can be reached with an epsilon arrow	
-				{
-					if (ec.find(s) == ec.end())  // add that state to the stack of states to be inspected later
-					{
-						stack.push(s);
-					}
-				}
-			}
+			transitions.emplace(std::make_pair(state, std::map<char, std::set<int>>()));
 		}
 	}
 
-	return ec;
-}
-
-DFA NFA::ConvertToDFA()
-{
-	// variables to make up the output DFA
-	std::set<int> dfaQ;
-	std::map<int, std::map<char, int>> dfaTransitions;
-	int dfaQ0 = 0;
-	std::set<int> dfaF;
-
-	std::vector<std::pair< std::set<int>, std::map<char, std::set<int>>>> subsetConstructionTable;
-
-	// create the first row of the subset construction table, the epsilon closure of the
-	// start state
-	std::set<int> start = EpsilonClosure({ q0 });
-	subsetConstructionTable.push_back(std::make_pair(start, std::map<char, std::set<int>>()));
-
-	// loop over all elements of subset construction table
-	int subsetIndex = 0;
-	while (subsetIndex < subsetConstructionTable.size())
+	// sets of states are indexed by state, so they need room for the largest one
+	numIds = std::max(q0, f) + 1;
+	for (auto& stateIt : transitions)
 	{
-		auto& it = *(subsetConstructionTable.begin() + subsetIndex);
-		// for each state in this row header
-		for (int state : it.first)
+		numIds = std::max(numIds, stateIt.first + 1);
+		for (auto& transitionIt : stateIt.second)
 		{
-			// for each input arrow defined for this state
-			for (auto& transitionIt : transitions[state])
-			{
-				char input = transitionIt.first;
-
-				// ignore if this input is epsilon
-				if (input == '\0')
-				{
-					continue;
-				}
-
-				// add its destinations to that inputs column in the subset construction table
-				if (it.second.find(input) == it.second.end())
-				{
-					it.second.emplace(std::make_pair(input, std::set<int>()));
-				}
-				
-				std::set<int> setUnion;
-				std::set_union(
-					it.second[input].begin(),
-					it.second[input].end(),
-					transitions[state][input].begin(),
-					transitions[state][input].end(),
-					std::inserter(setUnion, setUnion.begin()));
-				it.second[input] = setUnion;
-			}
-
-			// calculate epsilon closure for each input
-			for (auto& input : it.second)
+			if (!transitionIt.second.empty())
 			{
-				input.second = EpsilonClosure(input.second);
+				numIds = std::max(numIds, *transitionIt.second.rbegin() + 1);
 			}
 		}
+	}
+	for (auto& stateIt : epsilonTransitions)
+	{
+		numIds = std::max(numIds, stateIt.first + 1);
+		if (!stateIt.second.empty())
+		{
+			numIds = std::max(numIds, *stateIt.second.rbegin() + 1);
+		}
+	}
 
-		std::vector<std::pair< std::set<int>, std::map<char, std::set<int>>>> addToConstruction;
+	// copy the epsilon arrows into arrays, so the searches below do not look up each state in a map
+	std::vector<std::vector<int>> epsilonArrows(numIds);
+	for (auto& stateIt : epsilonTransitions)
+	{
+		epsilonArrows[stateIt.first].assign(stateIt.second.begin(), stateIt.second.end());
+	}
 
-		// add all new state combinations to the table
-		for (auto& row : it.second)
+	// a group only ever starts from the start state, or from a state entered by consuming input
+	std::vector<int> entries = { q0 };
+	inputArrows.assign(numIds, std::vector<std::pair<char, int>>());
+	for (auto& stateIt : transitions)
+	{
+		for (auto& transitionIt : stateIt.second)
 		{
-			// check if the subset construction table already contains the combination
-			bool foundAlready = std::find_if(subsetConstructionTable.begin(), subsetConstructionTable.end(), [&](auto& val) {
-				return val.first == row.second;
-			}) != subsetConstructionTable.end();
-
-			if (!foundAlready)
+			entries.insert(entries.end(), transitionIt.second.begin(), transitionIt.second.end());
+			for (int destination : transitionIt.second)
 			{
-				addToConstruction.emplace_back(std::make_pair(row.second, std::map<char, std::set<int>>()));
+				inputArrows[stateIt.first].emplace_back(transitionIt.first, destination);
 			}
 		}
-
-		subsetConstructionTable.insert(subsetConstructionTable.end(), addToConstruction.begin(), addToConstruction.end());
-		subsetIndex++;
 	}
 
-	// construct the DFA
-	for (int i = 0; i < subsetConstructionTable.size(); ++i)
-	{
-		// add the state
-		dfaQ.insert(i);
+	// the entry whose closure each state was last added to, so the marks never need clearing
+	std::vector<int> foundFrom(numIds, -1);
 
-		// add the transitions
-		for (auto& mapIt : subsetConstructionTable[i].second)
+	closures.assign(numIds, std::vector<int>());
+	for (int entry : entries)
+	{
+		std::vector<int>& closure = closures[entry];
+		if (!closure.empty())
 		{
-			int idx = std::find_if(subsetConstructionTable.begin(), subsetConstructionTable.end(), [&](auto& val) {
-				return val.first == mapIt.second;
-			}) - subsetConstructionTable.begin();
+			continue;
+		}
 
-			if (dfaTransitions.find(i) == dfaTransitions.end())
+		// the closure doubles as the queue of states still to be searched
+		closure.push_back(entry);
+		foundFrom[entry] = entry;
+		for (size_t i = 0; i < closure.size(); ++i)
+		{
+			for (int next : epsilonArrows[closure[i]])
 			{
-				dfaTransitions.emplace(std::make_pair(i, std::map<char, int>()));
+				if (foundFrom[next] != entry)
+				{
+					foundFrom[next] = entry;
+					closure.push_back(next);
+				}
 			}
-			dfaTransitions[i].emplace(std::make_pair(mapIt.first, idx));
 		}
 
-		// check if this is a final state
-		if (subsetConstructionTable[i].first.find(f) != subsetConstructionTable[i].first.end())
-		{
-			dfaF.insert(i);
-		}
+		std::sort(closure.begin(), closure.end());
 	}
-
-	return DFA(dfaQ, dfaTransitions, dfaQ0, dfaF);
 }
 
-NFA NFA::GenerateSingle(char input)
+size_t NFA::RowHash::operator()(const std::vector<int>& row) const
 {
-	std::set<int> q = { 0, 1 };
-	std::map<char, std::set<int>> transition = {
-		{ input, { 1 }}
-	};
-	std::map<int, std::map<char, std::set<int>>> transitions = {
-		{ 0, transition }
-	};
-
-	int q0 = 0;
-	int f = 1;
+	// FNV-1a over the states of the row
+	uint64_t hash = 14695981039346656037ull;
+	for (int state : row)
+	{
+		hash = (hash ^ (uint32_t)state) * 1099511628211ull;
+	}
 
-	return NFA(q, transitions, q0, f);
+	return (size_t)hash;
 }
 
-NFA NFA::GenerateEmpty()
+int NFA::NumStates()
 {
-	std::set<int> q = { 0, 1 };
-	std::map<char, std::set<int>> transition = {
-		{ '\0', { 1 }}
-	};
-	std::map<int, std::map<char, std::set<int>>> transitions = {
-		{ 0, transition }
-	};
-
-	int q0 = 0;
-	int f = 1;
-
-	return NFA(q, transitions, q0, f);
+	return q.size();
 }
 
-void NFA::RemapTransitions(const NFA& n, int base, std::map<int, int>& outMap, std::map<int, std::map<char, std::set<int>>>& outTransitions)
+// adds states to a list, skipping the ones already marked in it
+template <typename States>
+static void AddStates(const States& states, std::vector<int>& list, std::vector<bool>& inList)
 {
-	// remap states from base to base+n
-	int count = 0;
-	for (int state : n.q)
+	for (int state : states)
 	{
-		outMap.emplace(std::make_pair(state, count + base));
-		count++;
+		if (!inList[state])
+		{
+			inList[state] = true;
+			list.push_back(state);
+		}
 	}
+}
 
-	// loop through each transition in the nfa
-	for (auto& keyVal1 : n.transitions)
+void NFA::EpsilonClosure(std::vector<int>& states, std::vector<bool>& inSet) const
+{
+	// the closure of each start state is already known, so only their union is left
+	size_t numStarts = states.size();
+	for (size_t i = 0; i < numStarts; ++i)
 	{
-		// translate the start state
-		int startState = keyVal1.first;
-		int newStartState = outMap[startState];
-		outTransitions.emplace(std::make_pair(newStartState, std::map<char, std::set<int>>()));
+		AddStates(closures[states[i]], states, inSet);
+	}
+
+	// groups are kept sorted, so equal groups always give equal rows
+	std::sort(states.begin(), states.end());
+}
 
-		// loop through each input for this state
-		for (auto& transitionKeyVal : n.transitions.at(startState))
+bool NFA::AppendGroup(const std::vector<int>& group, std::vector<bool>& seen, std::vector<int>& row) const
+{
+	bool added = false;
+	bool final = false;
+
+	for (int state : group)
+	{
+		if (!seen[state])
 		{
-			char input = transitionKeyVal.first;
-			const std::set<int>& destinations = transitionKeyVal.second;
-			outTransitions[newStartState].emplace(std::make_pair(input, std::set<int>()));
-
-			// translate each of the inputs destination states
-			std::transform(
-				destinations.begin(),
-				destinations.end(),
-				std::inserter(outTransitions[newStartState][input], outTransitions[newStartState][input].begin()),
-				[&](int val) {
-					return outMap[val];
-				});
+			seen[state] = true;
+			row.push_back(state);
+			added = true;
+			final = final || state == f;
 		}
 	}
+
+	// terminate the group
+	if (added)
+	{
+		row.push_back(-1);
+	}
+
+	return final;
 }
 
-std::map<int, std::map<char, std::set<int>>> NFA::CombineTransitions(const NFA& n1, const NFA& n2, std::map<int, int>& outM1, std::map<int, int>& outM2)
+bool NFA::AppendClosure(std::vector<int>& group, std::vector<bool>& inGroup, std::vector<bool>& seen, std::vector<int>& row) const
 {
-	std::map<int, std::map<char, std::set<int>>> newTransitions;
+	EpsilonClosure(group, inGroup);
+	bool final = AppendGroup(group, seen, row);
 
-	RemapTransitions(n1, 1, outM1, newTransitions);
-	RemapTransitions(n2, 1 + n1.q.size(), outM2, newTransitions);
+	// leave the scratch space empty for the next group
+	for (int state : group)
+	{
+		inGroup[state] = false;
+	}
+	group.clear();
 
-	return newTransitions;
+	return final;
 }
 
-NFA NFA::Union(const NFA& n1, const NFA& n2)
+std::vector<int> NFA::StepRow(const std::vector<int>& row, char input) const
 {
-	std::map<int, int> n1Map;
-	std::map<int, int> n2Map;
-	std::map<int, std::map<char, std::set<int>>> transitions = CombineTransitions(n1, n2, n1Map, n2Map);
+	StepScratch scratch;
+	return StepRow(row, input, scratch);
+}
 
-	int q0 = 0;
+std::vector<int> NFA::StepRow(const std::vector<int>& row, char input, StepScratch& scratch) const
+{
+	bool isLineMarker = input == Regex::LINE_START || input == Regex::LINE_END;
+	bool everyMatch = row[0] == (int)Search::EveryMatch;
 
-	// n1 states remapped from 1-n, n2 remapped from n+1-m, new final state is one past that
-	int f = n1.q.size() + n2.q.size() + 1;
+	if (scratch.seen.size() < (size_t)numIds)
+	{
+		scratch.seen.assign(numIds, false);
+		scratch.inGroup.assign(numIds, false);
+	}
+	std::vector<bool>& seen = scratch.seen;
+	std::vector<bool>& inGroup = scratch.inGroup;
+	std::vector<int>& group = scratch.group;
 
-	// add epsilon arrow from q0 to start state of n1 and n2
-	std::map<char, std::set<int>> epsilonStartArrows = {
-		{ '\0', { n1Map[n1.q0], n2Map[n2.q0] } }
-	};
-	transitions.emplace(std::make_pair(q0, epsilonStartArrows));
+	std::vector<int> next = { row[0] };
+	bool matched = false;
 
-	// add epsilon transition from final state of n1 to f
-	if (transitions.find(n1Map[n1.f]) == transitions.end())
+	// advance each group in order, stopping early if one reaches the final state
+	for (size_t i = 1; i < row.size() && !matched; ++i)
 	{
-		transitions.emplace(std::make_pair(n1Map[n1.f], std::map<char, std::set<int>>()));
+		int state = row[i];
+		if (state != -1)
+		{
+			// take the arrows for this input, and the ANY arrows unless the input is a line marker. Most
+			// states of a Thompson NFA have none, their epsilon arrows are already in the closures
+			for (auto& arrow : inputArrows[state])
+			{
+				int destination = arrow.second;
+				if ((arrow.first == input || (arrow.first == Regex::ANY && !isLineMarker)) && !inGroup[destination])
+				{
+					inGroup[destination] = true;
+					group.push_back(destination);
+				}
+			}
+			continue;
+		}
+
+		// every thread of an EveryMatch row stays in the one group, it is closed below
+		if (!everyMatch)
+		{
+			matched = AppendClosure(group, inGroup, seen, next);
+		}
 	}
-	if (transitions[n1Map[n1.f]].find('\0') == transitions[n1Map[n1.f]].end())
+
+	if (everyMatch)
 	{
-		transitions[n1Map[n1.f]].emplace(std::make_pair('\0', std::set<int>()));
+		// looking for every match, so a new thread is started at every position and nothing is dropped
+		AddStates(std::set<int>{ q0 }, group, inGroup);
+		AppendClosure(group, inGroup, seen, next);
 	}
-	transitions[n1Map[n1.f]]['\0'].insert(f);
-
-	// add epsilon transition from final state of n2 to f
-	if (transitions.find(n2Map[n2.f]) == transitions.end())
+	else if (next[0] && !matched)
 	{
-		transitions.emplace(std::make_pair(n2Map[n2.f], std::map<char, std::set<int>>()));
+		// an unanchored search starts a new group at every position until a match is found
+		AddStates(std::set<int>{ q0 }, group, inGroup);
+		matched = AppendClosure(group, inGroup, seen, next);
 	}
-	if (transitions[n2Map[n2.f]].find('\0') == transitions[n2Map[n2.f]].end())
+
+	if (matched)
 	{
-		transitions[n2Map[n2.f]].emplace(std::make_pair('\0', std::set<int>()));
+		next[0] = 0;
 	}
-	transitions[n2Map[n2.f]]['\0'].insert(f);
 
-	// set up the states of the new NFA
-	std::set<int> q;
-	for (int i = 0; i <= f; ++i)
+	// leave the scratch space empty for the next row, clearing only the states that were set
+	for (size_t i = 1; i < next.size(); ++i)
 	{
-		q.insert(i);
+		if (next[i] != -1)
+		{
+			seen[next[i]] = false;
+		}
 	}
 
-	return NFA(q, transitions, q0, f);
+	return next;
 }
 
-NFA NFA::Concatenate(const NFA& n1, const NFA& n2)
+std::vector<int> NFA::StartRow(Search search) const
 {
-	std::map<int, int> n1Map;
-	std::map<int, int> n2Map;
-	std::map<int, std::map<char, std::set<int>>> transitions = CombineTransitions(n1, n2, n1Map, n2Map);
+	std::vector<int> start = { (int)search };
+	std::vector<bool> seen(numIds);
+	std::vector<bool> inGroup(numIds);
+	std::vector<int> group;
+	AddStates(std::set<int>{ q0 }, group, inGroup);
+	if (AppendClosure(group, inGroup, seen, start) && search == Search::Leftmost)
+	{
+		start[0] = 0;
+	}
 
-	// start state of n1 is new start state
-	int q0 = n1Map[n1.q0];
+	return start;
+}
 
-	// add epsilon transition from final state of n1 to start state of n2
-	if (transitions.find(n1Map[n1.f]) == transitions.end())
+std::vector<int> NFA::LineStartRow() const
+{
+	// the start of a line has no width, so a search from the start of a line treats
+	// threads that started before and after it as starting at the same position
+	std::vector<bool> inGroup(numIds);
+	std::vector<int> lineStart;
+	AddStates(std::set<int>{ q0 }, lineStart, inGroup);
+	for (int state : closures[q0])
 	{
-		transitions.emplace(std::make_pair(n1Map[n1.f], std::map<char, std::set<int>>()));
+		for (auto& arrow : inputArrows[state])
+		{
+			if (arrow.first == Regex::LINE_START && !inGroup[arrow.second])
+			{
+				inGroup[arrow.second] = true;
+				lineStart.push_back(arrow.second);
+			}
+		}
 	}
-	if (transitions[n1Map[n1.f]].find('\0') == transitions[n1Map[n1.f]].end())
+
+	std::vector<int> next = { (int)Search::Leftmost };
+	std::vector<bool> seen(numIds);
+	if (AppendClosure(lineStart, inGroup, seen, next))
 	{
-		transitions[n1Map[n1.f]].emplace(std::make_pair('\0', std::set<int>()));
+		next[0] = 0;
 	}
-	transitions[n1Map[n1.f]]['\0'].insert(n2Map[n2.q0]);
 
-	// final state of n2 is new final state
-	int f = n2Map[n2.f];
+	return next;
+}
 
-	// set up the states of the new NFA
-	std::set<int> q;
-	for (int i = 1; i <= f; ++i)
+std::set<char> NFA::Inputs() const
+{
+	std::set<char> inputs;
+	for (auto& stateIt : transitions)
 	{
-		q.insert(i);
+		for (auto& transitionIt : stateIt.second)
+		{
+			inputs.insert(transitionIt.first);
+		}
 	}
 
-	return NFA(q, transitions, q0, f);
+	return inputs;
 }
 
-NFA NFA::KleeneStar(const NFA& n)
+bool NFA::IsDeadRow(const std::vector<int>& row) const
 {
-	// remap states starting at 1
-	std::map<int, int> map;
-	std::map<int, std::map<char, std::set<int>>> transitions;
-	RemapTransitions(n, 1, map, transitions);
-
-	int q0 = 0;
-	int f = n.q.size();
+	// no groups left and no new ones will be started
+	return row.size() == 1 && row[0] == 0;
+}
 
-	// add epsilon arrow from q0 to n start, and from q0 to f
-	std::map<char, std::set<int>> q0Transitions = {
-		{ '\0', { map[n.q0], f } }
-	};
-	transitions.emplace(std::make_pair(q0, q0Transitions));
+bool NFA::IsFinalRow(const std::vector<int>& row) const
+{
+	return std::find(row.begin() + 1, row.end(), f) != row.end();
+}
 
-	// add epsilon arrows from n end to n start and f
-	if (transitions.find(map[n.f]) == transitions.end()) 
+std::vector<int> NFA::RowPatterns(const std::vector<int>& row) const
+{
+	std::vector<int> patterns;
+	if (patternOf.empty())
 	{
-		transitions.emplace(std::make_pair(map[n.f], std::map<char, std::set<int>>()));
+		return patterns;
 	}
-	if (transitions[map[n.f]].find('\0') == transitions[map[n.f]].end())
+
+	// a state is only ever in one group of a row, so no pattern is found twice
+	for (size_t i = 1; i < row.size(); ++i)
 	{
-		transitions[map[n.f]].emplace(std::make_pair('\0', std::set<int>()));
+		if (row[i] != -1 && patternOf[row[i]] != -1)
+		{
+			patterns.push_back(patternOf[row[i]]);
+		}
 	}
-	transitions[map[n.f]]['\0'].insert({map[n.q0], f});
 
-	// set up the states of the new NFA
-	std::set<int> q;
-	for (int i = 0; i <= f; ++i)
+	std::sort(patterns.begin(), patterns.end());
+	return patterns;
+}
+
+bool NFA::Determinize(Search search, size_t maxStates, DFA& outDfa) const
+{
+	// variables to make up the output DFA
+	std::set<int> dfaQ;
+	std::map<int, std::map<char, int>> dfaTransitions;
+	int dfaQ0 = 0;
+	std::set<int> dfaF;
+	std::map<int, std::vector<int>> dfaPatterns;
+
+	// every input with an explicit arrow gets its own column. Line markers are always included
+	// since an unanchored search can consume them. All other bytes share the ANY column.
+	std::set<char> inputs = Inputs();
+	inputs.insert({ Regex::LINE_START, Regex::LINE_END, Regex::ANY });
+
+	// the rows of the subset construction table, and the DFA state for each
+	StepScratch scratch;
+	std::vector<std::vector<int>> subsetConstructionTable;
+	std::unordered_map<std::vector<int>, int, RowHash> dfaStates;
+
+	// create the first row of the subset construction table, the epsilon closure of the
+	// start state
+	std::vector<int> start = StartRow(search);
+	subsetConstructionTable.push_back(start);
+	dfaStates.emplace(start, 0);
+
+	// loop over all rows of the subset construction table, adding new rows as they are reached
+	for (int i = 0; i < subsetConstructionTable.size(); ++i)
 	{
-		q.insert(i);
+		if (subsetConstructionTable.size() > maxStates)
+		{
+			return false;
+		}
+
+		dfaQ.insert(i);
+
+		// check if this is a final state
+		if (IsFinalRow(subsetConstructionTable[i]))
+		{
+			dfaF.insert(i);
+			if (search == Search::EveryMatch)
+			{
+				dfaPatterns.emplace(i, RowPatterns(subsetConstructionTable[i]));
+			}
+		}
+
+		for (char input : inputs)
+		{
+			std::vector<int> next = search == Search::Leftmost && i == 0 && input == Regex::LINE_START ?
+				LineStartRow() :
+				StepRow(subsetConstructionTable[i], input, scratch);
+
+			if (IsDeadRow(next))
+			{
+				continue;
+			}
+
+			auto stateIt = dfaStates.find(next);
+			if (stateIt == dfaStates.end())
+			{
+				stateIt = dfaStates.emplace(next, (int)subsetConstructionTable.size()).first;
+				subsetConstructionTable.push_back(next);
+			}
+
+			dfaTransitions[i].emplace(input, stateIt->second);
+		}
 	}
 
-	return NFA(q, transitions, q0, f);
+	outDfa = DFA(dfaQ, dfaTransitions, dfaQ0, dfaF, dfaPatterns);
+	return true;
 }
 
-NFA NFA::Optional(const NFA& n)
+DFA NFA::ConvertToDFA() const
 {
-	// clone transitions without remapping
-	std::map<int, int> map;
-	std::map<int, std::map<char, std::set<int>>> transitions;
-	RemapTransitions(n, 0, map, transitions);
+	DFA dfa = DFA::GenerateEmpty();
+	Determinize(Search::Anchored, SIZE_MAX, dfa);
+	return dfa;
+}
+
+DFA NFA::ConvertToSearchDFA() const
+{
+	DFA dfa = DFA::GenerateEmpty();
+	Determinize(Search::Leftmost, SIZE_MAX, dfa);
+	return dfa;
+}
+
+DFA NFA::ConvertToPatternDFA() const
+{
+	DFA dfa = DFA::GenerateEmpty();
+	Determinize(Search::EveryMatch, SIZE_MAX, dfa);
+	return dfa;
+}
+
+bool NFA::TryConvertToDFA(size_t maxStates, DFA& outDfa) const
+{
+	return Determinize(Search::Anchored, maxStates, outDfa);
+}
 
-	int q0 = 0;
-	int f = map[n.f];
+bool NFA::TryConvertToSearchDFA(size_t maxStates, DFA& outDfa) const
+{
+	return Determinize(Search::Leftmost, maxStates, outDfa);
+}
+
+bool NFA::TryConvertToPatternDFA(size_t maxStates, DFA& outDfa) const
+{
+	return Determinize(Search::EveryMatch, maxStates, outDfa);
+}
 
-	// add epsilon arrow from start state to end state
-	if (transitions.find(0) == transitions.end())
+NFA NFA::Reverse() const
+{
+	// flip the direction of every arrow, including the epsilon arrows
+	std::map<int, std::map<char, std::set<int>>> reversed;
+	for (auto& stateIt : transitions)
 	{
-		transitions.emplace(std::make_pair(0, std::map<char, std::set<int>>()));
+		for (auto& transitionIt : stateIt.second)
+		{
+			for (int destination : transitionIt.second)
+			{
+				reversed[destination][transitionIt.first].insert(stateIt.first);
+			}
+		}
 	}
-	if (transitions[0].find('\0') == transitions[0].end())
+
+	std::map<int, std::set<int>> reversedEpsilons;
+	for (auto& stateIt : epsilonTransitions)
 	{
-		transitions[0].emplace(std::make_pair('\0', std::set<int>()));
+		for (int destination : stateIt.second)
+		{
+			reversedEpsilons[destination].insert(stateIt.first);
+		}
 	}
-	transitions[0]['\0'].insert(map[n.f]);
 
-	// set up the states of the new NFA
-	std::set<int> q;
-	for (int i = 0; i <= f; ++i)
+	// the start and final states trade places
+	return NFA(q, reversed, reversedEpsilons, f, q0);
+}
+
+NFA NFA::GenerateSingle(char input)
+{
+	NFABuilder builder;
+	return builder.Build(builder.Single(input));
+}
+
+NFA NFA::GenerateEmpty()
+{
+	NFABuilder builder;
+	return builder.Build(builder.Empty());
+}
+
+NFA NFA::Union(const NFA& n1, const NFA& n2)
+{
+	NFABuilder builder;
+	NFABuilder::Fragment first = builder.Add(n1);
+	NFABuilder::Fragment second = builder.Add(n2);
+	return builder.Build(builder.Union({ first, second }));
+}
+
+NFA NFA::Union(const std::vector<NFA>& patterns)
+{
+	NFABuilder builder;
+	std::vector<NFABuilder::Fragment> alternatives;
+	std::vector<int> patternFinals;
+	for (const NFA& pattern : patterns)
 	{
-		q.insert(i);
+		alternatives.push_back(builder.Add(pattern));
+		patternFinals.push_back(alternatives.back().end);
 	}
 
-	return NFA(q, transitions, q0, f);
+	return builder.Build(builder.Union(alternatives), patternFinals);
+}
+
+NFA NFA::Concatenate(const NFA& n1, const NFA& n2)
+{
+	NFABuilder builder;
+	NFABuilder::Fragment first = builder.Add(n1);
+	NFABuilder::Fragment second = builder.Add(n2);
+	return builder.Build(builder.Concatenate(first, second));
+}
+
+NFA NFA::KleeneStar(const NFA& n)
+{
+	NFABuilder builder;
+	return builder.Build(builder.KleeneStar(builder.Add(n)));
+}
+
+NFA NFA::Optional(const NFA& n)
+{
+	NFABuilder builder;
+	return builder.Build(builder.Optional(builder.Add(n)));
 }
 
 NFA NFA::OneOrMore(const NFA& n)
 {
-	// return the nfa contatenated with its kleene star
-	return Concatenate(n, KleeneStar(n));
+	NFABuilder builder;
+	return builder.Build(builder.OneOrMore(builder.Add(n)));
 }
 
 std::map<int, std::map<char, std::set<int>>> NFA::MakeTransitionMap(const std::vector<std::tuple<int, char, std::set<int>>>& easyList)
@@ -4,64 +4,270 @@
 #include <set>
 #include <map>
 #include <string>
+#include <utility>
+#include <vector>
 
 class NFA
 {
 private:
+	friend class NFABuilder;
+
 	std::set<int> q;
 	std::map<int, std::map<char, std::set<int>>> transitions;
+	std::map<int, std::set<int>> epsilonTransitions;
 	int q0;
 	int f;
 
+	// one more than the largest state, the size of a set of states stored as a bitset
+	int numIds;
+
+	// the epsilon closure of each state a group can start from, sorted. Empty for other states.
+	std::vector<std::vector<int>> closures;
+
+	// the arrows that consume input leaving each state, copied out of the transition map so
+	// the subset construction can find them without a lookup
+	std::vector<std::vector<std::pair<char, int>>> inputArrows;
+
+	// the id of the pattern whose final state each state is, or -1. Empty unless the NFA
+	// matches several patterns at once, see NFABuilder::Build
+	std::vector<int> patternOf;
+
+	/// <summary>
+	/// Adds every state to the transition map, and calculates numIds and the epsilon closures.
+	/// Called by the constructors once the arrows are set.
+	/// </summary>
+	void ComputeClosures();
+
 	/// <summary>
 	/// Calculates the epsilon closure of a set of states. This is the set of states that can
-	/// be reached from any of the start states if only epsilon arrows are taken.
+	/// be reached from any of the start states if only epsilon arrows are taken. Uses the
+	/// closures calculated by the constructor, so no arrows are followed.
 	/// </summary>
-	/// <param name="starts">The set of start states</param>
-	/// <returns></returns>
-	std::set<int> EpsilonClosure(const std::set<int>& starts);
+	/// <param name="states">The start states, each of which must be the start state of the NFA or the
+	/// destination of an arrow that consumes input. Extended with the rest of the closure, and sorted.</param>
+	/// <param name="inSet">Bitset of the states in the list, indexed by state. Updated with the new states.</param>
+	void EpsilonClosure(std::vector<int>& states, std::vector<bool>& inSet) const;
 
 	/// <summary>
-	/// Copies the transition map of an NFA, but remaps the states to new integer range.
+	/// Appends a group of states to a row of the subset construction table. States already in
+	/// an earlier group of the row are skipped, since the earlier group started first.
 	/// </summary>
-	/// <param name="n">The NFA whose transition map to copy.</param>
-	/// <param name="base">The base of the integer range to remap the staets to. The
-	/// limit of this range will be base + n.num_states</param>
-	/// <param name="outMap">Output parameter that will contain a mapping of states on the input
-	/// NFA to thier remapped state in the copy.</param>
-	/// <param name="outTransitions">Output parameter that will contain the remapped copy of the transition
-	/// map on the original NFA.</param>
-	static void RemapTransitions(const NFA& n, int base, std::map<int, int>& outMap, std::map<int, std::map<char, std::set<int>>>& outTransitions);
+	/// <param name="group">The states to append, sorted</param>
+	/// <param name="seen">Bitset of the states in earlier groups of the row. Updated with the new states.</param>
+	/// <param name="row">The row being built</param>
+	/// <returns>True if the appended group contains the final state</returns>
+	bool AppendGroup(const std::vector<int>& group, std::vector<bool>& seen, std::vector<int>& row) const;
 
 	/// <summary>
-	/// Combines the transition maps of two NFA's into a new one, and remaps their states to ensure
-	/// no duplicate states.
+	/// Appends the epsilon closure of a group to a row, see AppendGroup. The group and its bitset
+	/// are emptied afterwards, so they can be reused for the next group.
 	/// </summary>
-	/// <param name="n1">First of two NFA's to merge</param>
-	/// <param name="n2">Second of two NFA's to merge</param>
-	/// <param name="outM1">Output parameter that will contain a mapping of n1 states to its remapped states</param>
-	/// <param name="outM2">Output parameter that will contain a mapping of n2 states to its remapped states</param>
-	/// <returns>The transition maps of the two input NFA's combined and remapped</returns>
-	static std::map<int, std::map<char, std::set<int>>> CombineTransitions(const NFA& n1, const NFA& n2, std::map<int, int>& outM1, std::map<int, int>& outM2);
+	/// <param name="group">The states the group starts from</param>
+	/// <param name="inGroup">Bitset of the states in the group</param>
+	/// <param name="seen">Bitset of the states in earlier groups of the row. Updated with the new states.</param>
+	/// <param name="row">The row being built</param>
+	/// <returns>True if the appended group contains the final state</returns>
+	bool AppendClosure(std::vector<int>& group, std::vector<bool>& inGroup, std::vector<bool>& seen, std::vector<int>& row) const;
 
 public:
 
+	/// <summary>
+	/// The ways a DFA built from the NFA can run over its input. Stored in row[0] of each row of the
+	/// subset construction table, see StepRow.
+	/// </summary>
+	enum class Search
+	{
+		// only matches from the start of its input, see ConvertToDFA
+		Anchored = 0,
+
+		// searches for the leftmost-longest match, see ConvertToSearchDFA
+		Leftmost = 1,
+
+		// searches for every match of every pattern, see ConvertToPatternDFA
+		EveryMatch = 2,
+	};
+
+private:
+
+	/// <summary>
+	/// Runs the subset construction algorithm
+	/// </summary>
+	/// <param name="search">How the DFA runs over its input</param>
+	/// <param name="maxStates">The construction is abandoned once the DFA has more states than this</param>
+	/// <param name="outDfa">Output parameter that will contain the DFA, if it was built</param>
+	/// <returns>False if the DFA would have more than maxStates states</returns>
+	bool Determinize(Search search, size_t maxStates, DFA& outDfa) const;
+
+public:
+
+	/// <summary>
+	/// Hashes a row of the subset construction table, so rows can be looked up in a hash map
+	/// </summary>
+	struct RowHash
+	{
+		size_t operator()(const std::vector<int>& row) const;
+	};
+
+	/// <summary>
+	/// The bitsets and list StepRow builds each row with. They are kept between calls, and left
+	/// empty by each one, so they are only allocated once rather than for every row. Each thread
+	/// that steps rows needs its own.
+	/// </summary>
+	struct StepScratch
+	{
+		std::vector<bool> seen;
+		std::vector<bool> inGroup;
+		std::vector<int> group;
+	};
+
 	/// <summary>
 	/// Constructs a new NFA
 	/// </summary>
 	/// <param name="q">Set of states in the NFA</param>
 	/// <param name="transitions">The transition map. Double map that should map state+input to the set of states that
-	/// can be reached with that input combination.</param>
+	/// can be reached with that input combination. The input '\0' stands for an epsilon arrow.</param>
 	/// <param name="q0">The start state</param>
 	/// <param name="f">The final state. Only one is allowed.</param>
 	NFA(const std::set<int>& q, const std::map<int, std::map<char, std::set<int>>>& transitions,
 		int q0, int f);
 
+	/// <summary>
+	/// Constructs a new NFA whose epsilon arrows are given separately, so '\0' can be used as an input
+	/// </summary>
+	/// <param name="q">Set of states in the NFA</param>
+	/// <param name="transitions">The transition map. Double map that should map state+input to the set of states that
+	/// can be reached with that input combination.</param>
+	/// <param name="epsilonTransitions">Maps each state to the set of states that can be reached from it without
+	/// consuming input</param>
+	/// <param name="q0">The start state</param>
+	/// <param name="f">The final state. Only one is allowed.</param>
+	NFA(const std::set<int>& q, const std::map<int, std::map<char, std::set<int>>>& transitions,
+		const std::map<int, std::set<int>>& epsilonTransitions, int q0, int f);
+
 	/// <summary>
 	/// Converts the NFA to an equivalent DFA using the subset construction algorithm
 	/// </summary>
 	/// <returns></returns>
-	DFA ConvertToDFA();
+	DFA ConvertToDFA() const;
+
+	/// <summary>
+	/// Converts the NFA to a DFA that searches for matches starting anywhere in its input. The DFA
+	/// enters a final state at each position the leftmost-longest match could end, and enters the dead
+	/// state once no later position can end that match.
+	/// 
+	/// A search from the start of a line must feed the start of the line to the start state before
+	/// anything else, and ignore whether the start state itself is final.
+	/// </summary>
+	/// <returns></returns>
+	DFA ConvertToSearchDFA() const;
+
+	/// <summary>
+	/// Converts the NFA to a DFA like ConvertToDFA, unless the DFA would have too many states. The
+	/// number of states can be exponential in the size of the NFA.
+	/// </summary>
+	/// <param name="maxStates">The most states the DFA may have</param>
+	/// <param name="outDfa">Output parameter that will contain the DFA, if it was built</param>
+	/// <returns>False if the DFA would have more than maxStates states</returns>
+	bool TryConvertToDFA(size_t maxStates, DFA& outDfa) const;
+
+	/// <summary>
+	/// Converts the NFA to a DFA like ConvertToSearchDFA, unless the DFA would have too many states
+	/// </summary>
+	/// <param name="maxStates">The most states the DFA may have</param>
+	/// <param name="outDfa">Output parameter that will contain the DFA, if it was built</param>
+	/// <returns>False if the DFA would have more than maxStates states</returns>
+	bool TryConvertToSearchDFA(size_t maxStates, DFA& outDfa) const;
+
+	/// <summary>
+	/// Converts the NFA to a DFA that searches for every match of every pattern the NFA was built
+	/// from, starting anywhere in its input. The DFA enters a final state at each position where a
+	/// match of any pattern ends, and the state holds the ids of those patterns. It never dies.
+	/// 
+	/// Like ConvertToSearchDFA, a search from the start of a line feeds the start of the line first.
+	/// </summary>
+	/// <returns></returns>
+	DFA ConvertToPatternDFA() const;
+
+	/// <summary>
+	/// Converts the NFA to a DFA like ConvertToPatternDFA, unless the DFA would have too many states
+	/// </summary>
+	/// <param name="maxStates">The most states the DFA may have</param>
+	/// <param name="outDfa">Output parameter that will contain the DFA, if it was built</param>
+	/// <returns>False if the DFA would have more than maxStates states</returns>
+	bool TryConvertToPatternDFA(size_t maxStates, DFA& outDfa) const;
+
+	/// <summary>
+	/// Returns every input that labels an arrow, not counting epsilon arrows
+	/// </summary>
+	/// <returns></returns>
+	std::set<char> Inputs() const;
+
+	/// <summary>
+	/// Returns the first row of the subset construction table, see StepRow
+	/// </summary>
+	/// <param name="search">How the DFA runs over its input</param>
+	/// <returns></returns>
+	std::vector<int> StartRow(Search search) const;
+
+	/// <summary>
+	/// Returns the row an unanchored search reaches from its first row at the start of a line.
+	/// Used instead of StepRow for that one transition, see ConvertToSearchDFA.
+	/// </summary>
+	/// <returns></returns>
+	std::vector<int> LineStartRow() const;
+
+	/// <summary>
+	/// Calculates the next row of the subset construction table for an input.
+	/// 
+	/// A row is a list of groups of states, in the order the threads in them started consuming input.
+	/// Row[0] is nonzero if a new group should be started after every input (an unanchored search), and
+	/// every group after that is terminated by -1. Once a group contains the final state, the groups
+	/// after it and any new groups can only produce matches that start later, so they are dropped. This
+	/// gives leftmost-longest match semantics.
+	/// 
+	/// A row of a Search::EveryMatch DFA has a single group instead, holding every thread. Nothing is
+	/// dropped and a new thread is started after every input, so every match of every pattern is seen.
+	/// </summary>
+	/// <param name="row">The current row</param>
+	/// <param name="input">The input. Regex::ANY stands in for any byte with no explicit arrow.</param>
+	/// <returns>The next row. Has no groups if no state can be reached.</returns>
+	std::vector<int> StepRow(const std::vector<int>& row, char input) const;
+
+	/// <summary>
+	/// Calculates the next row of the subset construction table for an input, see StepRow
+	/// </summary>
+	/// <param name="row">The current row</param>
+	/// <param name="input">The input</param>
+	/// <param name="scratch">Space to build the row in, reused from the last call</param>
+	/// <returns>The next row</returns>
+	std::vector<int> StepRow(const std::vector<int>& row, char input, StepScratch& scratch) const;
+
+	/// <summary>
+	/// Returns true if no state can be reached from a row, and no new group will be started
+	/// </summary>
+	/// <param name="row"></param>
+	/// <returns></returns>
+	bool IsDeadRow(const std::vector<int>& row) const;
+
+	/// <summary>
+	/// Returns true if a row contains the final state
+	/// </summary>
+	/// <param name="row"></param>
+	/// <returns></returns>
+	bool IsFinalRow(const std::vector<int>& row) const;
+
+	/// <summary>
+	/// Returns the ids of the patterns whose final states are in a row, sorted
+	/// </summary>
+	/// <param name="row"></param>
+	/// <returns>Empty if the NFA was not built from several patterns</returns>
+	std::vector<int> RowPatterns(const std::vector<int>& row) const;
+
+	/// <summary>
+	/// Generates an NFA that accepts the reverse of every string this NFA accepts
+	/// </summary>
+	/// <returns></returns>
+	NFA Reverse() const;
 
 	/// <summary>
 	/// Returns the number of unique states in this NFA
@@ -90,6 +296,14 @@ public:
 	/// <returns></returns>
 	static NFA Union(const NFA& n1, const NFA& n2);
 
+	/// <summary>
+	/// Generates an NFA that accepts the input of any of the patterns. The final state of each
+	/// pattern is kept, so a DFA built with ConvertToPatternDFA can tell which patterns matched.
+	/// </summary>
+	/// <param name="patterns">At least one NFA. The id of each is its index in the list.</param>
+	/// <returns></returns>
+	static NFA Union(const std::vector<NFA>& patterns);
+
 	/// <summary>
 	/// Generates an NFA that accepts the input of n1 followed by the
 	/// input of n2
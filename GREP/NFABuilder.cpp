@@ -0,0 +1,224 @@
+#include "NFABuilder.h"
+
+int NFABuilder::AddState()
+{
+	arrows.emplace_back();
+	epsilonArrows.emplace_back();
+	return (int)arrows.size() - 1;
+}
+
+NFABuilder::Fragment NFABuilder::AddFragment()
+{
+	int start = AddState();
+	int end = AddState();
+	return { start, end };
+}
+
+NFABuilder::Fragment NFABuilder::Single(char input)
+{
+	Fragment single = AddFragment();
+	arrows[single.start].emplace_back(input, single.end);
+	return single;
+}
+
+NFABuilder::Fragment NFABuilder::Empty()
+{
+	Fragment empty = AddFragment();
+	epsilonArrows[empty.start].push_back(empty.end);
+	return empty;
+}
+
+NFABuilder::Fragment NFABuilder::Concatenate(Fragment first, Fragment second)
+{
+	// add epsilon transition from final state of first to start state of second
+	epsilonArrows[first.end].push_back(second.start);
+	return { first.start, second.end };
+}
+
+NFABuilder::Fragment NFABuilder::Union(const std::vector<Fragment>& alternatives)
+{
+	Fragment both = AddFragment();
+
+	// add epsilon arrows from the new start state to each alternative, and from each
+	// alternative to the new final state
+	for (Fragment alternative : alternatives)
+	{
+		epsilonArrows[both.start].push_back(alternative.start);
+		epsilonArrows[alternative.end].push_back(both.end);
+	}
+
+	return both;
+}
+
+NFABuilder::Fragment NFABuilder::KleeneStar(Fragment n)
+{
+	Fragment star = AddFragment();
+
+	// add epsilon arrows from the new start state to n start and the new final state
+	epsilonArrows[star.start].push_back(n.start);
+	epsilonArrows[star.start].push_back(star.end);
+
+	// add epsilon arrows from n end to n start and the new final state
+	epsilonArrows[n.end].push_back(n.start);
+	epsilonArrows[n.end].push_back(star.end);
+
+	return star;
+}
+
+NFABuilder::Fragment NFABuilder::Optional(Fragment n)
+{
+	Fragment optional = AddFragment();
+
+	// the new start state either enters n or skips it
+	epsilonArrows[optional.start].push_back(n.start);
+	epsilonArrows[optional.start].push_back(optional.end);
+	epsilonArrows[n.end].push_back(optional.end);
+
+	return optional;
+}
+
+NFABuilder::Fragment NFABuilder::OneOrMore(Fragment n)
+{
+	Fragment plus = AddFragment();
+
+	// like KleeneStar, but n can not be skipped
+	epsilonArrows[plus.start].push_back(n.start);
+	epsilonArrows[n.end].push_back(n.start);
+	epsilonArrows[n.end].push_back(plus.end);
+
+	return plus;
+}
+
+NFABuilder::Fragment NFABuilder::Add(const Ast& ast, int node)
+{
+	const Ast::Node& n = ast.GetNode(node);
+	switch (n.kind)
+	{
+	case Ast::Kind::Empty:
+		return Empty();
+
+	case Ast::Kind::Char:
+		return Single(n.input);
+
+	case Ast::Kind::Concatenate:
+	{
+		Fragment sequence = Add(ast, ast.Child(node, 0));
+		for (int i = 1; i < n.numChildren; ++i)
+		{
+			sequence = Concatenate(sequence, Add(ast, ast.Child(node, i)));
+		}
+		return sequence;
+	}
+
+	case Ast::Kind::Union:
+	{
+		std::vector<Fragment> alternatives;
+		for (int i = 0; i < n.numChildren; ++i)
+		{
+			alternatives.push_back(Add(ast, ast.Child(node, i)));
+		}
+		return Union(alternatives);
+	}
+
+	case Ast::Kind::KleeneStar:
+		return KleeneStar(Add(ast, ast.Child(node, 0)));
+
+	case Ast::Kind::OneOrMore:
+		return OneOrMore(Add(ast, ast.Child(node, 0)));
+
+	default:
+		return Optional(Add(ast, ast.Child(node, 0)));
+	}
+}
+
+NFABuilder::Fragment NFABuilder::Add(const NFA& nfa)
+{
+	// give every state of the NFA a new number, including those only referenced by arrows
+	std::vector<int> map(nfa.numIds, -1);
+	auto remap = [&](int state) {
+		if (map[state] == -1)
+		{
+			map[state] = AddState();
+		}
+		return map[state];
+	};
+
+	for (int state : nfa.q)
+	{
+		remap(state);
+	}
+
+	for (auto& stateIt : nfa.transitions)
+	{
+		int start = remap(stateIt.first);
+		for (auto& transitionIt : stateIt.second)
+		{
+			for (int destination : transitionIt.second)
+			{
+				int end = remap(destination);
+				arrows[start].emplace_back(transitionIt.first, end);
+			}
+		}
+	}
+
+	for (auto& stateIt : nfa.epsilonTransitions)
+	{
+		int start = remap(stateIt.first);
+		for (int destination : stateIt.second)
+		{
+			int end = remap(destination);
+			epsilonArrows[start].push_back(end);
+		}
+	}
+
+	int start = remap(nfa.q0);
+	int end = remap(nfa.f);
+	return { start, end };
+}
+
+NFA NFABuilder::Build(Fragment fragment, const std::vector<int>& patternFinals) const
+{
+	std::set<int> q;
+	std::map<int, std::map<char, std::set<int>>> transitions;
+	std::map<int, std::set<int>> epsilonTransitions;
+
+	// states are added in order, so each insert goes at the end of its container
+	for (int state = 0; state < NumStates(); ++state)
+	{
+		q.emplace_hint(q.end(), state);
+
+		if (!arrows[state].empty())
+		{
+			std::map<char, std::set<int>>& stateTransitions =
+				transitions.emplace_hint(transitions.end(), state, std::map<char, std::set<int>>())->second;
+			for (auto& arrow : arrows[state])
+			{
+				stateTransitions[arrow.first].insert(arrow.second);
+			}
+		}
+
+		if (!epsilonArrows[state].empty())
+		{
+			epsilonTransitions.emplace_hint(epsilonTransitions.end(), state,
+				std::set<int>(epsilonArrows[state].begin(), epsilonArrows[state].end()));
+		}
+	}
+
+	NFA nfa(q, transitions, epsilonTransitions, fragment.start, fragment.end);
+
+	if (!patternFinals.empty())
+	{
+		nfa.patternOf.assign(nfa.numIds, -1);
+		for (int pattern = 0; pattern < (int)patternFinals.size(); ++pattern)
+		{
+			nfa.patternOf[patternFinals[pattern]] = pattern;
+		}
+	}
+
+	return nfa;
+}
+
+int NFABuilder::NumStates() const
+{
+	return (int)arrows.size();
+}
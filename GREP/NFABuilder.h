@@ -0,0 +1,129 @@
+#pragma once
+#include "Ast.h"
+#include "NFA.h"
+
+#include <utility>
+#include <vector>
+
+/// <summary>
+/// Builds an NFA with Thompson's construction. Every state goes into one graph that grows as the
+/// expression is parsed, and pieces of the expression are joined by adding arrows between their
+/// states, so building an NFA takes time linear in the size of the expression.
+/// </summary>
+class NFABuilder
+{
+public:
+
+	/// <summary>
+	/// A piece of the graph with one start state and one final state, which the rest of the
+	/// graph has no arrows into or out of yet
+	/// </summary>
+	struct Fragment
+	{
+		int start;
+		int end;
+	};
+
+private:
+
+	// the arrows that consume input, and the epsilon arrows, leaving each state
+	std::vector<std::vector<std::pair<char, int>>> arrows;
+	std::vector<std::vector<int>> epsilonArrows;
+
+	/// <summary>
+	/// Adds a state with no arrows to the graph
+	/// </summary>
+	/// <returns>The new state</returns>
+	int AddState();
+
+	/// <summary>
+	/// Adds a fragment made of a new start and final state
+	/// </summary>
+	/// <returns></returns>
+	Fragment AddFragment();
+
+public:
+
+	/// <summary>
+	/// Adds a fragment that accepts a single character
+	/// </summary>
+	/// <param name="input">The character to accept</param>
+	/// <returns></returns>
+	Fragment Single(char input);
+
+	/// <summary>
+	/// Adds a fragment that accepts the empty string
+	/// </summary>
+	/// <returns></returns>
+	Fragment Empty();
+
+	/// <summary>
+	/// Joins two fragments into one that accepts the input of first followed by the input
+	/// of second. Adds no states.
+	/// </summary>
+	/// <param name="first"></param>
+	/// <param name="second"></param>
+	/// <returns></returns>
+	Fragment Concatenate(Fragment first, Fragment second);
+
+	/// <summary>
+	/// Joins fragments into one that accepts the input of any of them. Every alternative hangs
+	/// off the same new start state, so a long list of alternatives does not nest.
+	/// </summary>
+	/// <param name="alternatives">At least one fragment</param>
+	/// <returns></returns>
+	Fragment Union(const std::vector<Fragment>& alternatives);
+
+	/// <summary>
+	/// Wraps a fragment into one that accepts its input repeated 0 or more times
+	/// </summary>
+	/// <param name="n"></param>
+	/// <returns></returns>
+	Fragment KleeneStar(Fragment n);
+
+	/// <summary>
+	/// Wraps a fragment into one that accepts its input repeated 0 or one times
+	/// </summary>
+	/// <param name="n"></param>
+	/// <returns></returns>
+	Fragment Optional(Fragment n);
+
+	/// <summary>
+	/// Wraps a fragment into one that accepts its input repeated one or more times. The
+	/// fragment is looped back on itself rather than copied.
+	/// </summary>
+	/// <param name="n"></param>
+	/// <returns></returns>
+	Fragment OneOrMore(Fragment n);
+
+	/// <summary>
+	/// Adds the fragment for a node of a syntax tree, and the nodes below it
+	/// </summary>
+	/// <param name="ast"></param>
+	/// <param name="node"></param>
+	/// <returns></returns>
+	Fragment Add(const Ast& ast, int node);
+
+	/// <summary>
+	/// Copies an NFA into the graph
+	/// </summary>
+	/// <param name="nfa"></param>
+	/// <returns>The fragment for the copy</returns>
+	Fragment Add(const NFA& nfa);
+
+	/// <summary>
+	/// Creates an NFA from the graph, with the start and final state of a fragment. Every state
+	/// in the graph is included, even those the fragment can not reach.
+	/// </summary>
+	/// <param name="fragment"></param>
+	/// <param name="patternFinals">For an NFA that matches several patterns at once, the final
+	/// state of each pattern's fragment, indexed by the id of the pattern</param>
+	/// <returns></returns>
+	NFA Build(Fragment fragment, const std::vector<int>& patternFinals = {}) const;
+
+	/// <summary>
+	/// Returns the number of states in the graph
+	/// </summary>
+	/// <returns></returns>
+	int NumStates() const;
+};
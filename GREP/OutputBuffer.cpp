@@ -0,0 +1,235 @@
+#include "OutputBuffer.h"
+#include <cctype>
+
+#ifdef _WIN32
+#include <algorithm>
+#include <climits>
+#include <io.h>
+#else
+#include <cerrno>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+OutputBuffer::OutputBuffer(Highlight highlight)
+	: highlight(highlight)
+{ }
+
+void OutputBuffer::Add(std::string_view bytes)
+{
+	if (bytes.empty())
+	{
+		return;
+	}
+
+	// copies that follow each other are one piece
+	if (!pieces.empty() && pieces.back().data == nullptr && pieces.back().offset + pieces.back().size == text.size())
+	{
+		pieces.back().size += bytes.size();
+	}
+	else
+	{
+		pieces.push_back({ nullptr, text.size(), bytes.size() });
+	}
+
+	text.append(bytes);
+	size += bytes.size();
+}
+
+void OutputBuffer::AddInPlace(std::string_view bytes)
+{
+	if (bytes.empty())
+	{
+		return;
+	}
+
+	// lines that follow each other in the input are one piece
+	if (!pieces.empty() && pieces.back().data != nullptr && pieces.back().data + pieces.back().size == bytes.data())
+	{
+		pieces.back().size += bytes.size();
+	}
+	else if (bytes.size() < MIN_IN_PLACE_SIZE)
+	{
+		Add(bytes);
+		return;
+	}
+	else
+	{
+		pieces.push_back({ bytes.data(), 0, bytes.size() });
+	}
+
+	size += bytes.size();
+}
+
+void OutputBuffer::AddLine(std::string_view line, bool hasNewline, const std::vector<Regex::Span>& matches)
+{
+	if (highlight == Highlight::UpperCase)
+	{
+		size_t lineStart = text.size();
+		Add(line);
+		for (const Regex::Span& match : matches)
+		{
+			for (size_t i = lineStart + match.offset; i < lineStart + match.offset + match.length; ++i)
+			{
+				text[i] = (char)std::toupper((unsigned char)text[i]);
+			}
+		}
+
+		Add("\n");
+		return;
+	}
+
+	// the line is written from the input, with the escapes between its pieces
+	size_t position = 0;
+	if (highlight == Highlight::Color)
+	{
+		for (const Regex::Span& match : matches)
+		{
+			AddInPlace(line.substr(position, match.offset - position));
+			Add(COLOR_START);
+			AddInPlace(line.substr(match.offset, match.length));
+			Add(COLOR_END);
+			position = match.offset + match.length;
+		}
+	}
+
+	// the last line of a file may not have a newline
+	if (hasNewline)
+	{
+		AddInPlace(std::string_view(line.data() + position, line.size() - position + 1));
+	}
+	else
+	{
+		AddInPlace(line.substr(position));
+		Add("\n");
+	}
+}
+
+void OutputBuffer::Keep()
+{
+	// only the pieces in the input are copied, to the end of text, so keeping the buffer after
+	// each block of a file costs no more than the bytes added since the last time. A piece that
+	// ends up right after the one before it in text is joined to it
+	size_t kept = 0;
+	for (size_t i = 0; i < pieces.size(); ++i)
+	{
+		Piece piece = pieces[i];
+		if (piece.data != nullptr)
+		{
+			size_t offset = text.size();
+			text.append(piece.data, piece.size);
+			piece = { nullptr, offset, piece.size };
+		}
+
+		if (kept > 0 && pieces[kept - 1].offset + pieces[kept - 1].size == piece.offset)
+		{
+			pieces[kept - 1].size += piece.size;
+		}
+		else
+		{
+			pieces[kept++] = piece;
+		}
+	}
+
+	pieces.resize(kept);
+}
+
+void OutputBuffer::Clear()
+{
+	pieces.clear();
+	text.clear();
+	size = 0;
+}
+
+std::string OutputBuffer::ToString() const
+{
+	std::string bytes;
+	bytes.reserve(size);
+	for (const Piece& piece : pieces)
+	{
+		bytes.append(Data(piece), piece.size);
+	}
+
+	return bytes;
+}
+
+#ifdef _WIN32
+
+bool OutputBuffer::WriteTo(int fd)
+{
+	// there is no writev, so the pieces are gathered into one write
+	std::string bytes = ToString();
+	Clear();
+
+	size_t written = 0;
+	while (written < bytes.size())
+	{
+		int count = _write(fd, bytes.data() + written, (unsigned int)std::min(bytes.size() - written, (size_t)INT_MAX));
+		if (count <= 0)
+		{
+			return false;
+		}
+		written += count;
+	}
+
+	return true;
+}
+
+bool OutputBuffer::IsTerminal(int fd)
+{
+	return _isatty(fd) != 0;
+}
+
+#else
+
+bool OutputBuffer::WriteTo(int fd)
+{
+	iovec vectors[MAX_VECTORS];
+
+	// the first byte that has not been written yet
+	size_t piece = 0;
+	size_t offset = 0;
+
+	bool result = true;
+	while (piece < pieces.size())
+	{
+		int count = 0;
+		for (size_t i = piece; i < pieces.size() && count < MAX_VECTORS; ++i, ++count)
+		{
+			size_t skipped = i == piece ? offset : 0;
+			vectors[count].iov_base = (void*)(Data(pieces[i]) + skipped);
+			vectors[count].iov_len = pieces[i].size - skipped;
+		}
+
+		ssize_t written = writev(fd, vectors, count);
+		if (written < 0 && errno == EINTR)
+		{
+			continue;
+		}
+		else if (written <= 0)
+		{
+			result = false;
+			break;
+		}
+
+		// a pipe can take fewer bytes than were given, so carry on from the first one it did not take
+		size_t left = (size_t)written;
+		while (piece < pieces.size() && left >= pieces[piece].size - offset)
+		{
+			left -= pieces[piece].size - offset;
+			piece++;
+			offset = 0;
+		}
+		offset += left;
+	}
+
+	Clear();
+	return result;
+}
+
+bool OutputBuffer::IsTerminal(int fd)
+{
+	return isatty(fd) != 0;
+}
+
+#endif
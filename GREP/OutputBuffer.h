@@ -0,0 +1,154 @@
+#pragma once
+#include "Regex.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+/// <summary>
+/// Collects the output of a search as a list of pieces to write in one go. Matching lines are not
+/// copied: a piece points at the line where it lies in the input, so the input must stay where it
+/// is until the buffer is written. Only the text added around the lines, such as file names and
+/// highlighting, is copied into a buffer of its own, which keeps its memory when it is cleared.
+/// </summary>
+class OutputBuffer
+{
+public:
+
+	/// <summary>
+	/// How the matches in a line are shown
+	/// </summary>
+	enum class Highlight
+	{
+		// the line is written as it is
+		None,
+
+		// each match is wrapped in ANSI escapes that color it red on a terminal
+		Color,
+
+		// each match is written in upper case, which needs the line to be copied
+		UpperCase
+	};
+
+	// the escapes written around each match with Highlight::Color, the same as GNU grep's
+	static constexpr const char* COLOR_START = "\x1b[01;31m\x1b[K";
+	static constexpr const char* COLOR_END = "\x1b[m\x1b[K";
+
+	// the file descriptor of standard output
+	static const int STDOUT = 1;
+
+private:
+
+	// the most pieces handed to each call to writev
+	static const int MAX_VECTORS = 1024;
+
+	// ranges shorter than this are copied, since writing them as pieces of their own costs more
+	// than copying them
+	static const size_t MIN_IN_PLACE_SIZE = 256;
+
+	/// <summary>
+	/// A range of bytes to write, either in the input or in text
+	/// </summary>
+	struct Piece
+	{
+		// the bytes in the input, or nullptr if they are in text
+		const char* data;
+
+		// where the bytes start in text, if they are there
+		size_t offset;
+
+		size_t size;
+	};
+
+	Highlight highlight;
+
+	std::vector<Piece> pieces;
+
+	// the bytes that were copied rather than pointed at
+	std::string text;
+
+	// the number of bytes in all of the pieces
+	size_t size = 0;
+
+	/// <summary>
+	/// Returns the first byte of a piece
+	/// </summary>
+	/// <param name="piece"></param>
+	/// <returns></returns>
+	const char* Data(const Piece& piece) const { return piece.data != nullptr ? piece.data : text.data() + piece.offset; }
+
+public:
+
+	/// <summary>
+	/// Creates an empty buffer
+	/// </summary>
+	/// <param name="highlight">How the matches in each line are shown</param>
+	OutputBuffer(Highlight highlight = Highlight::None);
+
+	/// <summary>
+	/// Returns the number of bytes the buffer would write
+	/// </summary>
+	/// <returns></returns>
+	size_t Size() const { return size; }
+
+	/// <summary>
+	/// Returns true if the buffer would write nothing
+	/// </summary>
+	/// <returns></returns>
+	bool Empty() const { return size == 0; }
+
+	/// <summary>
+	/// Adds text that is copied into the buffer
+	/// </summary>
+	/// <param name="bytes"></param>
+	void Add(std::string_view bytes);
+
+	/// <summary>
+	/// Adds bytes that are written from where they lie, which must not change until the buffer is
+	/// written or Keep is called. A range that follows on from the last one is joined to it, and
+	/// a short one is copied.
+	/// </summary>
+	/// <param name="bytes"></param>
+	void AddInPlace(std::string_view bytes);
+
+	/// <summary>
+	/// Adds a matching line followed by a newline, with its matches highlighted
+	/// </summary>
+	/// <param name="line">The line, without its newline, which is pointed at rather than copied
+	/// unless its matches are shown in upper case</param>
+	/// <param name="hasNewline">True if the line is followed by a newline in the input, which is then
+	/// pointed at too</param>
+	/// <param name="matches">The matches in the line, in order</param>
+	void AddLine(std::string_view line, bool hasNewline, const std::vector<Regex::Span>& matches);
+
+	/// <summary>
+	/// Copies the bytes the buffer points at into it, so the input they are in can go away
+	/// </summary>
+	void Keep();
+
+	/// <summary>
+	/// Empties the buffer, keeping its memory
+	/// </summary>
+	void Clear();
+
+	/// <summary>
+	/// Returns the bytes the buffer would write
+	/// </summary>
+	/// <returns></returns>
+	std::string ToString() const;
+
+	/// <summary>
+	/// Writes the buffer to a file with as few system calls as it can, gathering the pieces with
+	/// writev where there is one, then empties it
+	/// </summary>
+	/// <param name="fd">The file descriptor to write to</param>
+	/// <returns>False if the write failed, for example because the reader of a pipe has gone</returns>
+	bool WriteTo(int fd);
+
+	/// <summary>
+	/// Returns true if a file descriptor is a terminal, where highlighting is shown by default
+	/// </summary>
+	/// <param name="fd"></param>
+	/// <returns></returns>
+	static bool IsTerminal(int fd);
+};
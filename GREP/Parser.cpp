@@ -0,0 +1,159 @@
+#include "Parser.h"
+#include "Regex.h"
+
+ParseError::ParseError(const std::string& message, size_t position)
+	: std::invalid_argument(message), position(position)
+{ }
+
+Parser::Parser(const std::string& text)
+	: text(text), position(0), depth(0)
+{ }
+
+Ast Parser::Parse(const std::string& text)
+{
+	Parser parser(text);
+	int root = parser.ParseUnion();
+
+	// the top level only stops early at a ) that closes nothing
+	if (parser.position < text.size())
+	{
+		throw ParseError("unmatched )", parser.position);
+	}
+
+	parser.ast.SetRoot(root);
+	return std::move(parser.ast);
+}
+
+int Parser::AddPending(Ast::Kind kind, size_t start)
+{
+	int node = pending.size() - start == 1 ?
+		pending.back() :
+		ast.AddNode(kind, pending.data() + start, (int)(pending.size() - start));
+
+	pending.resize(start);
+	return node;
+}
+
+int Parser::ParseUnion()
+{
+	size_t start = pending.size();
+
+	int alternative = ParseConcatenation();
+	pending.push_back(alternative);
+	while (position < text.size() && text[position] == '|')
+	{
+		++position;
+		alternative = ParseConcatenation();
+		pending.push_back(alternative);
+	}
+
+	return AddPending(Ast::Kind::Union, start);
+}
+
+int Parser::ParseConcatenation()
+{
+	size_t start = pending.size();
+
+	while (position < text.size() && text[position] != '|' && text[position] != ')')
+	{
+		int piece = ParseRepetition();
+		pending.push_back(piece);
+	}
+
+	// an empty alternative, or an empty group, matches the empty string
+	if (pending.size() == start)
+	{
+		return ast.AddLeaf(Ast::Kind::Empty);
+	}
+
+	return AddPending(Ast::Kind::Concatenate, start);
+}
+
+int Parser::ParseRepetition()
+{
+	int atom = ParseAtom();
+
+	bool isRepeated = false;
+	Ast::Kind repetition = Ast::Kind::KleeneStar;
+	while (position < text.size())
+	{
+		Ast::Kind kind;
+		if (text[position] == '*')
+		{
+			kind = Ast::Kind::KleeneStar;
+		}
+		else if (text[position] == '+')
+		{
+			kind = Ast::Kind::OneOrMore;
+		}
+		else if (text[position] == '?')
+		{
+			kind = Ast::Kind::Optional;
+		}
+		else
+		{
+			break;
+		}
+
+		// repeating a repetition gives another one, x** is x*, x++ is x+, x?? is x? and any
+		// mix of operators is x*. The tree stays shallow however many operators there are.
+		repetition = !isRepeated || kind == repetition ? kind : Ast::Kind::KleeneStar;
+		isRepeated = true;
+		++position;
+	}
+
+	return isRepeated ? ast.AddNode(repetition, &atom, 1) : atom;
+}
+
+int Parser::ParseAtom()
+{
+	size_t start = position;
+	char input = text[position++];
+
+	if (input == '(')
+	{
+		if (++depth > MAX_DEPTH)
+		{
+			throw ParseError("too many nested groups", start);
+		}
+
+		int group = ParseUnion();
+
+		// the alternatives stop at the ) that closes the group, or at the end of the text
+		if (position >= text.size())
+		{
+			throw ParseError("missing ) to close (", start);
+		}
+
+		++position;
+		--depth;
+		return group;
+	}
+	else if (input == '*' || input == '+' || input == '?')
+	{
+		throw ParseError(std::string("nothing to repeat before ") + input, start);
+	}
+	else if (input == '^')
+	{
+		input = Regex::LINE_START;
+	}
+	else if (input == '$')
+	{
+		input = Regex::LINE_END;
+	}
+	else if (input == '.')
+	{
+		input = Regex::ANY;
+	}
+	else if (input == '\\')
+	{
+		if (position >= text.size())
+		{
+			throw ParseError("nothing to escape after \\", start);
+		}
+
+		input = text[position++];
+	}
+
+	return ast.AddLeaf(Ast::Kind::Char, input);
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include "Ast.h"
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// Thrown when a regular expression is not valid
+/// </summary>
+class ParseError : public std::invalid_argument
+{
+private:
+	size_t position;
+
+public:
+
+	/// <summary>
+	/// Creates an error
+	/// </summary>
+	/// <param name="message">What is wrong, without the position</param>
+	/// <param name="position">The offset into the regular expression where the problem is</param>
+	ParseError(const std::string& message, size_t position);
+
+	size_t Position() const { return position; }
+};
+
+/// <summary>
+/// Parses a regular expression into an Ast with recursive descent. The expression is read once
+/// from start to end, so parsing takes time linear in its length.
+/// </summary>
+class Parser
+{
+private:
+
+	// the most parenthesis groups that may be nested inside each other, which keeps the
+	// recursion of the parser and of the passes over the tree within the stack
+	static const int MAX_DEPTH = 1000;
+
+	const std::string& text;
+	size_t position;
+	int depth;
+	Ast ast;
+
+	// scratch space for the children of the nodes being parsed, shared by every level of the
+	// recursion. Each level uses the part after the entries that were there when it started.
+	std::vector<int> pending;
+
+	Parser(const std::string& text);
+
+	/// <summary>
+	/// Parses alternatives separated by |, up to a ) or the end of the text
+	/// </summary>
+	/// <returns>The node for the alternatives</returns>
+	int ParseUnion();
+
+	/// <summary>
+	/// Parses a sequence of repeated atoms, up to a |, a ) or the end of the text
+	/// </summary>
+	/// <returns>The node for the sequence</returns>
+	int ParseConcatenation();
+
+	/// <summary>
+	/// Parses an atom followed by any number of *, + and ? operators
+	/// </summary>
+	/// <returns>The node for the repeated atom</returns>
+	int ParseRepetition();
+
+	/// <summary>
+	/// Parses a character, an escaped character, a special character, or a parenthesis group
+	/// </summary>
+	/// <returns>The node for the atom</returns>
+	int ParseAtom();
+
+	/// <summary>
+	/// Adds a node with the entries of pending after start as its children, and removes them
+	/// from pending. A node with one child is not needed, so the child is returned instead.
+	/// </summary>
+	/// <param name="kind">Concatenate or Union</param>
+	/// <param name="start">The number of entries in pending that belong to enclosing levels</param>
+	/// <returns></returns>
+	int AddPending(Ast::Kind kind, size_t start);
+
+public:
+
+	/// <summary>
+	/// Parses a regular expression
+	/// </summary>
+	/// <param name="text">The regular expression</param>
+	/// <returns>The syntax tree</returns>
+	/// <exception cref="ParseError">The regular expression is not valid</exception>
+	static Ast Parse(const std::string& text);
+};
@@ -1,196 +1,851 @@
 #include "Regex.h"
-#include <string_view>
+#include "AhoCorasick.h"
+#include "BinaryReader.h"
+#include "BinaryWriter.h"
+#include "Parser.h"
+#include <algorithm>
 
 Regex::Regex()
-	: nfa(NFA::GenerateEmpty()), dfa(DFA::GenerateEmpty())
+	: nfa(NFA::GenerateEmpty()), searchDfa(DFA::GenerateEmpty()), reverseDfa(DFA::GenerateEmpty()),
+	patternDfa(DFA::GenerateEmpty())
 { }
 
-NFA Regex::CheckOperators(const NFA& nfa, char nextChar, int& outNumSkipped)
+static const std::string& Longest(const std::string& first, const std::string& second)
 {
-	if (nextChar == '*')
+	return second.size() > first.size() ? second : first;
+}
+
+Regex::Literals Regex::ConcatenateLiterals(const Literals& first, const Literals& second)
+{
+	Literals literals;
+	literals.isExact = first.isExact && second.isExact;
+	literals.exact = literals.isExact ? first.exact + second.exact : "";
+
+	// a prefix or suffix extends into the other expression if that one is exact
+	literals.prefix = first.isExact ? first.exact + second.prefix : first.prefix;
+	literals.suffix = second.isExact ? first.suffix + second.exact : second.suffix;
+
+	// the text that crosses from the first expression into the second is also required
+	literals.required = Longest(Longest(first.required, second.required), first.suffix + second.prefix);
+	literals.required = Longest(literals.required, Longest(literals.prefix, literals.suffix));
+
+	return literals;
+}
+
+Regex::Literals Regex::UnionLiterals(const Literals& first, const Literals& second)
+{
+	Literals literals;
+	literals.isExact = first.isExact && second.isExact && first.exact == second.exact;
+	literals.exact = literals.isExact ? first.exact : "";
+
+	// only text that both sides share is known
+	size_t prefixLength = 0;
+	while (prefixLength < first.prefix.size() && prefixLength < second.prefix.size() &&
+		first.prefix[prefixLength] == second.prefix[prefixLength])
+	{
+		++prefixLength;
+	}
+	literals.prefix = first.prefix.substr(0, prefixLength);
+
+	size_t suffixLength = 0;
+	while (suffixLength < first.suffix.size() && suffixLength < second.suffix.size() &&
+		first.suffix[first.suffix.size() - suffixLength - 1] == second.suffix[second.suffix.size() - suffixLength - 1])
+	{
+		++suffixLength;
+	}
+	literals.suffix = first.suffix.substr(first.suffix.size() - suffixLength);
+
+	literals.required = Longest(literals.prefix, literals.suffix);
+
+	return literals;
+}
+
+Regex::Literals Regex::FindLiterals(const Ast& ast, int node)
+{
+	const Ast::Node& n = ast.GetNode(node);
+	switch (n.kind)
+	{
+	case Ast::Kind::Empty:
+		// the empty expression matches exactly ""
+		return { true, "", "", "", "" };
+
+	case Ast::Kind::Char:
 	{
-		outNumSkipped = 1;
-		return NFA::KleeneStar(nfa);
+		// the line markers match no text, and the wildcard matches unknown text
+		Literals literals = { n.input != ANY, "", "", "", "" };
+		if (n.input != ANY && n.input != LINE_START && n.input != LINE_END)
+		{
+			literals.exact = literals.prefix = literals.suffix = literals.required = std::string(1, n.input);
+		}
+		return literals;
 	}
-	else if (nextChar == '+')
+
+	case Ast::Kind::Concatenate:
 	{
-		outNumSkipped = 1;
-		return NFA::OneOrMore(nfa);
+		// runs of plain characters are joined before they are concatenated, so a long literal
+		// is not copied once for each of its characters
+		Literals literals = { true, "", "", "", "" };
+		std::string run;
+		for (int i = 0; i < n.numChildren; ++i)
+		{
+			const Ast::Node& child = ast.GetNode(ast.Child(node, i));
+			if (child.kind == Ast::Kind::Char && child.input != ANY && child.input != LINE_START && child.input != LINE_END)
+			{
+				run += child.input;
+				continue;
+			}
+
+			if (!run.empty())
+			{
+				literals = ConcatenateLiterals(literals, { true, run, run, run, run });
+				run.clear();
+			}
+			literals = ConcatenateLiterals(literals, FindLiterals(ast, ast.Child(node, i)));
+		}
+
+		if (!run.empty())
+		{
+			literals = ConcatenateLiterals(literals, { true, run, run, run, run });
+		}
+		return literals;
+	}
+
+	case Ast::Kind::Union:
+	{
+		Literals literals = FindLiterals(ast, ast.Child(node, 0));
+		for (int i = 1; i < n.numChildren; ++i)
+		{
+			literals = UnionLiterals(literals, FindLiterals(ast, ast.Child(node, i)));
+		}
+		return literals;
 	}
-	else if (nextChar == '?')
+
+	case Ast::Kind::OneOrMore:
 	{
-		outNumSkipped = 1;
-		return NFA::Optional(nfa);
+		// one or more copies still contains everything one copy does
+		Literals literals = FindLiterals(ast, ast.Child(node, 0));
+		literals.isExact = false;
+		literals.exact.clear();
+		return literals;
 	}
 
-	outNumSkipped = 0;
-	return nfa;
+	default:
+		// the repeated text may not be there at all
+		return { false, "", "", "", "" };
+	}
 }
 
-NFA Regex::ParseExpression(const std::string& text, int& outLen)
+bool Regex::FindAlternatives(const Ast& ast, int node, std::vector<std::string>& outLiterals)
 {
-	NFA nfa1 = NFA::GenerateEmpty();
-	NFA nfa2 = NFA::GenerateEmpty();
-	bool shouldUnion = false;
+	auto isPlain = [](const Ast::Node& n)
+	{
+		return n.kind == Ast::Kind::Char && n.input != ANY && n.input != LINE_START && n.input != LINE_END && n.input != '\n';
+	};
 
-	NFA* currentNfa = &nfa1;
-	NFA nextGroup = NFA::GenerateEmpty();
+	const Ast::Node& n = ast.GetNode(node);
+	if (isPlain(n))
+	{
+		outLiterals.push_back(std::string(1, n.input));
+		return true;
+	}
 
-	int i = 0;
-	while (i < text.size())
+	if (n.kind == Ast::Kind::Concatenate)
 	{
-		char input = text[i];
+		std::string literal;
+		for (int i = 0; i < n.numChildren; ++i)
+		{
+			const Ast::Node& child = ast.GetNode(ast.Child(node, i));
+			if (!isPlain(child))
+			{
+				return false;
+			}
+			literal += child.input;
+		}
+		outLiterals.push_back(literal);
+		return true;
+	}
 
-		if (input == '(')
+	if (n.kind == Ast::Kind::Union)
+	{
+		for (int i = 0; i < n.numChildren; ++i)
 		{
-			// increment i past the open-paren
-			++i;
+			if (!FindAlternatives(ast, ast.Child(node, i), outLiterals))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
 
-			// recursively call ParseExpression on this new
-			// parenthesis group
-			int len;
-			NFA output = ParseExpression(text.substr(i), len);
+	return false;
+}
 
-			// increment i past the expression and close-paren
-			i += len + 1;
+/// <summary>
+/// Finds the bytes that leave the start state of a search DFA. Stops early once there are
+/// too many for a ByteScanner.
+/// </summary>
+/// <param name="search"></param>
+/// <returns>The bytes, or more than ByteScanner::MAX_BYTES bytes if the start state can not
+/// be skipped</returns>
+template <typename Automaton>
+static std::string StartBytes(const Automaton& search)
+{
+	uint32_t start = search.StartState();
+	if (search.IsAccepting(start))
+	{
+		return std::string(ByteScanner::MAX_BYTES + 1, '\0');
+	}
 
-			// concatenate the parenthesis group to the current
-			// expression, after checking for repetition operators
-			int numSkipped;
-			*currentNfa = NFA::Concatenate(
-				*currentNfa, 
-				CheckOperators(output, text[i], numSkipped));
-			i += numSkipped;
+	// a newline always has to be stopped at, to feed the line markers
+	std::string startBytes = "\n";
+	for (int c = 0; c < 256 && startBytes.size() <= ByteScanner::MAX_BYTES; ++c)
+	{
+		if (c != '\n' && search.Next(start, (char)c) != start)
+		{
+			startBytes += (char)c;
 		}
-		else if (input == ')')
+	}
+
+	return startBytes;
+}
+
+Regex Regex::Parse(const std::string& regex, bool minimize)
+{
+	return Compile({ Parser::Parse(regex) }, minimize);
+}
+
+Regex Regex::Parse(const std::vector<std::string>& patterns, bool minimize)
+{
+	std::vector<Ast> asts;
+	for (const std::string& pattern : patterns)
+	{
+		asts.push_back(Parser::Parse(pattern));
+	}
+
+	return Compile(asts, minimize);
+}
+
+Regex Regex::Compile(const std::vector<Ast>& patterns, bool minimize)
+{
+	Regex r;
+	r.numPatterns = (int)patterns.size();
+
+	// a line matches if any of the patterns do, so only the text they all share is required
+	Literals literals = FindLiterals(patterns[0], patterns[0].Root());
+	for (size_t i = 1; i < patterns.size(); ++i)
+	{
+		literals = UnionLiterals(literals, FindLiterals(patterns[i], patterns[i].Root()));
+	}
+
+	// a match never spans a newline, so a literal with one in it can not be searched for
+	if (literals.required.find('\n') == std::string::npos)
+	{
+		r.requiredLiteral = literals.required;
+	}
+
+	// a list of plain literals is found with a trie of the literals, which is much cheaper to build
+	// than the dfas when there are many of them
+	std::vector<std::vector<std::string>> alternatives(patterns.size());
+	bool isLiteral = true;
+	size_t numLiterals = 0;
+	for (size_t i = 0; i < patterns.size() && isLiteral; ++i)
+	{
+		isLiteral = FindAlternatives(patterns[i], patterns[i].Root(), alternatives[i]);
+		numLiterals += alternatives[i].size();
+	}
+
+	if (isLiteral && numLiterals >= MIN_AHO_CORASICK_LITERALS)
+	{
+		r.literalMatcher = std::make_shared<AhoCorasick>(alternatives);
+		r.statistics.literalStates = r.literalMatcher->NumStates();
+		return r;
+	}
+
+	// the patterns are alternatives of one NFA, which remembers the final state of each
+	NFABuilder builder;
+	std::vector<NFABuilder::Fragment> fragments;
+	std::vector<int> patternFinals;
+	for (const Ast& ast : patterns)
+	{
+		fragments.push_back(builder.Add(ast, ast.Root()));
+		patternFinals.push_back(fragments.back().end);
+	}
+
+	NFABuilder::Fragment all = fragments.size() == 1 ? fragments[0] : builder.Union(fragments);
+	r.nfa = builder.Build(all, patternFinals);
+
+	// a DFA can have exponentially more states than its NFA. If either one would be too big to
+	// build up front, both build their states as the input reaches them instead. An NFA that is
+	// too big is not even tried
+	NFA reversed = r.nfa.Reverse();
+	bool isSmall = (size_t)r.nfa.NumStates() <= MAX_EAGER_NFA_STATES &&
+		r.nfa.StartRow(NFA::Search::Anchored).size() <= MAX_EAGER_START_STATES;
+	if (isSmall && r.nfa.TryConvertToSearchDFA(MAX_DFA_STATES, r.searchDfa) &&
+		reversed.TryConvertToDFA(MAX_DFA_STATES, r.reverseDfa))
+	{
+		r.statistics.searchStates = r.searchDfa.NumStates();
+		r.statistics.reverseStates = r.reverseDfa.NumStates();
+
+		// a smaller table keeps more of itself in the cpu cache while scanning
+		if (minimize)
 		{
-			// recursive base case, end of parenthesis group
-			break;
+			r.searchDfa.Minimize();
+			r.reverseDfa.Minimize();
 		}
-		else if (input == '|')
+
+		r.statistics.minimizedSearchStates = r.searchDfa.NumStates();
+		r.statistics.minimizedReverseStates = r.reverseDfa.NumStates();
+		r.statistics.byteClasses = r.searchDfa.NumByteClasses();
+	}
+	else
+	{
+		r.searchDfa = DFA::GenerateEmpty();
+		r.reverseDfa = DFA::GenerateEmpty();
+		r.lazySearchDfa = std::make_shared<LazyDFA>(r.nfa, NFA::Search::Leftmost);
+		r.lazyReverseDfa = std::make_shared<LazyDFA>(std::move(reversed), NFA::Search::Anchored);
+	}
+
+	r.FindStartBytes();
+
+	// which pattern matched is only a question with several patterns, and then only for the lines that
+	// match. The pattern dfa keeps every thread the search dfa does, so it is no smaller than that one
+	if (r.numPatterns == 1)
+	{
+		return r;
+	}
+
+	if (!r.lazySearchDfa && r.nfa.TryConvertToPatternDFA(MAX_DFA_STATES, r.patternDfa))
+	{
+		r.statistics.patternStates = r.patternDfa.NumStates();
+		if (minimize)
 		{
-			// complete a union if one is pending
-			if (shouldUnion)
-			{
-				nfa1 = NFA::Union(nfa1, nfa2);
-				nfa2 = NFA::GenerateEmpty();
-			}
+			r.patternDfa.Minimize();
+		}
+		r.statistics.minimizedPatternStates = r.patternDfa.NumStates();
+	}
+	else
+	{
+		r.patternDfa = DFA::GenerateEmpty();
+		r.lazyPatternDfa = std::make_shared<LazyDFA>(r.nfa, NFA::Search::EveryMatch);
+	}
 
-			// swap the nfas
-			currentNfa = &nfa2;
-			shouldUnion = true;
+	return r;
+}
 
-			i++;
+void Regex::FindStartBytes()
+{
+	std::string startBytes = lazySearchDfa ? StartBytes(lazySearchDfa->Begin()) : StartBytes(searchDfa);
+	canSkipStart = startBytes.size() <= ByteScanner::MAX_BYTES;
+	if (canSkipStart)
+	{
+		startScanner = ByteScanner(startBytes);
+	}
+}
+
+// the statistics are written in this order
+static int Regex::Statistics::* const SERIAL_STATISTICS[] = {
+	&Regex::Statistics::searchStates,
+	&Regex::Statistics::minimizedSearchStates,
+	&Regex::Statistics::reverseStates,
+	&Regex::Statistics::minimizedReverseStates,
+	&Regex::Statistics::patternStates,
+	&Regex::Statistics::minimizedPatternStates,
+	&Regex::Statistics::byteClasses,
+	&Regex::Statistics::literalStates,
+};
+
+bool Regex::Serialize(std::string& out) const
+{
+	if (literalMatcher || lazySearchDfa || lazyPatternDfa)
+	{
+		return false;
+	}
+
+	BinaryWriter writer(out);
+	writer.Word(SERIAL_MAGIC);
+	writer.Word(SERIAL_VERSION);
+	writer.Word((uint32_t)numPatterns);
+	writer.String(requiredLiteral);
+	for (auto field : SERIAL_STATISTICS)
+	{
+		writer.Word((uint32_t)(statistics.*field));
+	}
+
+	searchDfa.Serialize(out);
+	reverseDfa.Serialize(out);
+	if (numPatterns > 1)
+	{
+		patternDfa.Serialize(out);
+	}
+
+	return true;
+}
+
+bool Regex::Load(std::string_view data, size_t& offset, std::shared_ptr<const void> owner, Regex& outRegex)
+{
+	Regex r;
+	BinaryReader reader(data.substr(std::min(offset, data.size())));
+
+	uint32_t magic, version, numPatterns;
+	if (!reader.Word(magic) || magic != SERIAL_MAGIC || !reader.Word(version) || version != SERIAL_VERSION ||
+		!reader.Word(numPatterns) || numPatterns == 0 || numPatterns > INT32_MAX || !reader.String(r.requiredLiteral))
+	{
+		return false;
+	}
+	r.numPatterns = (int)numPatterns;
+
+	for (auto field : SERIAL_STATISTICS)
+	{
+		uint32_t value;
+		if (!reader.Word(value))
+		{
+			return false;
 		}
-		else
+		r.statistics.*field = (int)value;
+	}
+
+	size_t dfaOffset = offset + reader.Offset();
+	if (!DFA::Load(data, dfaOffset, owner, r.searchDfa) || !DFA::Load(data, dfaOffset, owner, r.reverseDfa))
+	{
+		return false;
+	}
+
+	if (r.numPatterns > 1)
+	{
+		if (!DFA::Load(data, dfaOffset, owner, r.patternDfa))
 		{
-			// this is the non-operator case, so adding
-			// a character to match
+			return false;
+		}
 
-			// check for special characters
-			if (input == '^')
+		// the pattern ids index a list of the patterns while matching
+		for (int state = 0; state <= r.patternDfa.NumStates(); ++state)
+		{
+			for (int pattern : r.patternDfa.Patterns(state))
 			{
-				input = LINE_START;
+				if (pattern >= r.numPatterns)
+				{
+					return false;
+				}
 			}
-			else if (input == '$')
+		}
+	}
+
+	r.FindStartBytes();
+
+	outRegex = std::move(r);
+	offset = dfaOffset;
+	return true;
+}
+
+template <typename Automaton>
+size_t Regex::MatchWith(const Automaton& search, const Automaton& reverse, std::string_view text,
+	std::vector<Span>& outMatches) const
+{
+	outMatches.clear();
+
+	size_t numScans = 0;
+	size_t numSkipped = 0;
+
+	size_t start = 0;
+	while (start <= text.size())
+	{
+		// run the search dfa forward until it dies. The last position it accepted
+		// at is the end of the leftmost-longest match
+		bool found = false;
+		bool endsAfterLineEnd = false;
+		size_t end = 0;
+
+		uint32_t state = search.StartState();
+		if (start == 0)
+		{
+			state = search.NextLineStart(state);
+		}
+
+		if (search.IsAccepting(state))
+		{
+			found = true;
+			end = start;
+		}
+
+		size_t i;
+		for (i = start; i < text.size() && !search.IsDead(state); ++i)
+		{
+			// skip the text that can not begin a match
+			if (state == search.StartState() && canSkipStart && ByteScanner::ShouldScan(numScans, numSkipped))
 			{
-				input = LINE_END;
+				size_t skipped = startScanner.Find(text.data() + i, text.size() - i);
+				numScans++;
+				numSkipped += skipped;
+
+				i += skipped;
+				if (i == text.size())
+				{
+					break;
+				}
 			}
-			else if (input == '.')
+
+			state = search.Next(state, text[i]);
+			if (search.IsAccepting(state))
 			{
-				input = ANY;
+				found = true;
+				end = i + 1;
 			}
-			else if (input == '\\')
+		}
+
+		if (!search.IsDead(state))
+		{
+			state = search.NextLineEnd(state);
+			if (search.IsAccepting(state))
 			{
-				i++;
-				input = text[i];
+				found = true;
+				end = text.size();
+				endsAfterLineEnd = true;
 			}
+		}
 
-			// a regular character
-			NFA single = NFA::GenerateSingle(input);
+		// nothing else on this line matches
+		if (!found)
+		{
+			break;
+		}
 
-			++i;
+		// run the reverse dfa backwards from the end of the match. The last position
+		// it accepted at is where the match started
+		size_t matchStart = end;
+		state = reverse.StartState();
 
-			// concatenate this character to the expression
-			// after checking for repetition operators
-			int numSkipped;
-			*currentNfa = NFA::Concatenate(
-				*currentNfa, 
-				CheckOperators(single, text[i], numSkipped));
+		if (endsAfterLineEnd)
+		{
+			state = reverse.NextLineEnd(state);
+		}
 
-			i += numSkipped;
+		for (i = end; i > start && !reverse.IsDead(state); --i)
+		{
+			state = reverse.Next(state, text[i - 1]);
+			if (reverse.IsAccepting(state))
+			{
+				matchStart = i - 1;
+			}
+		}
+
+		if (start == 0 && !reverse.IsDead(state))
+		{
+			state = reverse.NextLineStart(state);
+			if (reverse.IsAccepting(state))
+			{
+				matchStart = 0;
+			}
 		}
-	}
 
-	// returns the length of the parenthesis expression
-	outLen = i;
+		if (end > matchStart)
+		{
+			outMatches.push_back({ matchStart, end - matchStart });
+		}
 
-	// complete a union if one is pending
-	if (shouldUnion)
-	{
-		nfa1 = NFA::Union(nfa1, nfa2);
+		// continue after this match, or one past it if it was empty
+		start = end > matchStart ? end : end + 1;
 	}
 
-	return nfa1;
+	return outMatches.size();
 }
 
-Regex Regex::Parse(const std::string& regex)
+template <typename Automaton>
+size_t Regex::FindHit(const Automaton& search, std::string_view text, size_t from) const
 {
-	Regex r;
+	const uint32_t lineStart = search.NextLineStart(search.StartState());
 
-	int dummy;
-	r.nfa = ParseExpression(regex, dummy);
+	// the search dfa never dies before it has found a match, so it only
+	// needs to be checked for a final state
+	size_t numScans = 0;
+	size_t numSkipped = 0;
 
-	r.dfa = r.nfa.ConvertToDFA();
+	size_t hit = text.size();
+	uint32_t state = lineStart;
+	if (search.IsAccepting(state))
+	{
+		hit = from;
+	}
 
-	return r;
+	for (size_t i = from; i < text.size() && hit == text.size(); ++i)
+	{
+		// skip the text that can not begin a match
+		if (state == search.StartState() && canSkipStart && ByteScanner::ShouldScan(numScans, numSkipped))
+		{
+			size_t skipped = startScanner.Find(text.data() + i, text.size() - i);
+			numScans++;
+			numSkipped += skipped;
+
+			i += skipped;
+			if (i == text.size())
+			{
+				break;
+			}
+		}
+
+		if (text[i] == '\n')
+		{
+			// the newline belongs to the line it ends
+			state = search.NextLineEnd(state);
+			if (search.IsAccepting(state))
+			{
+				hit = i;
+				break;
+			}
+
+			state = lineStart;
+			if (search.IsAccepting(state) && i + 1 < text.size())
+			{
+				hit = i + 1;
+			}
+			continue;
+		}
+
+		state = search.Next(state, text[i]);
+		if (search.IsAccepting(state))
+		{
+			hit = i;
+		}
+	}
+
+	// the last line might not have a newline
+	if (hit == text.size() && text.back() != '\n')
+	{
+		state = search.NextLineEnd(state);
+		if (search.IsAccepting(state))
+		{
+			hit = text.size() - 1;
+		}
+	}
+
+	return hit;
 }
 
-std::vector<std::pair<std::string, int>> Regex::Match(const std::string& text)
+template <typename Automaton>
+bool Regex::FindLineWith(const Automaton& search, std::string_view text, size_t from, Span& outLine) const
 {
-	std::vector<std::pair<std::string, int>> matches;
-	std::string fullText = (char)LINE_START + text + (char)LINE_END;
+	if (from >= text.size())
+	{
+		return false;
+	}
 
-	for (int start = 0; start < fullText.size(); ++start)
+	size_t hit = text.size();
+	if (requiredLiteral.empty())
 	{
-		dfa.BeginSimulation();
+		hit = FindHit(search, text, from);
+	}
 
-		int i;
-		for (i = start; i < fullText.size(); ++i)
+	// only run the dfa on the lines that contain the required literal
+	size_t position = from;
+	while (!requiredLiteral.empty() && hit == text.size() && position < text.size())
+	{
+		size_t candidate = text.find(requiredLiteral, position);
+		if (candidate == std::string_view::npos)
 		{
-			dfa.OnNext(fullText[i]);
+			return false;
+		}
 
-			// 'failure' means dfa is in unrecoverable error state, abort now
-			if (dfa.HasFailed())
-			{
-				break;
-			}
+		size_t begin = text.rfind('\n', candidate);
+		begin = begin == std::string_view::npos || begin < position ? position : begin + 1;
 
-			// if dfa is in accept state, log the match
-			if (dfa.HasAccepted())
-			{
-				std::string_view match = fullText;
-				match = match.substr(start, i - start + 1);
+		size_t end = text.find('\n', candidate);
+		if (end == std::string_view::npos)
+		{
+			end = text.size();
+		}
 
-				if (match.size() > 0 && match[0] == (char)LINE_START)
-				{
-					match.remove_prefix(1);
-				}
-				if (match.size() > 0 && match[match.size() - 1] == (char)LINE_END)
-				{
-					match.remove_suffix(1);
-				}
+		size_t lineHit = FindHit(search, text.substr(0, end), begin);
+		if (lineHit < end)
+		{
+			hit = lineHit;
+		}
+
+		position = end + 1;
+	}
 
-				if (match != "")
+	if (hit == text.size())
+	{
+		return false;
+	}
+
+	// find the boundaries of the matching line
+	size_t begin = hit;
+	while (begin > from && text[begin - 1] != '\n')
+	{
+		--begin;
+	}
+
+	size_t end = text.find('\n', hit);
+	if (end == std::string_view::npos)
+	{
+		end = text.size();
+	}
+
+	outLine = { begin, end - begin };
+	return true;
+}
+
+template <typename Automaton>
+size_t Regex::MatchingPatternsWith(const Automaton& patterns, std::string_view text, std::vector<int>& outPatterns) const
+{
+	outPatterns.clear();
+	std::vector<bool> found(numPatterns, false);
+
+	auto addPatterns = [&](uint32_t state)
+	{
+		if (patterns.IsAccepting(state))
+		{
+			for (int pattern : patterns.Patterns(state))
+			{
+				if (!found[pattern])
 				{
-					// subtract off one to cancel out the start-of-line character
-					matches.push_back(std::make_pair(std::string(match), start - 1));
+					found[pattern] = true;
+					outPatterns.push_back(pattern);
 				}
 			}
 		}
-		
-		dfa.EndSimulation();
+	};
+
+	// the pattern dfa never dies, it is in a final state wherever the match of some pattern ends
+	uint32_t state = patterns.NextLineStart(patterns.StartState());
+	addPatterns(state);
+
+	for (size_t i = 0; i < text.size() && (int)outPatterns.size() < numPatterns; ++i)
+	{
+		state = patterns.Next(state, text[i]);
+		addPatterns(state);
+	}
+
+	addPatterns(patterns.NextLineEnd(state));
+
+	std::sort(outPatterns.begin(), outPatterns.end());
+	return outPatterns.size();
+}
+
+template <typename Automaton>
+bool Regex::AcceptsWith(const Automaton& search, std::string_view text) const
+{
+	// the search dfa keeps every thread until it first accepts, so it accepts if any match does
+	uint32_t state = search.NextLineStart(search.StartState());
+	for (size_t i = 0; i < text.size() && !search.IsAccepting(state); ++i)
+	{
+		state = search.Next(state, text[i]);
+	}
+
+	return search.IsAccepting(state) || search.IsAccepting(search.NextLineEnd(state));
+}
+
+template <typename Automaton>
+bool Regex::MatchesEmptyWith(const Automaton& search)
+{
+	// the start state holds the threads that have read nothing yet, whatever came before
+	uint32_t start = search.StartState();
+	uint32_t lineStart = search.NextLineStart(start);
+	return search.IsAccepting(start) || search.IsAccepting(lineStart)
+		|| search.IsAccepting(search.NextLineEnd(start)) || search.IsAccepting(search.NextLineEnd(lineStart));
+}
+
+template <typename Automaton>
+bool Regex::IsMatchWith(const Automaton& search, std::string_view text) const
+{
+	if (MatchesEmptyWith(search))
+	{
+		std::vector<Span> matches;
+		return Match(text, matches) > 0;
+	}
+
+	// any final state ends a match that is not empty. The line has no newline, so FindHit
+	// stops at the first one
+	return !text.empty() && FindHit(search, text, 0) < text.size();
+}
+
+bool Regex::IsMatch(std::string_view text) const
+{
+	if (literalMatcher)
+	{
+		Span line;
+		return literalMatcher->FindLine(text, 0, line);
+	}
+
+	if (!requiredLiteral.empty() && text.find(requiredLiteral) == std::string_view::npos)
+	{
+		return false;
+	}
+
+	if (lazySearchDfa)
+	{
+		LazyDFA::Runner search = lazySearchDfa->Begin();
+		return IsMatchWith(search, text);
 	}
-	
+
+	return IsMatchWith(searchDfa, text);
+}
+
+size_t Regex::Match(std::string_view text, std::vector<Span>& outMatches) const
+{
+	if (literalMatcher)
+	{
+		return literalMatcher->Match(text, outMatches);
+	}
+
+	if (lazySearchDfa)
+	{
+		LazyDFA::Runner search = lazySearchDfa->Begin();
+		LazyDFA::Runner reverse = lazyReverseDfa->Begin();
+		return MatchWith(search, reverse, text, outMatches);
+	}
+
+	return MatchWith(searchDfa, reverseDfa, text, outMatches);
+}
+
+bool Regex::FindLine(std::string_view text, size_t from, Span& outLine) const
+{
+	if (literalMatcher)
+	{
+		return literalMatcher->FindLine(text, from, outLine);
+	}
+
+	if (lazySearchDfa)
+	{
+		LazyDFA::Runner search = lazySearchDfa->Begin();
+		return FindLineWith(search, text, from, outLine);
+	}
+
+	return FindLineWith(searchDfa, text, from, outLine);
+}
+
+size_t Regex::MatchingPatterns(std::string_view text, std::vector<int>& outPatterns) const
+{
+	if (literalMatcher)
+	{
+		return literalMatcher->MatchingPatterns(text, outPatterns);
+	}
+
+	if (numPatterns == 1)
+	{
+		bool matches = lazySearchDfa ? AcceptsWith(lazySearchDfa->Begin(), text) : AcceptsWith(searchDfa, text);
+		outPatterns.assign(matches ? 1 : 0, 0);
+		return outPatterns.size();
+	}
+
+	if (lazyPatternDfa)
+	{
+		LazyDFA::Runner patterns = lazyPatternDfa->Begin();
+		return MatchingPatternsWith(patterns, text, outPatterns);
+	}
+
+	return MatchingPatternsWith(patternDfa, text, outPatterns);
+}
+
+std::vector<std::pair<std::string, int>> Regex::Match(const std::string& text)
+{
+	std::vector<Span> spans;
+	Match(text, spans);
+
+	std::vector<std::pair<std::string, int>> matches;
+	for (const Span& span : spans)
+	{
+		matches.push_back(std::make_pair(text.substr(span.offset, span.length), (int)span.offset));
+	}
+
 	return matches;
 }
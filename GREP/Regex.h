@@ -1,41 +1,324 @@
 #pragma once
+#include "Ast.h"
 #include "NFA.h"
+#include "NFABuilder.h"
 #include "DFA.h"
+#include "LazyDFA.h"
+#include "ByteScanner.h"
+#include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
+class AhoCorasick;
+
+/// <summary>
+/// A compiled regular expression. Matching does not modify the Regex, so one
+/// Regex can be shared by any number of threads.
+/// </summary>
 class Regex
 {
+	// runs the dfas over text that arrives in pieces
+	friend class Scanner;
+
+public:
+
+	/// <summary>
+	/// The location of a match in the text that was searched
+	/// </summary>
+	struct Span
+	{
+		size_t offset;
+		size_t length;
+	};
+
+	/// <summary>
+	/// The number of states in the dfas, before and after they were minimized, and the number
+	/// of byte classes their tables have a column for. Zero for dfas that were built lazily, and
+	/// for the pattern dfa of a single pattern. If the patterns are plain literals, the number of
+	/// states in the Aho-Corasick automaton used instead, otherwise zero.
+	/// </summary>
+	struct Statistics
+	{
+		int searchStates;
+		int minimizedSearchStates;
+		int reverseStates;
+		int minimizedReverseStates;
+		int patternStates;
+		int minimizedPatternStates;
+		int byteClasses;
+		int literalStates;
+	};
+
 private:
 	
 	NFA nfa;
-	DFA dfa;
 
-	static NFA ParseExpression(const std::string& text, int& outLen);
-	static NFA CheckOperators(const NFA& nfa, char nextChar, int& outNumSkipped);
+	Statistics statistics = {};
+
+	// finds the end of the leftmost-longest match, starting anywhere in the input
+	DFA searchDfa;
+
+	// run backwards from the end of a match to find where it started
+	DFA reverseDfa;
+
+	// the number of patterns that were compiled together, and a dfa that finds every match of
+	// each of them, to tell which patterns a line matches
+	int numPatterns = 1;
+	DFA patternDfa;
+
+	// the most states the dfas above may have. Bigger dfas are built lazily instead
+	static const size_t MAX_DFA_STATES = 2000;
+
+	// an NFA with more states than this, or whose start state reaches more than this many states by
+	// epsilon arrows (about two for each alternative of a big alternation), is built lazily without
+	// trying the dfas above. Its dfa would have more than MAX_DFA_STATES states anyway, and each of the
+	// states built before finding that out costs a step through every alternative
+	static const size_t MAX_EAGER_NFA_STATES = 8 * MAX_DFA_STATES;
+	static const size_t MAX_EAGER_START_STATES = MAX_DFA_STATES / 2;
+
+	// used instead of the dfas above when they are built lazily, otherwise null. Shared by
+	// copies of the Regex, since they are only modified through their caches
+	std::shared_ptr<const LazyDFA> lazySearchDfa;
+	std::shared_ptr<const LazyDFA> lazyReverseDfa;
+
+	// used instead of patternDfa when it is too big to build up front. A single pattern needs
+	// neither, the search dfa already tells whether it matches
+	std::shared_ptr<const LazyDFA> lazyPatternDfa;
+
+	// used instead of all of the above when every pattern is an alternation of plain literals
+	std::shared_ptr<const AhoCorasick> literalMatcher;
+
+	// the fewest literals that are worth building an Aho-Corasick automaton for. A single literal
+	// is found just as fast by the dfas, which skip to its first byte
+	static const size_t MIN_AHO_CORASICK_LITERALS = 2;
+
+	// finds the bytes that leave the start state of the search dfa, so the bytes that stay in it can
+	// be skipped without stepping the dfa. Only used when there are few enough of them.
+	ByteScanner startScanner;
+	bool canSkipStart = false;
+
+	// the longest string that every match contains, used to skip text that can not match
+	std::string requiredLiteral;
+
+	// identifies serialized Regexes, and the version of their format
+	static const uint32_t SERIAL_MAGIC = 0x58524447;
+	static const uint32_t SERIAL_VERSION = 1;
+
+	/// <summary>
+	/// Sets up the start scanner for the search dfa
+	/// </summary>
+	void FindStartBytes();
+
+	/// <summary>
+	/// What is known about the literal text in the matches of part of a regular expression
+	/// </summary>
+	struct Literals
+	{
+		// true if every match is exactly the text in exact
+		bool isExact;
+		std::string exact;
+
+		// text that every match starts with, ends with, and contains
+		std::string prefix;
+		std::string suffix;
+		std::string required;
+	};
+
+	static Literals ConcatenateLiterals(const Literals& first, const Literals& second);
+	static Literals UnionLiterals(const Literals& first, const Literals& second);
+
+	/// <summary>
+	/// Finds the literal text in the matches of a node of the syntax tree
+	/// </summary>
+	/// <param name="ast"></param>
+	/// <param name="node"></param>
+	/// <returns></returns>
+	static Literals FindLiterals(const Ast& ast, int node);
+
+	/// <summary>
+	/// Lists the strings a node of the syntax tree matches, if it is a plain literal or an
+	/// alternation of plain literals
+	/// </summary>
+	/// <param name="ast"></param>
+	/// <param name="node"></param>
+	/// <param name="outLiterals">Output parameter that the literals are added to</param>
+	/// <returns>False if the node matches anything other than a list of nonempty literals that do
+	/// not contain a newline</returns>
+	static bool FindAlternatives(const Ast& ast, int node, std::vector<std::string>& outLiterals);
+
+	/// <summary>
+	/// Runs the search dfa over a block of lines, feeding the line markers at each newline
+	/// </summary>
+	/// <param name="search">The search dfa, either a DFA or a LazyDFA::Runner</param>
+	/// <param name="text">A block of lines, separated by newlines</param>
+	/// <param name="from">The offset into text to search from. Must be the start of a line.</param>
+	/// <returns>The offset of a position in the first line with a match, or the size of text if
+	/// there is none</returns>
+	template <typename Automaton>
+	size_t FindHit(const Automaton& search, std::string_view text, size_t from) const;
+
+	// Match and FindLine, for either kind of dfa
+	template <typename Automaton>
+	size_t MatchWith(const Automaton& search, const Automaton& reverse, std::string_view text,
+		std::vector<Span>& outMatches) const;
+	template <typename Automaton>
+	bool FindLineWith(const Automaton& search, std::string_view text, size_t from, Span& outLine) const;
+	template <typename Automaton>
+	size_t MatchingPatternsWith(const Automaton& patterns, std::string_view text, std::vector<int>& outPatterns) const;
+
+	/// <summary>
+	/// Runs the search dfa over a line until it reaches a final state
+	/// </summary>
+	/// <param name="search">The search dfa, either a DFA or a LazyDFA::Runner</param>
+	/// <param name="text">The line to match, without a line terminator</param>
+	/// <returns>True if there is a match anywhere in the line, including an empty one</returns>
+	template <typename Automaton>
+	bool AcceptsWith(const Automaton& search, std::string_view text) const;
+
+	/// <summary>
+	/// Returns true if the search dfa accepts the empty string next to a line marker or between
+	/// two bytes, so a final state it reaches might only be that of an empty match
+	/// </summary>
+	/// <param name="search">The search dfa, either a DFA or a LazyDFA::Runner</param>
+	/// <returns></returns>
+	template <typename Automaton>
+	static bool MatchesEmptyWith(const Automaton& search);
+
+	// IsMatch, for either kind of dfa
+	template <typename Automaton>
+	bool IsMatchWith(const Automaton& search, std::string_view text) const;
 
 public:
 
-	static const char LINE_START = 128;
-	static const char LINE_END = 129;
-	static const char ANY = 130;
+	// symbols used on the arrows of the NFA for ^, $ and . in the regular expression. The
+	// line markers are not characters in the text, they are fed to the DFA at line boundaries
+	static constexpr char LINE_START = (char)128;
+	static constexpr char LINE_END = (char)129;
+	static constexpr char ANY = (char)130;
 
 	Regex();
 
 	/// <summary>
-	/// Matches a string using this regular expression.
+	/// Matches a line of text using this regular expression. Runs in time linear in the length
+	/// of the text for each match found, and does not allocate once outMatches has grown to fit.
+	/// </summary>
+	/// <param name="text">The line to match, without a line terminator</param>
+	/// <param name="outMatches">Output parameter that is cleared, then filled with the non-overlapping,
+	/// leftmost-longest matches in the order they appear. Empty matches are not reported.</param>
+	/// <returns>The number of matches found</returns>
+	size_t Match(std::string_view text, std::vector<Span>& outMatches) const;
+
+	/// <summary>
+	/// Returns true if Match would find a match in a line, without finding where it is. A line
+	/// without the required literal is rejected without running a dfa, and the search dfa stops at
+	/// the first final state it reaches. Patterns that can match the empty string, which Match does
+	/// not report, are matched in full instead.
+	/// </summary>
+	/// <param name="text">The line to match, without a line terminator</param>
+	/// <returns></returns>
+	bool IsMatch(std::string_view text) const;
+
+	/// <summary>
+	/// Finds the next line in a block of text that could contain a match. The block is scanned
+	/// without splitting it into lines, and the boundaries of a line are only found once it matches.
+	/// Lines that only contain empty matches are also found, Match reports nothing for these.
+	/// </summary>
+	/// <param name="text">A block of lines, separated by newlines</param>
+	/// <param name="from">The offset into text to search from. Must be the start of a line.</param>
+	/// <param name="outLine">Output parameter that will contain the location of the line, without
+	/// its newline</param>
+	/// <returns>False if no more lines could match</returns>
+	bool FindLine(std::string_view text, size_t from, Span& outLine) const;
+
+	/// <summary>
+	/// Finds which of the patterns this Regex was compiled from match somewhere in a line. Runs in
+	/// time linear in the length of the line, however many patterns there are.
+	/// </summary>
+	/// <param name="text">The line to match, without a line terminator</param>
+	/// <param name="outPatterns">Output parameter that is cleared, then filled with the ids of the
+	/// patterns that match, sorted. A pattern that only matches the empty string counts.</param>
+	/// <returns>The number of patterns that match</returns>
+	size_t MatchingPatterns(std::string_view text, std::vector<int>& outPatterns) const;
+
+	/// <summary>
+	/// Returns the number of patterns this Regex was compiled from
+	/// </summary>
+	/// <returns></returns>
+	int NumPatterns() const { return numPatterns; }
+
+	/// <summary>
+	/// Returns the longest string that every match of this regular expression contains.
+	/// Empty if there is no such string.
+	/// </summary>
+	/// <returns></returns>
+	const std::string& RequiredLiteral() const { return requiredLiteral; }
+
+	/// <summary>
+	/// Matches a string using this regular expression. Copies out each match, prefer the
+	/// overload that reports spans.
 	/// </summary>
 	/// <param name="text">The string to match</param>
-	/// <returns>A list of matches. Each match contains the string
+	/// <returns>A list of the non-overlapping, leftmost-longest matches. Each match contains the string
 	/// that was matched and its index into the input string.</returns>
 	std::vector<std::pair<std::string, int>> Match(const std::string& text);
 
+	/// <summary>
+	/// Returns the sizes of the compiled dfas
+	/// </summary>
+	/// <returns></returns>
+	const Statistics& GetStatistics() const { return statistics; }
+
+	/// <summary>
+	/// Appends this Regex to a buffer in a binary format, see Load. Only a Regex whose dfas were
+	/// all built up front can be written, since that is what saves time when it is loaded.
+	/// </summary>
+	/// <param name="out">The buffer. Its size must be a multiple of 4 bytes, and still is afterwards.</param>
+	/// <returns>False if the Regex builds its dfas lazily or finds plain literals without them, in
+	/// which case nothing is written</returns>
+	bool Serialize(std::string& out) const;
+
+	/// <summary>
+	/// Reads a Regex written by Serialize, without parsing or building anything. The tables of the
+	/// dfas are used where they lie in the data, see DFA::Load.
+	/// </summary>
+	/// <param name="data">Data that was written by Serialize, which must start at an address that
+	/// is a multiple of 4</param>
+	/// <param name="offset">The offset of the Regex in the data, which must be a multiple of 4. Set
+	/// to the offset just past it.</param>
+	/// <param name="owner">Keeps the data alive, it is held for as long as the dfas are in use</param>
+	/// <param name="outRegex">Output parameter that will contain the Regex</param>
+	/// <returns>False if the data does not hold a valid Regex written by this version</returns>
+	static bool Load(std::string_view data, size_t& offset, std::shared_ptr<const void> owner, Regex& outRegex);
+
 	/// <summary>
 	/// Creates a Regex object from a regular expression. The supported regular expression
 	/// operations are parenthesis, |, *, +, ?, ^, $, and .
 	/// </summary>
 	/// <param name="regex"></param>
+	/// <param name="minimize">If true, the dfas are minimized after they are built</param>
+	/// <returns></returns>
+	/// <exception cref="ParseError">The regular expression is not valid</exception>
+	static Regex Parse(const std::string& regex, bool minimize = true);
+
+	/// <summary>
+	/// Creates a Regex object that matches any of several regular expressions. Each one is a
+	/// pattern whose id is its index in the list, see MatchingPatterns.
+	/// </summary>
+	/// <param name="patterns">At least one regular expression</param>
+	/// <param name="minimize">If true, the dfas are minimized after they are built</param>
+	/// <returns></returns>
+	/// <exception cref="ParseError">One of the regular expressions is not valid</exception>
+	static Regex Parse(const std::vector<std::string>& patterns, bool minimize = true);
+
+	/// <summary>
+	/// Creates a Regex object from the syntax trees of one or more patterns, which are
+	/// compiled into a single automaton
+	/// </summary>
+	/// <param name="patterns">At least one syntax tree, see Parser. The id of each pattern is
+	/// its index in the list.</param>
+	/// <param name="minimize">If true, the dfas are minimized after they are built</param>
 	/// <returns></returns>
-	static Regex Parse(const std::string& regex);
+	static Regex Compile(const std::vector<Ast>& patterns, bool minimize = true);
 };
 
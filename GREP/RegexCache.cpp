@@ -0,0 +1,112 @@
+#include "RegexCache.h"
+#include "BinaryReader.h"
+#include "BinaryWriter.h"
+#include "InputFile.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <random>
+
+/// <summary>
+/// Hashes a string with 64 bit FNV-1a
+/// </summary>
+/// <param name="text"></param>
+/// <param name="hash">The hash of the text before this one</param>
+/// <returns></returns>
+static uint64_t Fnv1a(std::string_view text, uint64_t hash)
+{
+	for (char c : text)
+	{
+		hash ^= (unsigned char)c;
+		hash *= 0x100000001b3;
+	}
+
+	return hash;
+}
+
+RegexCache::RegexCache(const std::string& directory)
+	: directory(directory)
+{ }
+
+void RegexCache::WriteHeader(const std::vector<std::string>& patterns, bool minimize, std::string& out)
+{
+	BinaryWriter writer(out);
+	writer.Word(FILE_MAGIC);
+	writer.Word(FILE_VERSION);
+	writer.Word(minimize ? 1 : 0);
+	writer.Word((uint32_t)patterns.size());
+	for (const std::string& pattern : patterns)
+	{
+		writer.String(pattern);
+	}
+}
+
+std::string RegexCache::PathOf(const std::vector<std::string>& patterns, bool minimize) const
+{
+	// the header holds everything the file depends on, and the lengths keep ["ab", "c"] apart from ["a", "bc"]
+	std::string header;
+	WriteHeader(patterns, minimize, header);
+	uint64_t hash = Fnv1a(header, 0xcbf29ce484222325);
+
+	char name[32];
+	std::snprintf(name, sizeof(name), "%016llx.dfa", (unsigned long long)hash);
+	return (std::filesystem::path(directory) / name).string();
+}
+
+bool RegexCache::Load(const std::vector<std::string>& patterns, bool minimize, Regex& outRegex) const
+{
+	// the file stays mapped for as long as the dfas use it
+	auto file = std::make_shared<InputFile>(PathOf(patterns, minimize));
+	std::string_view data;
+	if (!file->IsOpen() || !file->IsMapped() || !file->NextBlock(data))
+	{
+		return false;
+	}
+
+	std::string header;
+	WriteHeader(patterns, minimize, header);
+	if (data.substr(0, header.size()) != header)
+	{
+		return false;
+	}
+
+	size_t offset = header.size();
+	return Regex::Load(data, offset, file, outRegex);
+}
+
+bool RegexCache::Store(const std::vector<std::string>& patterns, bool minimize, const Regex& regex) const
+{
+	std::string contents;
+	WriteHeader(patterns, minimize, contents);
+	if (!regex.Serialize(contents))
+	{
+		return false;
+	}
+
+	std::error_code error;
+	std::filesystem::create_directories(directory, error);
+
+	// several processes can store the same file at once, so each writes its own temporary file
+	std::string path = PathOf(patterns, minimize);
+	std::string temporary = path + "." + std::to_string(std::random_device()()) + ".tmp";
+	{
+		std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+		if (!file.write(contents.data(), contents.size()) || !file.flush())
+		{
+			file.close();
+			std::filesystem::remove(temporary, error);
+			return false;
+		}
+	}
+
+	std::filesystem::rename(temporary, path, error);
+	if (error)
+	{
+		std::filesystem::remove(temporary, error);
+		return false;
+	}
+
+	return true;
+}
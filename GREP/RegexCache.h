@@ -0,0 +1,67 @@
+#pragma once
+#include "Regex.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// Keeps compiled Regexes in files in a directory, so a later run with the same patterns can skip
+/// parsing them and building their dfas. Each file is named after a hash of the patterns, and also
+/// holds the patterns themselves, so two lists of patterns with the same hash are never mixed up.
+///
+/// A file is loaded by mapping it into memory, and the tables of the dfas are used where they lie
+/// in it. Only Regexes that Regex::Serialize can write are kept, see there.
+/// </summary>
+class RegexCache
+{
+private:
+	std::string directory;
+
+	// identifies cache files, and the version of their format
+	static const uint32_t FILE_MAGIC = 0x43524447;
+	static const uint32_t FILE_VERSION = 1;
+
+	/// <summary>
+	/// Returns the path of the file for a list of patterns
+	/// </summary>
+	/// <param name="patterns"></param>
+	/// <param name="minimize"></param>
+	/// <returns></returns>
+	std::string PathOf(const std::vector<std::string>& patterns, bool minimize) const;
+
+	/// <summary>
+	/// Writes the header of a cache file, which identifies the patterns it holds
+	/// </summary>
+	/// <param name="patterns"></param>
+	/// <param name="minimize"></param>
+	/// <param name="out">The buffer to append the header to</param>
+	static void WriteHeader(const std::vector<std::string>& patterns, bool minimize, std::string& out);
+
+public:
+
+	/// <summary>
+	/// Creates a cache that keeps its files in a directory
+	/// </summary>
+	/// <param name="directory">The directory, which is created when the first Regex is stored</param>
+	RegexCache(const std::string& directory);
+
+	/// <summary>
+	/// Loads the Regex compiled from a list of patterns, if it was stored before
+	/// </summary>
+	/// <param name="patterns">The patterns, see Regex::Parse</param>
+	/// <param name="minimize">Whether the dfas were minimized</param>
+	/// <param name="outRegex">Output parameter that will contain the Regex</param>
+	/// <returns>False if the cache has no valid file for the patterns</returns>
+	bool Load(const std::vector<std::string>& patterns, bool minimize, Regex& outRegex) const;
+
+	/// <summary>
+	/// Stores the Regex compiled from a list of patterns. The file is written under another name
+	/// and then renamed, so a file that is being loaded at the same time is never seen half written.
+	/// </summary>
+	/// <param name="patterns">The patterns the Regex was compiled from</param>
+	/// <param name="minimize">Whether the dfas were minimized</param>
+	/// <param name="regex"></param>
+	/// <returns>False if the Regex can not be stored, or the file could not be written</returns>
+	bool Store(const std::vector<std::string>& patterns, bool minimize, const Regex& regex) const;
+};
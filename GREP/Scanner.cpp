@@ -0,0 +1,287 @@
+#include "Scanner.h"
+#include "AhoCorasick.h"
+
+#include <algorithm>
+#include <cstring>
+
+Scanner::Scanner(const Regex& regex)
+	: regex(regex)
+{
+	if (regex.lazySearchDfa)
+	{
+		lazySearch.emplace(regex.lazySearchDfa->Begin());
+		lazyReverse.emplace(regex.lazyReverseDfa->Begin());
+	}
+
+	StartLine();
+}
+
+template <typename Automaton>
+void Scanner::Begin(const Automaton& search)
+{
+	state = search.StartState();
+	if (start == lineStart)
+	{
+		state = search.NextLineStart(state);
+	}
+
+	found = search.IsAccepting(state);
+	end = start;
+	scanned = start;
+}
+
+template <typename Automaton>
+void Scanner::Scan(const Automaton& search, const Automaton& reverse)
+{
+	while (scanned < position && !isLineDone)
+	{
+		// the bytes up to the end of pending or of the piece, whichever the next byte is in
+		const char* bytes = scanned < chunkStart ? pending.data() + (scanned - pendingStart) : chunk + (scanned - chunkStart);
+		size_t size = (scanned < chunkStart ? chunkStart : position) - scanned;
+
+		size_t i = 0;
+		while (i < size && !search.IsDead(state))
+		{
+			// skip the text that can not begin a match
+			if (state == search.StartState() && regex.canSkipStart && ByteScanner::ShouldScan(numScans, numSkipped))
+			{
+				size_t skipped = regex.startScanner.Find(bytes + i, size - i);
+				numScans++;
+				numSkipped += skipped;
+
+				i += skipped;
+				if (i == size)
+				{
+					break;
+				}
+			}
+
+			state = search.Next(state, bytes[i++]);
+			if (search.IsAccepting(state))
+			{
+				found = true;
+				end = scanned + i;
+			}
+		}
+		scanned += i;
+
+		// the match can not grow any longer, or there is none
+		if (search.IsDead(state))
+		{
+			Report(search, reverse, false);
+		}
+	}
+}
+
+template <typename Automaton>
+void Scanner::Report(const Automaton& search, const Automaton& reverse, bool endsAfterLineEnd)
+{
+	// nothing else on this line matches
+	if (!found)
+	{
+		isLineDone = true;
+		return;
+	}
+
+	// run the reverse dfa backwards from the end of the match, like Regex::Match
+	size_t matchStart = end;
+	uint32_t reverseState = reverse.StartState();
+	if (endsAfterLineEnd)
+	{
+		reverseState = reverse.NextLineEnd(reverseState);
+	}
+
+	size_t i;
+	for (i = end; i > start && !reverse.IsDead(reverseState); --i)
+	{
+		reverseState = reverse.Next(reverseState, ByteAt(i - 1));
+		if (reverse.IsAccepting(reverseState))
+		{
+			matchStart = i - 1;
+		}
+	}
+
+	if (start == lineStart && !reverse.IsDead(reverseState))
+	{
+		reverseState = reverse.NextLineStart(reverseState);
+		if (reverse.IsAccepting(reverseState))
+		{
+			matchStart = lineStart;
+		}
+	}
+
+	if (end > matchStart)
+	{
+		matches.push_back({ matchStart, end - matchStart });
+	}
+
+	// continue after this match, or one past it if it was empty. The bytes after it are
+	// searched again, since the search that found it did not start from there
+	start = end > matchStart ? end : end + 1;
+	if (start > position)
+	{
+		numToSkip = start - position;
+	}
+
+	Begin(search);
+}
+
+template <typename Automaton>
+void Scanner::EndLine(const Automaton& search, const Automaton& reverse)
+{
+	// a search that would start past the end of the line finds nothing
+	while (!isLineDone && numToSkip == 0)
+	{
+		bool endsAfterLineEnd = false;
+		if (!search.IsDead(state) && search.IsAccepting(search.NextLineEnd(state)))
+		{
+			found = true;
+			end = position;
+			endsAfterLineEnd = true;
+		}
+
+		Report(search, reverse, endsAfterLineEnd);
+		Scan(search, reverse);
+	}
+}
+
+void Scanner::StartLine()
+{
+	lineStart = position;
+	start = position;
+	chunk = nullptr;
+	chunkStart = position;
+	pending.clear();
+	pendingStart = position;
+	numToSkip = 0;
+	isLineDone = false;
+	numScans = 0;
+	numSkipped = 0;
+
+	if (lazySearch)
+	{
+		Begin(*lazySearch);
+	}
+	else if (!regex.literalMatcher)
+	{
+		Begin(regex.searchDfa);
+	}
+}
+
+void Scanner::AddToLine(const char* data, size_t size)
+{
+	size_t skipped = std::min(numToSkip, size);
+	numToSkip -= skipped;
+
+	chunk = data + skipped;
+	chunkStart = position + skipped;
+	position += size;
+
+	// Aho-Corasick looks at the whole line once it ends
+	if (lazySearch)
+	{
+		Scan(*lazySearch, *lazyReverse);
+	}
+	else if (!regex.literalMatcher)
+	{
+		Scan(regex.searchDfa, regex.reverseDfa);
+	}
+}
+
+void Scanner::SaveChunk()
+{
+	if (chunk == nullptr)
+	{
+		return;
+	}
+
+	if (isLineDone || start >= position)
+	{
+		pending.clear();
+		pendingStart = position;
+	}
+	else if (start >= chunkStart)
+	{
+		pending.assign(chunk + (start - chunkStart), position - start);
+		pendingStart = start;
+	}
+	else
+	{
+		// the bytes before start are dropped now and then rather than after every match, so
+		// each byte is only moved a few times
+		if (start - pendingStart > pending.size() / 2)
+		{
+			pending.erase(0, start - pendingStart);
+			pendingStart = start;
+		}
+		pending.append(chunk, position - chunkStart);
+	}
+
+	chunk = nullptr;
+	chunkStart = position;
+}
+
+void Scanner::FinishLine()
+{
+	if (lazySearch)
+	{
+		EndLine(*lazySearch, *lazyReverse);
+	}
+	else if (!regex.literalMatcher)
+	{
+		EndLine(regex.searchDfa, regex.reverseDfa);
+	}
+	else
+	{
+		// the line is only copied if it was split between pieces
+		std::string_view line(chunk, position - chunkStart);
+		if (!pending.empty())
+		{
+			SaveChunk();
+			line = pending;
+		}
+
+		regex.literalMatcher->Match(line, lineMatches);
+		for (const Regex::Span& match : lineMatches)
+		{
+			matches.push_back({ lineStart + match.offset, match.length });
+		}
+	}
+}
+
+size_t Scanner::Feed(const char* data, size_t size)
+{
+	matches.clear();
+
+	const char* dataEnd = data + size;
+	while (data < dataEnd)
+	{
+		const char* newline = (const char*)std::memchr(data, '\n', dataEnd - data);
+		if (newline == nullptr)
+		{
+			AddToLine(data, dataEnd - data);
+			SaveChunk();
+			break;
+		}
+
+		AddToLine(data, newline - data);
+		FinishLine();
+
+		// the next line starts after the newline
+		position++;
+		StartLine();
+		data = newline + 1;
+	}
+
+	return matches.size();
+}
+
+size_t Scanner::Finish()
+{
+	matches.clear();
+	FinishLine();
+
+	position = 0;
+	StartLine();
+	return matches.size();
+}
@@ -0,0 +1,171 @@
+#pragma once
+#include "Regex.h"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// Finds the matches of a Regex in text that arrives in pieces, such as the buffers read from a
+/// socket or a pipe. The pieces can split lines, and even matches, anywhere. The state of the search
+/// dfa is kept between pieces, so no byte is read twice unless Regex::Match would read it twice too,
+/// and the matches are the same as Regex::Match finds in each line.
+///
+/// The pieces are read where they lie. Only the bytes of a line that goes on into the next piece are
+/// copied, from where the current match could start, since the reverse dfa reads them back once the
+/// end of the match is known. Patterns that are plain literals are found with Aho-Corasick, which
+/// keeps all of such a line.
+///
+/// A Scanner holds the state of one stream and must not be shared between threads, but any number
+/// of Scanners can share a Regex.
+/// </summary>
+class Scanner
+{
+private:
+
+	const Regex& regex;
+
+	// caches of the lazy dfas, held for as long as the scanner so their states stay valid
+	// between pieces. Empty if the dfas were built up front
+	std::optional<LazyDFA::Runner> lazySearch;
+	std::optional<LazyDFA::Runner> lazyReverse;
+
+	// the number of bytes fed so far, and the offset of the start of the current line
+	size_t position = 0;
+	size_t lineStart = 0;
+
+	// the offset the current search started from
+	size_t start = 0;
+
+	// the bytes of the current line in the piece being fed, from chunkStart up to position. They are
+	// read where they lie, and only copied into pending if the line goes on into the next piece
+	const char* chunk = nullptr;
+	size_t chunkStart = 0;
+
+	// the bytes of the line from earlier pieces that a search may still read, from pendingStart up
+	// to chunkStart. The bytes before start are dropped once they take up half of it
+	std::string pending;
+	size_t pendingStart = 0;
+
+	// the offset of the next byte the search dfa reads
+	size_t scanned = 0;
+
+	// the bytes after start that can not start a match, because the last match was an empty one
+	// just before them. Dropped as they arrive
+	size_t numToSkip = 0;
+
+	// the state of the search dfa, and the end of the longest match it has found so far
+	uint32_t state = 0;
+	bool found = false;
+	size_t end = 0;
+
+	// true once nothing else in the current line can match
+	bool isLineDone = false;
+
+	// how often the start scanner was run in the current line, and how far it skipped, see
+	// ByteScanner::ShouldScan
+	size_t numScans = 0;
+	size_t numSkipped = 0;
+
+	// the matches found by the last call to Feed or Finish
+	std::vector<Regex::Span> matches;
+
+	// the matches Aho-Corasick finds in the current line, relative to its start
+	std::vector<Regex::Span> lineMatches;
+
+	/// <summary>
+	/// Starts a search at start with the search dfa
+	/// </summary>
+	/// <param name="search">The search dfa, either a DFA or a LazyDFA::Runner</param>
+	template <typename Automaton>
+	void Begin(const Automaton& search);
+
+	/// <summary>
+	/// Runs the search dfa over the bytes of pending it has not read, reporting the matches it finds
+	/// </summary>
+	/// <param name="search">The search dfa, either a DFA or a LazyDFA::Runner</param>
+	/// <param name="reverse">The reverse dfa, of the same kind</param>
+	template <typename Automaton>
+	void Scan(const Automaton& search, const Automaton& reverse);
+
+	/// <summary>
+	/// Reports the match the search dfa has found, then starts the next search after it
+	/// </summary>
+	/// <param name="search">The search dfa, either a DFA or a LazyDFA::Runner</param>
+	/// <param name="reverse">The reverse dfa, of the same kind</param>
+	/// <param name="endsAfterLineEnd">True if the match was found by feeding the end of the line</param>
+	template <typename Automaton>
+	void Report(const Automaton& search, const Automaton& reverse, bool endsAfterLineEnd);
+
+	/// <summary>
+	/// Finishes the current line, reporting the matches that end at its end
+	/// </summary>
+	/// <param name="search">The search dfa, either a DFA or a LazyDFA::Runner</param>
+	/// <param name="reverse">The reverse dfa, of the same kind</param>
+	template <typename Automaton>
+	void EndLine(const Automaton& search, const Automaton& reverse);
+
+	/// <summary>
+	/// Returns the byte of the current line at an offset from the start of the stream
+	/// </summary>
+	/// <param name="offset"></param>
+	/// <returns></returns>
+	char ByteAt(size_t offset) const { return offset < chunkStart ? pending[offset - pendingStart] : chunk[offset - chunkStart]; }
+
+	/// <summary>
+	/// Starts a line at the current position
+	/// </summary>
+	void StartLine();
+
+	/// <summary>
+	/// Adds bytes of the current line, which do not contain a newline
+	/// </summary>
+	/// <param name="data"></param>
+	/// <param name="size"></param>
+	void AddToLine(const char* data, size_t size);
+
+	/// <summary>
+	/// Copies the bytes of the piece being fed that the current line still needs into pending,
+	/// before the piece goes away
+	/// </summary>
+	void SaveChunk();
+
+	/// <summary>
+	/// Finishes the current line with whichever matcher the Regex uses
+	/// </summary>
+	void FinishLine();
+
+public:
+
+	/// <summary>
+	/// Creates a scanner at the start of a stream
+	/// </summary>
+	/// <param name="regex">The regular expression to match, which must outlive the scanner</param>
+	Scanner(const Regex& regex);
+
+	/// <summary>
+	/// Feeds the next piece of the stream. Lines are separated by newlines, and a line that is not
+	/// finished at the end of the piece continues in the next one.
+	/// </summary>
+	/// <param name="data"></param>
+	/// <param name="size"></param>
+	/// <returns>The number of matches the piece finished, see Matches</returns>
+	size_t Feed(const char* data, size_t size);
+
+	/// <summary>
+	/// Ends the stream, finishing the last line if it has no newline. The scanner can then be fed
+	/// another stream, whose offsets start from 0 again.
+	/// </summary>
+	/// <returns>The number of matches in the last line, see Matches</returns>
+	size_t Finish();
+
+	/// <summary>
+	/// Returns the matches found by the last call to Feed or Finish, in the order they appear. Each
+	/// is located by its offset from the start of the stream. A match is only found once the bytes
+	/// after it show it can not grow any longer, so it can be reported by a later call than the one
+	/// that fed its last byte.
+	/// </summary>
+	/// <returns></returns>
+	const std::vector<Regex::Span>& Matches() const { return matches; }
+};
@@ -0,0 +1,564 @@
+#include "Searcher.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+Searcher::Searcher(const Regex& regex, int numThreads, bool printPatterns, OutputBuffer::Highlight highlight,
+	Mode mode, size_t maxLines)
+	: regex(regex), numThreads(std::max(numThreads, 1)), printPatterns(printPatterns), highlight(highlight),
+	mode(mode), maxLines(maxLines)
+{ }
+
+std::vector<size_t> Searcher::SplitBlock(std::string_view block) const
+{
+	size_t chunkSize = std::clamp(block.size() / (numThreads * CHUNKS_PER_THREAD), MIN_CHUNK_SIZE, MAX_CHUNK_SIZE);
+
+	std::vector<size_t> bounds = { 0 };
+	while (bounds.back() < block.size())
+	{
+		// end the chunk after the first newline past its nominal size
+		size_t end = block.find('\n', bounds.back() + chunkSize - 1);
+		bounds.push_back(end == std::string_view::npos ? block.size() : end + 1);
+	}
+
+	return bounds;
+}
+
+bool Searcher::IsBinary(std::string_view block)
+{
+	return block.substr(0, BINARY_CHECK_SIZE).find('\0') != std::string_view::npos;
+}
+
+size_t Searcher::SearchChunk(std::string_view chunk, std::string_view linePrefix, LineBuffers& buffers,
+	OutputBuffer& output, size_t maxLines) const
+{
+	std::vector<Regex::Span>& matches = buffers.matches;
+
+	// only lines that could match are split out of the chunk
+	Regex::Span line;
+	size_t position = 0;
+	size_t numLines = 0;
+	while (numLines < maxLines && regex.FindLine(chunk, position, line))
+	{
+		std::string_view input = chunk.substr(line.offset, line.length);
+		if (regex.Match(input, matches) > 0)
+		{
+			numLines++;
+			output.Add(linePrefix);
+
+			if (printPatterns)
+			{
+				regex.MatchingPatterns(input, buffers.patterns);
+				for (size_t i = 0; i < buffers.patterns.size(); ++i)
+				{
+					output.Add(i == 0 ? "" : ",");
+					output.Add(std::to_string(buffers.patterns[i]));
+				}
+				output.Add(":");
+			}
+
+			bool hasNewline = line.offset + line.length < chunk.size();
+			output.AddLine(input, hasNewline, matches);
+		}
+
+		position = line.offset + line.length + 1;
+	}
+
+	return numLines;
+}
+
+size_t Searcher::CountChunk(std::string_view chunk, size_t maxLines) const
+{
+	// FindLine also finds lines that only have empty matches, which are not counted
+	Regex::Span line;
+	size_t position = 0;
+	size_t numLines = 0;
+	while (numLines < maxLines && regex.FindLine(chunk, position, line))
+	{
+		if (regex.IsMatch(chunk.substr(line.offset, line.length)))
+		{
+			numLines++;
+		}
+
+		position = line.offset + line.length + 1;
+	}
+
+	return numLines;
+}
+
+size_t Searcher::SearchParallel(std::string_view block, const std::vector<size_t>& bounds, int fd) const
+{
+	size_t numChunks = bounds.size() - 1;
+
+	// workers may only run this far ahead of the chunks that have been written,
+	// which limits how much output is buffered
+	size_t window = numThreads * CHUNKS_PER_THREAD;
+
+	std::vector<OutputBuffer> outputs(numChunks, OutputBuffer(highlight));
+	std::vector<bool> done(numChunks, false);
+	size_t nextChunk = 0;
+	size_t numWritten = 0;
+	size_t numLines = 0;
+
+	std::mutex mutex;
+	std::condition_variable changed;
+
+	auto worker = [&]()
+	{
+		LineBuffers buffers;
+		while (true)
+		{
+			size_t chunk;
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				changed.wait(lock, [&]() { return nextChunk >= numChunks || nextChunk < numWritten + window; });
+				if (nextChunk >= numChunks)
+				{
+					return;
+				}
+				chunk = nextChunk++;
+			}
+
+			OutputBuffer output(highlight);
+			size_t chunkLines = SearchChunk(block.substr(bounds[chunk], bounds[chunk + 1] - bounds[chunk]), "", buffers,
+				output, NO_LIMIT);
+
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				outputs[chunk] = std::move(output);
+				numLines += chunkLines;
+				done[chunk] = true;
+			}
+			changed.notify_all();
+		}
+	};
+
+	std::vector<std::thread> workers;
+	for (int i = 0; i < numThreads; ++i)
+	{
+		workers.emplace_back(worker);
+	}
+
+	// stitch the output of the chunks together in order
+	for (size_t chunk = 0; chunk < numChunks; ++chunk)
+	{
+		OutputBuffer output;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			changed.wait(lock, [&]() { return done[chunk]; });
+			output = std::move(outputs[chunk]);
+			numWritten = chunk + 1;
+		}
+		changed.notify_all();
+
+		output.WriteTo(fd);
+	}
+
+	for (std::thread& thread : workers)
+	{
+		thread.join();
+	}
+
+	return numLines;
+}
+
+void Searcher::ReadBlocks(InputFile& file, SpscQueue<Block>& filled, SpscQueue<Block>& emptied)
+{
+	Block block = emptied.Pop();
+	size_t size = 0;
+	while (true)
+	{
+		// a line longer than a block makes the block grow until the line ends
+		if (size == block.capacity)
+		{
+			size_t capacity = block.capacity > 0 ? block.capacity * 2 : STREAM_BLOCK_SIZE;
+			std::unique_ptr<char[]> data(new char[capacity]);
+			std::copy(block.data.get(), block.data.get() + size, data.get());
+			block.data = std::move(data);
+			block.capacity = capacity;
+		}
+
+		// the block is filled for as long as each read returns all that was asked for. A pipe whose
+		// writer is slower, such as tail -f, returns less, and the lines read so far are handed on
+		// at once rather than held back until a whole block has come in
+		size_t wanted = std::min(block.capacity - size, STREAM_READ_SIZE);
+		size_t count = file.Read(block.data.get() + size, wanted);
+		size += count;
+		if (count == 0)
+		{
+			break;
+		}
+		else if (count == wanted && size < block.capacity)
+		{
+			continue;
+		}
+
+		size_t end = std::string_view(block.data.get(), size).rfind('\n') + 1;
+		if (end == 0)
+		{
+			continue;
+		}
+
+		// hand on the whole lines, and move the line after them into the next block
+		Block next = emptied.Pop();
+		if (next.capacity < STREAM_BLOCK_SIZE || next.capacity <= size - end)
+		{
+			next.capacity = size - end < STREAM_BLOCK_SIZE ? STREAM_BLOCK_SIZE : (size - end) * 2;
+			next.data.reset(new char[next.capacity]);
+		}
+		std::copy(block.data.get() + end, block.data.get() + size, next.data.get());
+
+		block.size = end;
+		filled.Push(std::move(block));
+		block = std::move(next);
+		size -= end;
+	}
+
+	// at the end of the file, the last line might not have a newline
+	if (size > 0)
+	{
+		block.size = size;
+		filled.Push(std::move(block));
+	}
+
+	Block last;
+	last.isEnd = true;
+	filled.Push(std::move(last));
+}
+
+void Searcher::WriteBlocks(int fd, SpscQueue<Block>& searched, SpscQueue<Block>& emptied)
+{
+	while (true)
+	{
+		Block block = searched.Pop();
+		if (block.isEnd)
+		{
+			break;
+		}
+
+		block.output.WriteTo(fd);
+		emptied.Push(std::move(block));
+	}
+}
+
+size_t Searcher::SearchStream(InputFile& file, int fd) const
+{
+	// each block goes round from the reader to the matcher to the writer and back. A stage owns the
+	// blocks it holds, so none of them is ever locked
+	SpscQueue<Block> filled(NUM_STREAM_BUFFERS);
+	SpscQueue<Block> searched(NUM_STREAM_BUFFERS);
+	SpscQueue<Block> emptied(NUM_STREAM_BUFFERS);
+	for (size_t i = 0; i < NUM_STREAM_BUFFERS; ++i)
+	{
+		Block block;
+		block.output = OutputBuffer(highlight);
+		emptied.Push(std::move(block));
+	}
+
+	std::thread reader([&]() { ReadBlocks(file, filled, emptied); });
+	std::thread writer([&]() { WriteBlocks(fd, searched, emptied); });
+
+	LineBuffers buffers;
+	size_t numLines = 0;
+	while (true)
+	{
+		Block block = filled.Pop();
+		if (!block.isEnd)
+		{
+			numLines += SearchChunk(std::string_view(block.data.get(), block.size), "", buffers, block.output, NO_LIMIT);
+		}
+
+		bool isEnd = block.isEnd;
+		searched.Push(std::move(block));
+		if (isEnd)
+		{
+			break;
+		}
+	}
+
+	reader.join();
+	writer.join();
+	return numLines;
+}
+
+size_t Searcher::SearchBlocks(InputFile& file, std::string_view linePrefix, bool skipBinary, OutputBuffer& output,
+	int fd) const
+{
+	// one matching line is all it takes to list a file, or to know a file matches
+	size_t maxCount = mode == Mode::Files || mode == Mode::Quiet ? std::min(maxLines, (size_t)1) : maxLines;
+
+	LineBuffers buffers;
+	size_t numLines = 0;
+
+	std::string_view block;
+	bool first = true;
+	while (numLines < maxCount && file.NextBlock(block))
+	{
+		if (first && skipBinary && IsBinary(block))
+		{
+			return 0;
+		}
+		first = false;
+
+		// only the lines that are written need their matches found
+		if (mode == Mode::Lines)
+		{
+			numLines += SearchChunk(block, linePrefix, buffers, output, maxCount - numLines);
+		}
+		else
+		{
+			numLines += CountChunk(block, maxCount - numLines);
+		}
+
+		// a block that was read rather than mapped is overwritten by the next one
+		if (fd >= 0 && (!file.IsMapped() || output.Size() >= FLUSH_SIZE))
+		{
+			output.WriteTo(fd);
+		}
+		else if (!file.IsMapped())
+		{
+			output.Keep();
+		}
+	}
+
+	return numLines;
+}
+
+size_t Searcher::Search(InputFile& file, std::string_view name, int fd) const
+{
+	OutputBuffer output(highlight);
+	if (mode != Mode::Lines || maxLines != NO_LIMIT)
+	{
+		size_t numLines = SearchBlocks(file, "", false, output, fd);
+		if (mode == Mode::Count)
+		{
+			output.Add(std::to_string(numLines));
+			output.Add("\n");
+		}
+		else if (mode == Mode::Files && numLines > 0)
+		{
+			output.Add(name);
+			output.Add("\n");
+		}
+
+		output.WriteTo(fd);
+		return numLines;
+	}
+
+	if (!file.IsMapped())
+	{
+		return SearchStream(file, fd);
+	}
+
+	// the lines are written from the mapping, which stays until the file is closed
+	LineBuffers buffers;
+	size_t numLines = 0;
+
+	std::string_view block;
+	while (file.NextBlock(block))
+	{
+		std::vector<size_t> bounds = SplitBlock(block);
+		if (numThreads > 1 && bounds.size() > 2)
+		{
+			numLines += SearchParallel(block, bounds, fd);
+			continue;
+		}
+
+		for (size_t chunk = 0; chunk + 1 < bounds.size(); ++chunk)
+		{
+			numLines += SearchChunk(block.substr(bounds[chunk], bounds[chunk + 1] - bounds[chunk]), "", buffers, output,
+				NO_LIMIT);
+			if (output.Size() >= FLUSH_SIZE)
+			{
+				output.WriteTo(fd);
+			}
+		}
+	}
+
+	output.WriteTo(fd);
+	return numLines;
+}
+
+size_t Searcher::Search(InputFile& file, std::string_view linePrefix, OutputBuffer& output) const
+{
+	return SearchBlocks(file, linePrefix, true, output, -1);
+}
+
+bool Searcher::Search(const std::vector<std::string>& paths, bool recursive, int fd, bool& outFound) const
+{
+	// guards the slots, std::cerr and the result
+	std::mutex mutex;
+	std::condition_variable changed;
+	bool result = true;
+
+	// set once a line has matched, which is all that Mode::Quiet needs to know
+	std::atomic<bool> found{ false };
+
+	// each file gets a slot in the order the paths are listed, and its output is written once every
+	// slot before it has been. Files may only be searched this far ahead of the output that has been
+	// written, which limits how much output is buffered
+	std::deque<FileSlot> slots;
+	size_t numWritten = 0;
+	bool listed = false;
+	size_t window = numThreads * FILES_PER_THREAD;
+
+	auto reportError = [&](const std::string& path, const std::string& message)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		std::cerr << "grep: " << path << ": " << message << std::endl;
+		result = false;
+	};
+
+	ThreadPool pool(numThreads);
+
+	auto searchFile = [&](const std::string& path, OutputBuffer& output)
+	{
+		if (mode == Mode::Quiet && found)
+		{
+			return;
+		}
+
+		InputFile file(path);
+		if (!file.IsOpen())
+		{
+			reportError(InputFile::DisplayName(path), "could not open file");
+			return;
+		}
+
+		std::string name = InputFile::DisplayName(path);
+		size_t numLines = Search(file, mode == Mode::Lines ? name + ":" : "", output);
+		if (numLines > 0)
+		{
+			found = true;
+		}
+
+		if (mode == Mode::Count)
+		{
+			output.Add(name + ":" + std::to_string(numLines) + "\n");
+		}
+		else if (mode == Mode::Files && numLines > 0)
+		{
+			output.Add(name + "\n");
+		}
+
+		// the output points into the file, which is closed before the output is written
+		output.Keep();
+	};
+
+	auto submitFile = [&](const std::string& path)
+	{
+		size_t slot;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			changed.wait(lock, [&]() { return slots.size() < numWritten + window; });
+			slot = slots.size();
+			slots.emplace_back();
+		}
+
+		pool.Submit([&, path, slot]()
+		{
+			OutputBuffer output(highlight);
+			searchFile(path, output);
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				slots[slot].output = std::move(output);
+				slots[slot].done = true;
+			}
+			changed.notify_all();
+		});
+	};
+
+	// directories are listed depth first on one thread, so their files get their slots in the same
+	// order on every run
+	std::function<void(const std::filesystem::path&)> searchDirectory = [&](const std::filesystem::path& directory)
+	{
+		if (mode == Mode::Quiet && found)
+		{
+			return;
+		}
+
+		std::error_code error;
+		std::filesystem::directory_iterator it(directory, error);
+		if (error)
+		{
+			reportError(directory.string(), error.message());
+			return;
+		}
+
+		for (; it != std::filesystem::directory_iterator() && !(mode == Mode::Quiet && found); it.increment(error))
+		{
+			// links found while recursing are not followed, to avoid cycles
+			std::filesystem::file_status status = it->symlink_status(error);
+			std::filesystem::path entry = it->path();
+			if (std::filesystem::is_directory(status))
+			{
+				searchDirectory(entry);
+			}
+			else if (std::filesystem::is_regular_file(status))
+			{
+				submitFile(entry.string());
+			}
+		}
+	};
+
+	std::thread lister([&]()
+	{
+		for (const std::string& path : paths)
+		{
+			if (mode == Mode::Quiet && found)
+			{
+				break;
+			}
+
+			std::error_code error;
+			if (!std::filesystem::is_directory(path, error))
+			{
+				submitFile(path);
+			}
+			else if (recursive)
+			{
+				searchDirectory(path);
+			}
+			else
+			{
+				reportError(path, "is a directory");
+			}
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			listed = true;
+		}
+		changed.notify_all();
+	});
+
+	// stitch the output of the files together in order
+	for (size_t slot = 0; ; ++slot)
+	{
+		OutputBuffer output;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			changed.wait(lock, [&]() { return slot < slots.size() ? slots[slot].done : listed; });
+			if (slot >= slots.size())
+			{
+				break;
+			}
+			output = std::move(slots[slot].output);
+			numWritten = slot + 1;
+		}
+		changed.notify_all();
+
+		output.WriteTo(fd);
+	}
+
+	lister.join();
+	pool.Wait();
+	outFound = found;
+	return result;
+}
@@ -0,0 +1,255 @@
+#pragma once
+#include "Regex.h"
+#include "InputFile.h"
+#include "OutputBuffer.h"
+#include "SpscQueue.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class Searcher
+{
+public:
+
+	/// <summary>
+	/// What is written for each file that is searched
+	/// </summary>
+	enum class Mode
+	{
+		// each matching line
+		Lines,
+
+		// the number of matching lines
+		Count,
+
+		// the name of the file, if a line matches
+		Files,
+
+		// nothing, the search only tells whether a line matched
+		Quiet
+	};
+
+	// the line limit that does not stop a search
+	static const size_t NO_LIMIT = SIZE_MAX;
+
+private:
+	// bounds on the size of the chunks a block is split into for the worker threads
+	static constexpr size_t MIN_CHUNK_SIZE = 64 * 1024;
+	static constexpr size_t MAX_CHUNK_SIZE = 4 * 1024 * 1024;
+
+	// how many chunks each thread should get from a block, so slow chunks even out
+	static const size_t CHUNKS_PER_THREAD = 4;
+
+	// number of bytes at the start of a file that are checked for a NUL byte
+	static const size_t BINARY_CHECK_SIZE = 8 * 1024;
+
+	// the size of the blocks a stream is read in, and how many blocks are passed between the stages
+	// of SearchStream
+	static const size_t STREAM_BLOCK_SIZE = 1024 * 1024;
+	static const size_t NUM_STREAM_BUFFERS = 4;
+
+	// the most a block is filled by at a time, the size of a pipe's buffer on Linux
+	static constexpr size_t STREAM_READ_SIZE = 64 * 1024;
+
+	// the output of a file is written once this many bytes of it have been found
+	static const size_t FLUSH_SIZE = 1024 * 1024;
+
+	// how many files each thread may search ahead of the file whose output is written next
+	static const size_t FILES_PER_THREAD = 4;
+
+	const Regex& regex;
+	int numThreads;
+
+	// if true, each matching line is prefixed with the ids of the patterns it matches
+	bool printPatterns;
+
+	// how the matches in each line are shown
+	OutputBuffer::Highlight highlight;
+
+	// what is written for each file, and how many matching lines of a file are found before its
+	// search stops
+	Mode mode;
+	size_t maxLines;
+
+	/// <summary>
+	/// Buffers reused for each line of a chunk
+	/// </summary>
+	struct LineBuffers
+	{
+		std::vector<Regex::Span> matches;
+		std::vector<int> patterns;
+	};
+
+	/// <summary>
+	/// Lines read from a stream, passed from the reader to the matcher, then to the writer with the
+	/// lines that matched, and back to the reader to be filled again
+	/// </summary>
+	struct Block
+	{
+		std::unique_ptr<char[]> data;
+		size_t capacity = 0;
+
+		// the bytes of whole lines at the start of data, though the last line of the stream may not
+		// end with a newline
+		size_t size = 0;
+
+		// the matching lines, which point into data, so the block is only read into again once
+		// they have been written
+		OutputBuffer output;
+
+		// true for the block after the last one, which holds nothing
+		bool isEnd = false;
+	};
+
+	/// <summary>
+	/// The output of a file searched by the pool, kept until the output of every file listed before
+	/// it has been written
+	/// </summary>
+	struct FileSlot
+	{
+		OutputBuffer output;
+		bool done = false;
+	};
+
+	/// <summary>
+	/// Splits a block into chunks that each end after a newline, or at the end of the block
+	/// </summary>
+	/// <param name="block"></param>
+	/// <returns>The offset each chunk starts at, followed by the size of the block</returns>
+	std::vector<size_t> SplitBlock(std::string_view block) const;
+
+	/// <summary>
+	/// Searches a chunk of lines, adding each matching line to the output with its matches highlighted
+	/// </summary>
+	/// <param name="chunk">The lines to search, which the output points into</param>
+	/// <param name="linePrefix">Text written before each matching line</param>
+	/// <param name="buffers">Buffers to hold the matches and patterns of each line</param>
+	/// <param name="output">The buffer to add the matching lines to</param>
+	/// <param name="maxLines">The most matching lines to add</param>
+	/// <returns>The number of lines added</returns>
+	size_t SearchChunk(std::string_view chunk, std::string_view linePrefix, LineBuffers& buffers,
+		OutputBuffer& output, size_t maxLines) const;
+
+	/// <summary>
+	/// Counts the matching lines in a chunk, without finding where their matches are
+	/// </summary>
+	/// <param name="chunk">The lines to search</param>
+	/// <param name="maxLines">The count to stop at</param>
+	/// <returns>The number of matching lines, at most maxLines</returns>
+	size_t CountChunk(std::string_view chunk, size_t maxLines) const;
+
+	/// <summary>
+	/// Searches a file block by block on the calling thread, stopping once it has found as many
+	/// matching lines as the mode needs. Only the lines themselves are added to the output.
+	/// </summary>
+	/// <param name="file">The file to search</param>
+	/// <param name="linePrefix">Text written before each matching line</param>
+	/// <param name="skipBinary">If true, a binary file is not searched</param>
+	/// <param name="output">The buffer to add the matching lines to</param>
+	/// <param name="fd">The file descriptor the output is written to as the search goes, or -1 to
+	/// keep all of it in the buffer</param>
+	/// <returns>The number of matching lines found</returns>
+	size_t SearchBlocks(InputFile& file, std::string_view linePrefix, bool skipBinary, OutputBuffer& output,
+		int fd) const;
+
+	/// <summary>
+	/// Returns true if the start of a file looks like binary data rather than text
+	/// </summary>
+	/// <param name="block">The first block of the file</param>
+	/// <returns></returns>
+	static bool IsBinary(std::string_view block);
+
+	/// <summary>
+	/// Searches the chunks of a block on the worker threads. The output of each chunk is buffered
+	/// until every chunk before it has been written, so lines are written in their original order.
+	/// </summary>
+	/// <param name="block">The block to search</param>
+	/// <param name="bounds">The chunks of the block, see SplitBlock</param>
+	/// <param name="fd">The file descriptor to write matching lines to</param>
+	/// <returns>The number of matching lines</returns>
+	size_t SearchParallel(std::string_view block, const std::vector<size_t>& bounds, int fd) const;
+
+	/// <summary>
+	/// The reader stage of SearchStream. Reads a file into the blocks it gets back from the writer, and
+	/// hands on its whole lines once a read returns less than it asked for, or the block is full. The
+	/// line the block ends in is moved into the next block.
+	/// </summary>
+	/// <param name="file">The file to read</param>
+	/// <param name="filled">The queue to the matcher, which gets a block with isEnd set last</param>
+	/// <param name="emptied">The queue of blocks that have been written</param>
+	static void ReadBlocks(InputFile& file, SpscQueue<Block>& filled, SpscQueue<Block>& emptied);
+
+	/// <summary>
+	/// The writer stage of SearchStream. Writes the matching lines of each block it is given, then
+	/// hands the block back to the reader.
+	/// </summary>
+	/// <param name="fd">The file descriptor to write to</param>
+	/// <param name="searched">The queue from the matcher, which ends with a block with isEnd set</param>
+	/// <param name="emptied">The queue back to the reader</param>
+	static void WriteBlocks(int fd, SpscQueue<Block>& searched, SpscQueue<Block>& emptied);
+
+	/// <summary>
+	/// Searches a file that is read rather than mapped, such as a pipe, as a pipeline of three threads:
+	/// a reader, the matcher on the calling thread, and a writer. They pass a few recycled blocks round
+	/// through lock-free queues, so reading, matching and writing overlap, and a pipe is searched as
+	/// fast as the slowest of them.
+	/// </summary>
+	/// <param name="file">The file to search</param>
+	/// <param name="fd">The file descriptor to write matching lines to</param>
+	/// <returns>The number of matching lines</returns>
+	size_t SearchStream(InputFile& file, int fd) const;
+
+public:
+
+	/// <summary>
+	/// Creates a searcher. The regex is shared by all of the worker threads, and must
+	/// outlive the searcher.
+	/// </summary>
+	/// <param name="regex">The regex to search for</param>
+	/// <param name="numThreads">The number of threads to search each file with</param>
+	/// <param name="printPatterns">If true, each matching line is prefixed with the ids of the patterns
+	/// it matches, separated by commas</param>
+	/// <param name="highlight">How the matches in each line are shown</param>
+	/// <param name="mode">What is written for each file</param>
+	/// <param name="maxLines">How many matching lines of a file are found before its search stops</param>
+	Searcher(const Regex& regex, int numThreads, bool printPatterns = false,
+		OutputBuffer::Highlight highlight = OutputBuffer::Highlight::UpperCase, Mode mode = Mode::Lines,
+		size_t maxLines = NO_LIMIT);
+
+	/// <summary>
+	/// Searches a file, writing each line that matches to fd with its matches highlighted, or what
+	/// else the mode asks for. A mapped file is split between the threads, any other file is searched
+	/// by SearchStream. A search that stops early is run on the calling thread.
+	/// </summary>
+	/// <param name="file">The file to search</param>
+	/// <param name="name">The name of the file, written in Mode::Files</param>
+	/// <param name="fd">The file descriptor to write matching lines to</param>
+	/// <returns>The number of matching lines found</returns>
+	size_t Search(InputFile& file, std::string_view name, int fd) const;
+
+	/// <summary>
+	/// Searches a file on the calling thread for its matching lines. Binary files are skipped.
+	/// </summary>
+	/// <param name="file">The file to search, which must stay open until the output is written</param>
+	/// <param name="linePrefix">Text written before each matching line</param>
+	/// <param name="output">The buffer to add the matching lines to</param>
+	/// <returns>The number of matching lines found</returns>
+	size_t Search(InputFile& file, std::string_view linePrefix, OutputBuffer& output) const;
+
+	/// <summary>
+	/// Searches many files at once, using a pool of numThreads threads. The lines of each file are
+	/// written together, prefixed by the name of the file, in the order the paths are given and
+	/// directories are listed, so every run writes the same output.
+	/// </summary>
+	/// <param name="paths">The files to search</param>
+	/// <param name="recursive">If true, directories are searched for files to search. Otherwise
+	/// they are reported as errors.</param>
+	/// <param name="fd">The file descriptor to write matching lines to</param>
+	/// <param name="outFound">Output parameter that is set to true if a line matched. In Mode::Quiet
+	/// no more files are searched once one has.</param>
+	/// <returns>False if any path could not be searched</returns>
+	bool Search(const std::vector<std::string>& paths, bool recursive, int fd, bool& outFound) const;
+};
@@ -0,0 +1,147 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/// <summary>
+/// A bounded queue between exactly one producer thread and one consumer thread. It is a ring of
+/// slots with a head moved only by the consumer and a tail moved only by the producer, so neither
+/// side ever takes a lock. Items are moved in and out, so buffers passed through it keep their memory.
+/// </summary>
+template <typename T>
+class SpscQueue
+{
+private:
+	// how often a blocked side retries before it yields, and before it sleeps
+	static const int NUM_SPINS = 64;
+	static const int NUM_YIELDS = 64;
+
+	std::vector<T> slots;
+	size_t mask;
+
+	// the next slot to pop, written by the consumer. Kept on its own cache line, apart from tail,
+	// so the two threads do not take the line from each other on every push and pop
+	alignas(64) std::atomic<size_t> head{ 0 };
+
+	// the next slot to push to, written by the producer
+	alignas(64) std::atomic<size_t> tail{ 0 };
+
+	/// <summary>
+	/// Waits a little longer each time a side finds the queue full or empty, so a stage that waits
+	/// for a slow one does not take a core from it
+	/// </summary>
+	/// <param name="numTries">How often the side has tried so far, counted up to when it starts sleeping</param>
+	static void Wait(int& numTries)
+	{
+		if (numTries < NUM_SPINS)
+		{
+			numTries++;
+		}
+		else if (numTries < NUM_SPINS + NUM_YIELDS)
+		{
+			numTries++;
+			std::this_thread::yield();
+		}
+		else
+		{
+			std::this_thread::sleep_for(std::chrono::microseconds(50));
+		}
+	}
+
+public:
+
+	/// <summary>
+	/// Creates an empty queue
+	/// </summary>
+	/// <param name="capacity">The most items it holds, rounded up to a power of two</param>
+	SpscQueue(size_t capacity)
+	{
+		size_t size = 1;
+		while (size < capacity)
+		{
+			size *= 2;
+		}
+
+		slots.resize(size);
+		mask = size - 1;
+	}
+
+	SpscQueue(const SpscQueue&) = delete;
+	SpscQueue& operator=(const SpscQueue&) = delete;
+
+	/// <summary>
+	/// Returns the most items the queue holds
+	/// </summary>
+	/// <returns></returns>
+	size_t Capacity() const { return slots.size(); }
+
+	/// <summary>
+	/// Adds an item at the back of the queue unless it is full. Only called by the producer.
+	/// </summary>
+	/// <param name="item">The item, which is moved from only if it was added</param>
+	/// <returns>False if the queue was full</returns>
+	bool TryPush(T& item)
+	{
+		size_t position = tail.load(std::memory_order_relaxed);
+		if (position - head.load(std::memory_order_acquire) == slots.size())
+		{
+			return false;
+		}
+
+		// the release makes the item visible to the consumer before the slot is
+		slots[position & mask] = std::move(item);
+		tail.store(position + 1, std::memory_order_release);
+		return true;
+	}
+
+	/// <summary>
+	/// Takes the item at the front of the queue unless it is empty. Only called by the consumer.
+	/// </summary>
+	/// <param name="outItem">Set to the item</param>
+	/// <returns>False if the queue was empty</returns>
+	bool TryPop(T& outItem)
+	{
+		size_t position = head.load(std::memory_order_relaxed);
+		if (position == tail.load(std::memory_order_acquire))
+		{
+			return false;
+		}
+
+		// the release hands the slot back to the producer only once the item is out of it
+		outItem = std::move(slots[position & mask]);
+		head.store(position + 1, std::memory_order_release);
+		return true;
+	}
+
+	/// <summary>
+	/// Adds an item at the back of the queue, waiting while it is full
+	/// </summary>
+	/// <param name="item"></param>
+	void Push(T item)
+	{
+		int numTries = 0;
+		while (!TryPush(item))
+		{
+			Wait(numTries);
+		}
+	}
+
+	/// <summary>
+	/// Takes the item at the front of the queue, waiting while it is empty
+	/// </summary>
+	/// <returns></returns>
+	T Pop()
+	{
+		T item;
+		int numTries = 0;
+		while (!TryPop(item))
+		{
+			Wait(numTries);
+		}
+
+		return item;
+	}
+};
@@ -0,0 +1,962 @@
+#pragma once
+#include "ByteScanner.h"
+#include "Parser.h"
+#include "Regex.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+/// <summary>
+/// A set of NFA states that can be built while compiling
+/// </summary>
+template <size_t MaxStates>
+class StaticStateSet
+{
+private:
+	static constexpr size_t NUM_WORDS = MaxStates / 64 + 1;
+	uint64_t words[NUM_WORDS] = {};
+
+public:
+	constexpr void Add(int state) { words[state / 64] |= (uint64_t)1 << (state % 64); }
+	constexpr bool Contains(int state) const { return (words[state / 64] >> (state % 64)) & 1; }
+
+	constexpr void AddAll(const StaticStateSet& other)
+	{
+		for (size_t i = 0; i < NUM_WORDS; ++i)
+		{
+			words[i] |= other.words[i];
+		}
+	}
+
+	constexpr void RemoveAll(const StaticStateSet& other)
+	{
+		for (size_t i = 0; i < NUM_WORDS; ++i)
+		{
+			words[i] &= ~other.words[i];
+		}
+	}
+
+	constexpr bool IsEmpty() const
+	{
+		for (size_t i = 0; i < NUM_WORDS; ++i)
+		{
+			if (words[i] != 0)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+};
+
+/// <summary>
+/// An NFA built with Thompson's construction while compiling. Every state has at most one arrow
+/// that consumes input and at most two epsilon arrows, so they fit in fixed arrays.
+/// </summary>
+template <size_t MaxStates>
+struct StaticNFA
+{
+	static constexpr int NONE = -1;
+
+	int numStates = 0;
+	int start = 0;
+	int final = 0;
+
+	// the arrow that consumes input leaving each state, NONE if there is none
+	char input[MaxStates] = {};
+	int inputTarget[MaxStates] = {};
+
+	int epsilonTargets[MaxStates][2] = {};
+
+	// the states each state reaches through epsilon arrows, including itself
+	StaticStateSet<MaxStates> closures[MaxStates] = {};
+
+	// bytes that no arrow tells apart share a class, numbered in byte order like ByteClasses
+	uint8_t classes[256] = {};
+	int numClasses = 1;
+
+	constexpr int AddState()
+	{
+		if (numStates == (int)MaxStates)
+		{
+			throw std::length_error("too many states for a StaticNFA");
+		}
+
+		input[numStates] = '\0';
+		inputTarget[numStates] = NONE;
+		epsilonTargets[numStates][0] = epsilonTargets[numStates][1] = NONE;
+		return numStates++;
+	}
+
+	constexpr void AddEpsilon(int from, int to)
+	{
+		int slot = epsilonTargets[from][0] == NONE ? 0 : 1;
+		if (epsilonTargets[from][slot] != NONE)
+		{
+			throw std::logic_error("a StaticNFA state has more than two epsilon arrows");
+		}
+		epsilonTargets[from][slot] = to;
+	}
+
+	/// <summary>
+	/// Finds the closures and the byte classes, once every arrow has been added
+	/// </summary>
+	constexpr void Finish()
+	{
+		for (int state = 0; state < numStates; ++state)
+		{
+			int stack[MaxStates] = {};
+			int size = 0;
+			closures[state] = StaticStateSet<MaxStates>();
+			closures[state].Add(state);
+			stack[size++] = state;
+			while (size > 0)
+			{
+				int from = stack[--size];
+				for (int to : epsilonTargets[from])
+				{
+					if (to != NONE && !closures[state].Contains(to))
+					{
+						closures[state].Add(to);
+						stack[size++] = to;
+					}
+				}
+			}
+		}
+
+		bool used[256] = {};
+		for (int state = 0; state < numStates; ++state)
+		{
+			char label = input[state];
+			bool isSpecial = label == Regex::LINE_START || label == Regex::LINE_END || label == Regex::ANY;
+			if (inputTarget[state] != NONE && !isSpecial)
+			{
+				used[(unsigned char)label] = true;
+			}
+		}
+
+		numClasses = 1;
+		for (int byte = 0; byte < 256; ++byte)
+		{
+			classes[byte] = used[byte] ? (uint8_t)numClasses++ : 0;
+		}
+	}
+
+	/// <summary>
+	/// Returns the NFA with every arrow flipped, and the start and final states traded
+	/// </summary>
+	/// <returns></returns>
+	constexpr StaticNFA Reverse() const
+	{
+		StaticNFA reversed;
+		for (int state = 0; state < numStates; ++state)
+		{
+			reversed.AddState();
+		}
+
+		for (int state = 0; state < numStates; ++state)
+		{
+			if (inputTarget[state] != NONE)
+			{
+				// only the end of a single character fragment is reached by input, and only from its start
+				reversed.input[inputTarget[state]] = input[state];
+				reversed.inputTarget[inputTarget[state]] = state;
+			}
+			for (int to : epsilonTargets[state])
+			{
+				if (to != NONE)
+				{
+					reversed.AddEpsilon(to, state);
+				}
+			}
+		}
+
+		reversed.start = final;
+		reversed.final = start;
+		reversed.Finish();
+		return reversed;
+	}
+};
+
+/// <summary>
+/// Parses a regular expression into a StaticNFA while compiling. Accepts the same expressions as
+/// Parser, and reports the same errors.
+/// </summary>
+template <size_t MaxStates>
+class StaticParser
+{
+private:
+	struct Fragment
+	{
+		int start;
+		int end;
+	};
+
+	std::string_view text;
+	size_t position = 0;
+	StaticNFA<MaxStates> nfa;
+
+	constexpr StaticParser(std::string_view text)
+		: text(text)
+	{ }
+
+	constexpr Fragment Single(char input)
+	{
+		Fragment fragment = { nfa.AddState(), nfa.AddState() };
+		nfa.input[fragment.start] = input;
+		nfa.inputTarget[fragment.start] = fragment.end;
+		return fragment;
+	}
+
+	constexpr Fragment Empty()
+	{
+		Fragment fragment = { nfa.AddState(), nfa.AddState() };
+		nfa.AddEpsilon(fragment.start, fragment.end);
+		return fragment;
+	}
+
+	constexpr Fragment Wrap(Fragment inner, bool canSkip, bool canRepeat)
+	{
+		Fragment fragment = { nfa.AddState(), nfa.AddState() };
+		nfa.AddEpsilon(fragment.start, inner.start);
+		if (canSkip)
+		{
+			nfa.AddEpsilon(fragment.start, fragment.end);
+		}
+		if (canRepeat)
+		{
+			nfa.AddEpsilon(inner.end, inner.start);
+		}
+		nfa.AddEpsilon(inner.end, fragment.end);
+		return fragment;
+	}
+
+	constexpr Fragment ParseUnion()
+	{
+		Fragment fragment = ParseConcatenation();
+		while (position < text.size() && text[position] == '|')
+		{
+			++position;
+			Fragment alternative = ParseConcatenation();
+
+			Fragment both = { nfa.AddState(), nfa.AddState() };
+			nfa.AddEpsilon(both.start, fragment.start);
+			nfa.AddEpsilon(both.start, alternative.start);
+			nfa.AddEpsilon(fragment.end, both.end);
+			nfa.AddEpsilon(alternative.end, both.end);
+			fragment = both;
+		}
+
+		return fragment;
+	}
+
+	constexpr Fragment ParseConcatenation()
+	{
+		Fragment fragment = { StaticNFA<MaxStates>::NONE, StaticNFA<MaxStates>::NONE };
+		while (position < text.size() && text[position] != '|' && text[position] != ')')
+		{
+			Fragment piece = ParseRepetition();
+			if (fragment.start == StaticNFA<MaxStates>::NONE)
+			{
+				fragment = piece;
+			}
+			else
+			{
+				nfa.AddEpsilon(fragment.end, piece.start);
+				fragment.end = piece.end;
+			}
+		}
+
+		// an empty alternative, or an empty group, matches the empty string
+		return fragment.start == StaticNFA<MaxStates>::NONE ? Empty() : fragment;
+	}
+
+	constexpr Fragment ParseRepetition()
+	{
+		Fragment atom = ParseAtom();
+
+		// a chain of operators is collapsed the way Parser does it
+		char repetition = '\0';
+		while (position < text.size() && (text[position] == '*' || text[position] == '+' || text[position] == '?'))
+		{
+			repetition = repetition == '\0' || repetition == text[position] ? text[position] : '*';
+			++position;
+		}
+
+		if (repetition == '\0')
+		{
+			return atom;
+		}
+		return Wrap(atom, repetition != '+', repetition != '?');
+	}
+
+	constexpr Fragment ParseAtom()
+	{
+		size_t start = position;
+		char input = text[position++];
+
+		if (input == '(')
+		{
+			Fragment group = ParseUnion();
+			if (position >= text.size())
+			{
+				throw ParseError("missing ) to close (", start);
+			}
+
+			++position;
+			return group;
+		}
+		else if (input == '*' || input == '+' || input == '?')
+		{
+			throw ParseError(std::string("nothing to repeat before ") + input, start);
+		}
+		else if (input == '^')
+		{
+			input = Regex::LINE_START;
+		}
+		else if (input == '$')
+		{
+			input = Regex::LINE_END;
+		}
+		else if (input == '.')
+		{
+			input = Regex::ANY;
+		}
+		else if (input == '\\')
+		{
+			if (position >= text.size())
+			{
+				throw ParseError("nothing to escape after \\", start);
+			}
+
+			input = text[position++];
+		}
+
+		return Single(input);
+	}
+
+public:
+
+	/// <summary>
+	/// Parses a regular expression
+	/// </summary>
+	/// <param name="text">The regular expression</param>
+	/// <returns>The NFA</returns>
+	/// <exception cref="ParseError">The regular expression is not valid, which fails the compile
+	/// when it is evaluated as a constant</exception>
+	static constexpr StaticNFA<MaxStates> Parse(std::string_view text)
+	{
+		StaticParser parser(text);
+		Fragment root = parser.ParseUnion();
+		if (parser.position < text.size())
+		{
+			throw ParseError("unmatched )", parser.position);
+		}
+
+		parser.nfa.start = root.start;
+		parser.nfa.final = root.end;
+		parser.nfa.Finish();
+		return parser.nfa;
+	}
+};
+
+/// <summary>
+/// A DFA whose transition table was built while compiling. Has the same interface for running it
+/// as DFA, see there.
+/// </summary>
+template <size_t NumStates, size_t NumColumns>
+class StaticDFA
+{
+private:
+	std::array<uint8_t, 256> classes;
+	std::array<uint16_t, (NumStates + 1) * NumColumns> table;
+	std::array<bool, NumStates + 1> accepting;
+	uint32_t start;
+
+	static constexpr size_t LINE_START_COLUMN = NumColumns - 2;
+	static constexpr size_t LINE_END_COLUMN = NumColumns - 1;
+
+public:
+	constexpr StaticDFA(const std::array<uint8_t, 256>& classes, const std::array<uint16_t, (NumStates + 1) * NumColumns>& table,
+		const std::array<bool, NumStates + 1>& accepting, uint32_t start)
+		: classes(classes), table(table), accepting(accepting), start(start)
+	{ }
+
+	constexpr uint32_t StartState() const { return start; }
+	constexpr uint32_t Next(uint32_t state, char input) const { return table[state * NumColumns + classes[(unsigned char)input]]; }
+	constexpr uint32_t NextLineStart(uint32_t state) const { return table[state * NumColumns + LINE_START_COLUMN]; }
+	constexpr uint32_t NextLineEnd(uint32_t state) const { return table[state * NumColumns + LINE_END_COLUMN]; }
+	constexpr bool IsDead(uint32_t state) const { return state == NumStates; }
+	constexpr bool IsAccepting(uint32_t state) const { return accepting[state]; }
+};
+
+/// <summary>
+/// Runs the subset construction on a StaticNFA while compiling, the same way NFA::Determinize does
+/// for an anchored or a leftmost search. The DFA is not minimized.
+/// </summary>
+template <size_t MaxStates>
+class StaticSubsetConstruction
+{
+public:
+
+	// the most states a DFA built while compiling may have. Bigger ones belong in a Regex
+	static constexpr int MAX_DFA_STATES = 256;
+
+	static constexpr int DEAD = -1;
+
+	// every byte class but class 0 labels an arrow, and each state has at most one such arrow.
+	// The line markers have a column each
+	static constexpr size_t MAX_COLUMNS = (MaxStates < 256 ? MaxStates : 256) + 2;
+
+private:
+
+	// a row of the subset construction table, as in NFA::Determinize. Entry 0 is nonzero while
+	// new threads are started, and is followed by groups of states each terminated by -1
+	struct Row
+	{
+		int16_t ids[2 * MaxStates + 2] = {};
+		int length = 0;
+
+		constexpr bool operator==(const Row& other) const
+		{
+			if (length != other.length)
+			{
+				return false;
+			}
+			for (int i = 0; i < length; ++i)
+			{
+				if (ids[i] != other.ids[i])
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+	};
+
+	using StateSet = StaticStateSet<MaxStates>;
+
+	const StaticNFA<MaxStates>& nfa;
+	int lineStartColumn;
+	int lineEndColumn;
+
+	constexpr StaticSubsetConstruction(const StaticNFA<MaxStates>& nfa)
+		: nfa(nfa), lineStartColumn(nfa.numClasses), lineEndColumn(nfa.numClasses + 1)
+	{ }
+
+	constexpr StateSet Closure(const StateSet& states) const
+	{
+		StateSet closure;
+		for (int state = 0; state < nfa.numStates; ++state)
+		{
+			if (states.Contains(state))
+			{
+				closure.AddAll(nfa.closures[state]);
+			}
+		}
+		return closure;
+	}
+
+	constexpr bool Takes(int state, int column) const
+	{
+		char label = nfa.input[state];
+		if (nfa.inputTarget[state] == StaticNFA<MaxStates>::NONE)
+		{
+			return false;
+		}
+		if (column == lineStartColumn)
+		{
+			return label == Regex::LINE_START;
+		}
+		if (column == lineEndColumn)
+		{
+			return label == Regex::LINE_END;
+		}
+		return label == Regex::ANY || (column != 0 && nfa.classes[(unsigned char)label] == column &&
+			label != Regex::LINE_START && label != Regex::LINE_END);
+	}
+
+	/// <summary>
+	/// Adds the states of a group that are not in an earlier group to a row
+	/// </summary>
+	/// <returns>True if the final state was added</returns>
+	constexpr bool AppendGroup(StateSet group, StateSet& seen, Row& row) const
+	{
+		group.RemoveAll(seen);
+		if (group.IsEmpty())
+		{
+			return false;
+		}
+
+		for (int state = 0; state < nfa.numStates; ++state)
+		{
+			if (group.Contains(state))
+			{
+				row.ids[row.length++] = (int16_t)state;
+			}
+		}
+		row.ids[row.length++] = -1;
+		seen.AddAll(group);
+		return group.Contains(nfa.final);
+	}
+
+	constexpr Row StartRow(bool leftmost) const
+	{
+		Row row;
+		row.ids[row.length++] = leftmost ? 1 : 0;
+		StateSet seen;
+		if (AppendGroup(nfa.closures[nfa.start], seen, row))
+		{
+			row.ids[0] = 0;
+		}
+		return row;
+	}
+
+	constexpr Row LineStartRow() const
+	{
+		// the start of a line has no width, so threads that started before and after it are one group
+		StateSet lineStart;
+		lineStart.Add(nfa.start);
+		for (int state = 0; state < nfa.numStates; ++state)
+		{
+			if (nfa.closures[nfa.start].Contains(state) && Takes(state, lineStartColumn))
+			{
+				lineStart.Add(nfa.inputTarget[state]);
+			}
+		}
+
+		Row row;
+		row.ids[row.length++] = 1;
+		StateSet seen;
+		if (AppendGroup(Closure(lineStart), seen, row))
+		{
+			row.ids[0] = 0;
+		}
+		return row;
+	}
+
+	constexpr Row StepRow(const Row& row, int column) const
+	{
+		Row next;
+		next.ids[next.length++] = row.ids[0];
+		StateSet seen;
+		StateSet group;
+		bool matched = false;
+
+		// advance each group in order, stopping early if one reaches the final state
+		for (int i = 1; i < row.length && !matched; ++i)
+		{
+			int state = row.ids[i];
+			if (state != -1)
+			{
+				if (Takes(state, column))
+				{
+					group.Add(nfa.inputTarget[state]);
+				}
+				continue;
+			}
+
+			matched = AppendGroup(Closure(group), seen, next);
+			group = StateSet();
+		}
+
+		// an unanchored search starts a new group at every position until a match is found
+		if (next.ids[0] != 0 && !matched)
+		{
+			matched = AppendGroup(nfa.closures[nfa.start], seen, next);
+		}
+
+		if (matched)
+		{
+			next.ids[0] = 0;
+		}
+		return next;
+	}
+
+	constexpr bool IsFinal(const Row& row) const
+	{
+		for (int i = 1; i < row.length; ++i)
+		{
+			if (row.ids[i] == nfa.final)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+public:
+
+	/// <summary>
+	/// The DFA before it is packed into a StaticDFA of its exact size
+	/// </summary>
+	struct Result
+	{
+		int numStates = 0;
+		int numColumns = 0;
+		int transitions[MAX_DFA_STATES][MAX_COLUMNS] = {};
+		bool accepting[MAX_DFA_STATES] = {};
+	};
+
+	/// <summary>
+	/// Converts an NFA to a DFA
+	/// </summary>
+	/// <param name="nfa"></param>
+	/// <param name="leftmost">True for a search DFA that finds matches starting anywhere, see
+	/// NFA::Search::Leftmost. Otherwise matches must start where the DFA starts.</param>
+	/// <returns></returns>
+	static constexpr Result Determinize(const StaticNFA<MaxStates>& nfa, bool leftmost)
+	{
+		StaticSubsetConstruction construction(nfa);
+		Result result;
+		result.numColumns = nfa.numClasses + 2;
+
+		Row rows[MAX_DFA_STATES] = {};
+		rows[result.numStates++] = construction.StartRow(leftmost);
+
+		for (int i = 0; i < result.numStates; ++i)
+		{
+			result.accepting[i] = construction.IsFinal(rows[i]);
+			for (int column = 0; column < result.numColumns; ++column)
+			{
+				Row next = leftmost && i == 0 && column == construction.lineStartColumn ?
+					construction.LineStartRow() :
+					construction.StepRow(rows[i], column);
+
+				// no groups left and no new ones will be started
+				if (next.length == 1 && next.ids[0] == 0)
+				{
+					result.transitions[i][column] = DEAD;
+					continue;
+				}
+
+				int target = 0;
+				while (target < result.numStates && !(rows[target] == next))
+				{
+					++target;
+				}
+				if (target == result.numStates)
+				{
+					if (result.numStates == MAX_DFA_STATES)
+					{
+						throw std::length_error("too many states for a StaticRegex, use Regex instead");
+					}
+					rows[result.numStates++] = next;
+				}
+				result.transitions[i][column] = target;
+			}
+		}
+
+		return result;
+	}
+
+	/// <summary>
+	/// Packs the result of the subset construction into a StaticDFA of its exact size, with a
+	/// last row for the dead state
+	/// </summary>
+	/// <param name="result"></param>
+	/// <param name="nfa">The NFA the result was built from</param>
+	/// <returns></returns>
+	template <size_t NumStates, size_t NumColumns>
+	static constexpr StaticDFA<NumStates, NumColumns> Pack(const Result& result, const StaticNFA<MaxStates>& nfa)
+	{
+		std::array<uint8_t, 256> classes = {};
+		for (size_t byte = 0; byte < 256; ++byte)
+		{
+			classes[byte] = nfa.classes[byte];
+		}
+
+		std::array<uint16_t, (NumStates + 1) * NumColumns> table = {};
+		std::array<bool, NumStates + 1> accepting = {};
+		for (size_t state = 0; state <= NumStates; ++state)
+		{
+			for (size_t column = 0; column < NumColumns; ++column)
+			{
+				int next = state < NumStates ? result.transitions[state][column] : DEAD;
+				table[state * NumColumns + column] = (uint16_t)(next == DEAD ? NumStates : next);
+			}
+			accepting[state] = state < NumStates && result.accepting[state];
+		}
+
+		return StaticDFA<NumStates, NumColumns>(classes, table, accepting, 0);
+	}
+};
+
+/// <summary>
+/// A regular expression that is compiled along with the program. The expression is parsed, turned
+/// into an NFA and then into dfas while the compiler evaluates constants, so nothing is built at run
+/// time and the compiler sees the transition tables. An invalid expression fails the compile.
+///
+/// Accepts the same expressions as Regex::Parse and finds the same matches. Meant for small fixed
+/// expressions, since the constant evaluation is far slower than building a Regex: the dfas may
+/// have at most StaticSubsetConstruction::MAX_DFA_STATES states, and some compilers need their
+/// limit on constant evaluation steps raised for expressions longer than a few dozen characters.
+/// C++17 does not take a string literal as a template argument, so the expression is given as an
+/// array with static storage:
+///
+///     static constexpr char ERRORS[] = "(ERROR|FATAL):";
+///     StaticRegex&lt;ERRORS&gt;::Match(line, matches);
+/// </summary>
+template <const char* Pattern>
+class StaticRegex
+{
+private:
+	static constexpr size_t MAX_NFA_STATES = 4 * std::string_view(Pattern).size() + 4;
+
+	static constexpr StaticNFA<MAX_NFA_STATES> FORWARD_NFA = StaticParser<MAX_NFA_STATES>::Parse(Pattern);
+	static constexpr StaticNFA<MAX_NFA_STATES> REVERSE_NFA = FORWARD_NFA.Reverse();
+
+	using Construction = StaticSubsetConstruction<MAX_NFA_STATES>;
+	static constexpr typename Construction::Result SEARCH = Construction::Determinize(FORWARD_NFA, true);
+	static constexpr typename Construction::Result REVERSE = Construction::Determinize(REVERSE_NFA, false);
+
+	static constexpr auto SEARCH_DFA = Construction::template Pack<SEARCH.numStates, SEARCH.numColumns>(SEARCH, FORWARD_NFA);
+	static constexpr auto REVERSE_DFA = Construction::template Pack<REVERSE.numStates, REVERSE.numColumns>(REVERSE, REVERSE_NFA);
+
+	/// <summary>
+	/// The bytes that leave the start state of the search dfa, as in Regex
+	/// </summary>
+	struct StartBytes
+	{
+		char bytes[ByteScanner::MAX_BYTES + 1] = {};
+		size_t size = 0;
+	};
+
+	static constexpr StartBytes FindStartBytes()
+	{
+		StartBytes startBytes;
+		uint32_t start = SEARCH_DFA.StartState();
+		for (int c = 0; c < 256 && startBytes.size <= ByteScanner::MAX_BYTES; ++c)
+		{
+			if (SEARCH_DFA.Next(start, (char)c) != start)
+			{
+				startBytes.bytes[startBytes.size++] = (char)c;
+			}
+		}
+		return startBytes;
+	}
+
+	static constexpr StartBytes START_BYTES = FindStartBytes();
+
+	// the text that stays in the start state is skipped with a scanner when there are few enough bytes
+	// that leave it. The bytes are found while compiling, only the scanner is set up at run time
+	static constexpr bool CAN_SKIP_START = START_BYTES.size <= ByteScanner::MAX_BYTES &&
+		!SEARCH_DFA.IsAccepting(SEARCH_DFA.StartState());
+
+	static const ByteScanner& StartScanner()
+	{
+		static const ByteScanner scanner(std::string(START_BYTES.bytes, CAN_SKIP_START ? START_BYTES.size : 0));
+		return scanner;
+	}
+
+	// the search dfa accepts before reading anything when the pattern matches the empty string, so
+	// a final state does not always end a match that Match would report
+	static constexpr bool MATCHES_EMPTY = SEARCH_DFA.IsAccepting(SEARCH_DFA.StartState()) ||
+		SEARCH_DFA.IsAccepting(SEARCH_DFA.NextLineStart(SEARCH_DFA.StartState())) ||
+		SEARCH_DFA.IsAccepting(SEARCH_DFA.NextLineEnd(SEARCH_DFA.StartState())) ||
+		SEARCH_DFA.IsAccepting(SEARCH_DFA.NextLineEnd(SEARCH_DFA.NextLineStart(SEARCH_DFA.StartState())));
+
+	/// <summary>
+	/// Finds the leftmost-longest match that starts at or after start, which may be empty
+	/// </summary>
+	/// <param name="text">The line to match, without a line terminator</param>
+	/// <param name="start"></param>
+	/// <param name="skip">Returns how many bytes of the text it is given can not begin a match, or 0
+	/// to read them all</param>
+	/// <param name="outStart">Output parameter set to where the match starts</param>
+	/// <param name="outEnd">Output parameter set to where the match ends</param>
+	/// <returns>False if there is none</returns>
+	template <typename Skip>
+	static constexpr bool FindMatch(std::string_view text, size_t start, Skip&& skip, size_t& outStart, size_t& outEnd)
+	{
+		const auto& search = SEARCH_DFA;
+		const auto& reverse = REVERSE_DFA;
+
+		// run the search dfa forward until it dies. The last position it accepted
+		// at is the end of the leftmost-longest match
+		bool found = false;
+		bool endsAfterLineEnd = false;
+		size_t end = 0;
+
+		uint32_t state = search.StartState();
+		if (start == 0)
+		{
+			state = search.NextLineStart(state);
+		}
+
+		if (search.IsAccepting(state))
+		{
+			found = true;
+			end = start;
+		}
+
+		size_t i = start;
+		for (; i < text.size() && !search.IsDead(state); ++i)
+		{
+			// skip the text that can not begin a match
+			if (state == search.StartState())
+			{
+				i += skip(text.substr(i));
+				if (i == text.size())
+				{
+					break;
+				}
+			}
+
+			state = search.Next(state, text[i]);
+			if (search.IsAccepting(state))
+			{
+				found = true;
+				end = i + 1;
+			}
+		}
+
+		if (!search.IsDead(state))
+		{
+			state = search.NextLineEnd(state);
+			if (search.IsAccepting(state))
+			{
+				found = true;
+				end = text.size();
+				endsAfterLineEnd = true;
+			}
+		}
+
+		if (!found)
+		{
+			return false;
+		}
+
+		// run the reverse dfa backwards from the end of the match. The last position
+		// it accepted at is where the match started
+		size_t matchStart = end;
+		state = reverse.StartState();
+
+		if (endsAfterLineEnd)
+		{
+			state = reverse.NextLineEnd(state);
+		}
+
+		for (i = end; i > start && !reverse.IsDead(state); --i)
+		{
+			state = reverse.Next(state, text[i - 1]);
+			if (reverse.IsAccepting(state))
+			{
+				matchStart = i - 1;
+			}
+		}
+
+		if (start == 0 && !reverse.IsDead(state))
+		{
+			state = reverse.NextLineStart(state);
+			if (reverse.IsAccepting(state))
+			{
+				matchStart = 0;
+			}
+		}
+
+		outStart = matchStart;
+		outEnd = end;
+		return true;
+	}
+
+public:
+
+	/// <summary>
+	/// Returns the number of states in the search dfa, which finds where matches end
+	/// </summary>
+	/// <returns></returns>
+	static constexpr int NumSearchStates() { return SEARCH.numStates; }
+
+	/// <summary>
+	/// Returns the number of states in the reverse dfa, which finds where matches start
+	/// </summary>
+	/// <returns></returns>
+	static constexpr int NumReverseStates() { return REVERSE.numStates; }
+
+	/// <summary>
+	/// Matches a line of text, see Regex::Match
+	/// </summary>
+	/// <param name="text">The line to match, without a line terminator</param>
+	/// <param name="outMatches">Output parameter that is cleared, then filled with the non-overlapping,
+	/// leftmost-longest matches in the order they appear. Empty matches are not reported.</param>
+	/// <returns>The number of matches found</returns>
+	static size_t Match(std::string_view text, std::vector<Regex::Span>& outMatches)
+	{
+		outMatches.clear();
+
+		size_t numScans = 0;
+		size_t numSkipped = 0;
+		auto skip = [&](std::string_view rest) -> size_t
+		{
+			if (!CAN_SKIP_START || !ByteScanner::ShouldScan(numScans, numSkipped))
+			{
+				return 0;
+			}
+
+			size_t skipped = StartScanner().Find(rest.data(), rest.size());
+			numScans++;
+			numSkipped += skipped;
+			return skipped;
+		};
+
+		size_t start = 0;
+		size_t matchStart = 0;
+		size_t end = 0;
+		while (start <= text.size() && FindMatch(text, start, skip, matchStart, end))
+		{
+			if (end > matchStart)
+			{
+				outMatches.push_back({ matchStart, end - matchStart });
+			}
+
+			// continue after this match, or one past it if it was empty
+			start = end > matchStart ? end : end + 1;
+		}
+
+		return outMatches.size();
+	}
+
+	/// <summary>
+	/// Returns true if Match would find a match in a line, so an empty match does not count, like
+	/// Regex::IsMatch. Stops at the first position where a match ends unless the pattern matches
+	/// the empty string, and can be evaluated while compiling.
+	/// </summary>
+	/// <param name="text">The line to match, without a line terminator</param>
+	/// <returns></returns>
+	static constexpr bool IsMatch(std::string_view text)
+	{
+		if (MATCHES_EMPTY)
+		{
+			// look for the matches one after another until one is not empty
+			size_t start = 0;
+			size_t matchStart = 0;
+			size_t end = 0;
+			while (start <= text.size() && FindMatch(text, start, [](std::string_view) { return (size_t)0; }, matchStart, end))
+			{
+				if (end > matchStart)
+				{
+					return true;
+				}
+
+				start = end + 1;
+			}
+
+			return false;
+		}
+
+		// any final state ends a match that is not empty
+		const auto& search = SEARCH_DFA;
+		uint32_t state = search.NextLineStart(search.StartState());
+		for (size_t i = 0; i < text.size() && !search.IsAccepting(state); ++i)
+		{
+			state = search.Next(state, text[i]);
+		}
+
+		return search.IsAccepting(state) || search.IsAccepting(search.NextLineEnd(state));
+	}
+};
@@ -0,0 +1,127 @@
+#include "ThreadPool.h"
+#include <algorithm>
+
+// the pool and worker index of the thread running this code, if it is a worker
+static thread_local ThreadPool* currentPool = nullptr;
+static thread_local size_t currentWorker = 0;
+
+ThreadPool::ThreadPool(int numThreads)
+{
+	numThreads = std::max(numThreads, 1);
+
+	for (int i = 0; i < numThreads; ++i)
+	{
+		queues.push_back(std::make_unique<Queue>());
+	}
+
+	for (int i = 0; i < numThreads; ++i)
+	{
+		threads.emplace_back(&ThreadPool::Work, this, (size_t)i);
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	Wait();
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	wake.notify_all();
+
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+}
+
+void ThreadPool::Submit(std::function<void()> task)
+{
+	size_t index = currentPool == this ? currentWorker : nextQueue++ % queues.size();
+
+	// counted under the mutex so a worker deciding to sleep can not miss it, and before
+	// the task is queued so a worker taking it can not see the count drop below zero
+	pending++;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		queued++;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(queues[index]->mutex);
+		queues[index]->tasks.push_back(std::move(task));
+	}
+	wake.notify_one();
+}
+
+void ThreadPool::Wait()
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	idle.wait(lock, [&]() { return pending == 0; });
+}
+
+bool ThreadPool::RunTask(size_t index)
+{
+	std::function<void()> task;
+
+	// newest task from our own queue first, it is the most likely to be in cache
+	{
+		Queue& own = *queues[index];
+		std::lock_guard<std::mutex> lock(own.mutex);
+		if (!own.tasks.empty())
+		{
+			task = std::move(own.tasks.back());
+			own.tasks.pop_back();
+		}
+	}
+
+	// otherwise steal the oldest task from another worker
+	for (size_t i = 1; !task && i < queues.size(); ++i)
+	{
+		Queue& victim = *queues[(index + i) % queues.size()];
+		std::lock_guard<std::mutex> lock(victim.mutex);
+		if (!victim.tasks.empty())
+		{
+			task = std::move(victim.tasks.front());
+			victim.tasks.pop_front();
+		}
+	}
+
+	if (!task)
+	{
+		return false;
+	}
+
+	queued--;
+	task();
+
+	if (--pending == 0)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		idle.notify_all();
+	}
+
+	return true;
+}
+
+void ThreadPool::Work(size_t index)
+{
+	currentPool = this;
+	currentWorker = index;
+
+	while (true)
+	{
+		if (RunTask(index))
+		{
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(mutex);
+		wake.wait(lock, [&]() { return stopping || queued > 0; });
+		if (stopping && queued == 0)
+		{
+			return;
+		}
+	}
+}
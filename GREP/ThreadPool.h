@@ -0,0 +1,79 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool
+{
+private:
+	// each worker has its own queue of tasks. A worker takes tasks from the back of its own
+	// queue, and steals from the front of the other queues when its own is empty.
+	struct Queue
+	{
+		std::deque<std::function<void()>> tasks;
+		std::mutex mutex;
+	};
+
+	std::vector<std::unique_ptr<Queue>> queues;
+	std::vector<std::thread> threads;
+
+	// guards sleeping and waking the workers, and waiting for the pool to be idle
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::condition_variable idle;
+
+	// number of tasks sitting in the queues, and number of tasks not yet finished
+	std::atomic<size_t> queued{ 0 };
+	std::atomic<size_t> pending{ 0 };
+
+	// queue that the next task submitted from outside the pool goes to
+	std::atomic<size_t> nextQueue{ 0 };
+
+	bool stopping = false;
+
+	/// <summary>
+	/// Takes a task from a worker's own queue, or steals one from another queue, and runs it
+	/// </summary>
+	/// <param name="index">The worker's index</param>
+	/// <returns>False if every queue was empty</returns>
+	bool RunTask(size_t index);
+
+	/// <summary>
+	/// The loop run by each worker thread
+	/// </summary>
+	/// <param name="index">The worker's index</param>
+	void Work(size_t index);
+
+public:
+
+	/// <summary>
+	/// Starts a pool of worker threads
+	/// </summary>
+	/// <param name="numThreads">The number of workers</param>
+	ThreadPool(int numThreads);
+
+	/// <summary>
+	/// Waits for every task to finish, then stops the workers
+	/// </summary>
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	/// <summary>
+	/// Adds a task to the pool. Tasks submitted by a task running in the pool go to that worker's
+	/// own queue, so related work stays on one thread unless another worker runs out.
+	/// </summary>
+	/// <param name="task"></param>
+	void Submit(std::function<void()> task);
+
+	/// <summary>
+	/// Blocks until every task submitted so far, and every task they submit, has finished
+	/// </summary>
+	void Wait();
+};
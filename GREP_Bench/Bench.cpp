@@ -0,0 +1,349 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+#include "../GREP/NFABuilder.h"
+#include "../GREP/Parser.h"
+#include "../GREP/Regex.h"
+#include "Corpus.h"
+
+// written by grep --generate LogPattern for LOG_PATTERN, generate it again if the pattern changes
+#include "LogPattern.h"
+
+// every allocation the program makes is counted, so the allocations made while matching show up
+static std::atomic<size_t> numAllocations{ 0 };
+
+// g++ sees the memory of the replaced operator new go to free once operator delete is inlined,
+// and warns even though both sides use malloc
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(size_t size)
+{
+	numAllocations.fetch_add(1, std::memory_order_relaxed);
+	if (void* memory = std::malloc(size > 0 ? size : 1))
+	{
+		return memory;
+	}
+
+	throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+	operator delete(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+	operator delete(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept
+{
+	operator delete(memory);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+static const char* LOG_PATTERN = "(ERROR|WARN|FATAL) (net|disk|auth): .*(timeout|refused)";
+
+// the corpus is made up the same way on every run, so the numbers can be compared between runs
+static const unsigned SEED = 20240611;
+static const int NUM_LINES = 200000;
+static const int NUM_RUNS = 5;
+
+// how often each pattern is compiled, and how often each corpus is searched, for the suite
+static const int NUM_COMPILE_RUNS = 5;
+static const int NUM_SCAN_RUNS = 3;
+
+// the most states the suite lets a dfa have. Far more than Regex builds up front, so the cost of
+// converting a pathological pattern shows
+static const size_t MAX_SUITE_STATES = 100000;
+
+/// <summary>
+/// A pattern of the suite, and the kind of pattern it stands for
+/// </summary>
+struct Pattern
+{
+	const char* kind;
+	std::string text;
+};
+
+/// <summary>
+/// Makes the patterns the suite compiles and searches for
+/// </summary>
+/// <returns></returns>
+static std::vector<Pattern> MakePatterns()
+{
+	// the dfa has to remember the last 13 bytes, so it has 2^13 states and Regex builds it lazily
+	std::string remembering = "(a|b)*a";
+	for (int i = 0; i < 12; ++i)
+	{
+		remembering += "(a|b)";
+	}
+
+	return {
+		{ "literal", "timeout" },
+		{ "literals", "ERROR|FATAL|refused|segfault" },
+		{ "alternation", "(ERROR|WARN) (net|disk)" },
+		{ "anchored", "^#include|;$" },
+		{ "dot-star", ".*error.*timeout.*" },
+		{ "dot-star", "a.*b.*c.*d.*e" },
+		{ "pathological", remembering },
+		{ "pathological", "(x+x+)+y" },
+		{ "pathological", "(.*.*)*=.*;" },
+		{ "empty", "x*" }
+	};
+}
+
+/// <summary>
+/// Runs a function a few times
+/// </summary>
+/// <param name="numRuns"></param>
+/// <param name="function"></param>
+/// <returns>The fastest run in milliseconds</returns>
+template <typename Function>
+static double Time(int numRuns, Function function)
+{
+	double fastest = 0;
+	for (int run = 0; run < numRuns; ++run)
+	{
+		auto begin = std::chrono::steady_clock::now();
+		function();
+		std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - begin;
+		fastest = run == 0 ? elapsed.count() : std::min(fastest, elapsed.count());
+	}
+
+	return fastest;
+}
+
+/// <summary>
+/// Shortens a pattern to fit in a column of the report
+/// </summary>
+/// <param name="text"></param>
+/// <returns></returns>
+static std::string Abbreviate(const std::string& text)
+{
+	return text.size() <= 24 ? text : text.substr(0, 21) + "...";
+}
+
+/// <summary>
+/// Reports how long each step of compiling each pattern takes, and how big its dfas are
+/// </summary>
+/// <param name="patterns"></param>
+static void MeasureCompile(const std::vector<Pattern>& patterns)
+{
+	std::cout << "compile (ms)                  parse     nfa     dfa  minimize   Regex  states  minimized  matcher       kind" << std::endl;
+	std::cout << std::fixed << std::setprecision(3);
+	for (const Pattern& pattern : patterns)
+	{
+		Ast ast;
+		double parse = Time(NUM_COMPILE_RUNS, [&]() { ast = Parser::Parse(pattern.text); });
+
+		NFABuilder builder;
+		NFA nfa = builder.Build(builder.Add(ast, ast.Root()));
+		double build = Time(NUM_COMPILE_RUNS, [&]()
+		{
+			NFABuilder builder;
+			nfa = builder.Build(builder.Add(ast, ast.Root()));
+		});
+
+		// the dfa Regex searches with, built without the limit Regex puts on it
+		DFA dfa = DFA::GenerateEmpty();
+		bool isBuilt = true;
+		double convert = Time(NUM_COMPILE_RUNS, [&]() { isBuilt = nfa.TryConvertToSearchDFA(MAX_SUITE_STATES, dfa); });
+		int numStates = isBuilt ? dfa.NumStates() : 0;
+
+		DFA minimized = dfa;
+		double minimize = Time(NUM_COMPILE_RUNS, [&]()
+		{
+			minimized = dfa;
+			minimized.Minimize();
+		});
+
+		Regex regex;
+		double compile = Time(NUM_COMPILE_RUNS, [&]() { regex = Regex::Parse(pattern.text); });
+
+		const Regex::Statistics& statistics = regex.GetStatistics();
+		const char* matcher = statistics.literalStates > 0 ? "aho-corasick" : statistics.searchStates == 0 ? "lazy" : "table";
+
+		std::cout << std::left << std::setw(26) << Abbreviate(pattern.text) << std::right
+			<< std::setw(9) << parse << std::setw(8) << build;
+		if (isBuilt)
+		{
+			std::cout << std::setw(8) << convert << std::setw(10) << minimize;
+		}
+		else
+		{
+			std::cout << std::setw(8) << "-" << std::setw(10) << "-";
+		}
+		std::cout << std::setw(8) << compile << std::setw(8) << numStates << std::setw(11)
+			<< (isBuilt ? minimized.NumStates() : 0) << "  " << std::left << std::setw(13) << matcher << pattern.kind << std::right << std::endl;
+	}
+	std::cout << std::endl;
+}
+
+/// <summary>
+/// Reports how fast each pattern is matched in each corpus, a line at a time with Match and a block
+/// at a time with FindLine the way grep does, and how often Match allocates
+/// </summary>
+/// <param name="patterns"></param>
+/// <param name="corpora"></param>
+static void MeasureScan(const std::vector<Pattern>& patterns, const std::vector<Corpus>& corpora)
+{
+	std::vector<std::string> texts;
+	for (const Corpus& corpus : corpora)
+	{
+		texts.push_back(corpus.Text());
+	}
+
+	std::cout << "scan (MB/s)              ";
+	for (const Corpus& corpus : corpora)
+	{
+		std::cout << std::setw(9) << corpus.name << " " << std::setw(9) << "FindLine";
+	}
+	std::cout << "  allocs/line   matches" << std::endl;
+
+	std::cout << std::fixed << std::setprecision(1);
+	for (const Pattern& pattern : patterns)
+	{
+		Regex regex = Regex::Parse(pattern.text);
+		std::vector<Regex::Span> matches;
+
+		size_t numLines = 0;
+		size_t numMatches = 0;
+		size_t allocations = 0;
+		std::cout << std::left << std::setw(25) << Abbreviate(pattern.text) << std::right;
+		for (size_t i = 0; i < corpora.size(); ++i)
+		{
+			const Corpus& corpus = corpora[i];
+			double megabytes = (double)corpus.NumBytes() / (1024 * 1024);
+
+			// the first line grows the vector of matches, which is reused after that
+			regex.Match(corpus.lines[0], matches);
+
+			size_t corpusMatches = 0;
+			size_t before = numAllocations.load();
+			double match = Time(NUM_SCAN_RUNS, [&]()
+			{
+				corpusMatches = 0;
+				for (const std::string& line : corpus.lines)
+				{
+					corpusMatches += regex.Match(line, matches);
+				}
+			});
+			allocations += numAllocations.load() - before;
+			numLines += corpus.lines.size() * NUM_SCAN_RUNS;
+			numMatches += corpusMatches;
+
+			const std::string& text = texts[i];
+			double findLine = Time(NUM_SCAN_RUNS, [&]()
+			{
+				Regex::Span line;
+				size_t position = 0;
+				while (regex.FindLine(text, position, line))
+				{
+					position = line.offset + line.length + 1;
+				}
+			});
+
+			std::cout << std::setw(9) << megabytes * 1000 / match << " " << std::setw(9) << megabytes * 1000 / findLine;
+		}
+
+		std::cout << std::setprecision(3) << std::setw(13) << (double)allocations / numLines
+			<< std::setw(10) << numMatches << std::setprecision(1) << std::endl;
+	}
+	std::cout << std::endl;
+}
+
+/// <summary>
+/// Runs a matcher over every line a few times
+/// </summary>
+/// <param name="name">What to call the matcher in the report</param>
+/// <param name="lines"></param>
+/// <param name="match">Returns the number of matches in a line</param>
+/// <returns>The number of matches in all the lines, so the results can be compared</returns>
+template <typename Matcher>
+static size_t Measure(const char* name, const std::vector<std::string>& lines, Matcher match)
+{
+	size_t numBytes = 0;
+	for (const std::string& line : lines)
+	{
+		numBytes += line.size();
+	}
+
+	size_t numMatches = 0;
+	auto begin = std::chrono::steady_clock::now();
+	for (int run = 0; run < NUM_RUNS; ++run)
+	{
+		numMatches = 0;
+		for (const std::string& line : lines)
+		{
+			numMatches += match(line);
+		}
+	}
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+
+	double megabytes = (double)numBytes * NUM_RUNS / (1024 * 1024);
+	std::cout << name << ": " << megabytes / elapsed.count() << " MB/s, " << numMatches << " matches" << std::endl;
+	return numMatches;
+}
+
+int main()
+{
+	// the suite, which compiles and searches for patterns of every kind in text of every kind
+	std::vector<Pattern> patterns = MakePatterns();
+	std::vector<Corpus> corpora = {
+		Corpus::MakeLogLines(60000, SEED),
+		Corpus::MakeSourceCode(100000, SEED),
+		Corpus::MakeLongLines(4, 1024 * 1024, SEED),
+		Corpus::MakeBinary(16000, SEED)
+	};
+
+	MeasureCompile(patterns);
+	MeasureScan(patterns, corpora);
+
+	// the code written by --generate against the table driven dfas
+	std::vector<std::string> lines = Corpus::MakeLogLines(NUM_LINES, SEED).lines;
+	Regex regex = Regex::Parse(LOG_PATTERN);
+
+	std::cout << "pattern: " << LOG_PATTERN << std::endl;
+
+	// the table engine and the generated code should find the same matches
+	std::vector<Regex::Span> spans;
+	size_t tableMatches = Measure("table Match", lines, [&](const std::string& line) { return regex.Match(line, spans); });
+
+	std::vector<LogPattern::Span> generatedSpans;
+	size_t generatedMatches = Measure("generated Match", lines, [&](const std::string& line) { return LogPattern::Match(line, generatedSpans); });
+
+	size_t tableLines = Measure("table IsMatch", lines, [&](const std::string& line) { return (size_t)regex.IsMatch(line); });
+	size_t generatedLines = Measure("generated IsMatch", lines, [&](const std::string& line) { return (size_t)LogPattern::IsMatch(line); });
+
+	if (tableMatches != generatedMatches || tableLines != generatedLines)
+	{
+		std::cerr << "the generated code does not agree with the table engine" << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,161 @@
+#include "Corpus.h"
+
+size_t Corpus::NumBytes() const
+{
+	size_t numBytes = 0;
+	for (const std::string& line : lines)
+	{
+		numBytes += line.size();
+	}
+
+	return numBytes;
+}
+
+std::string Corpus::Text() const
+{
+	std::string text;
+	text.reserve(NumBytes() + lines.size());
+	for (const std::string& line : lines)
+	{
+		text += line;
+		text += '\n';
+	}
+
+	return text;
+}
+
+Corpus Corpus::MakeLogLines(int numLines, unsigned seed)
+{
+	static const char* levels[] = { "DEBUG", "INFO", "INFO", "INFO", "WARN", "ERROR", "FATAL" };
+	static const char* sources[] = { "net", "disk", "auth", "cache", "scheduler" };
+	static const char* endings[] = { "request served", "connection refused", "read timeout", "retrying in 5s", "ok" };
+
+	std::mt19937 random(seed);
+	Corpus corpus = { "log", {} };
+	corpus.lines.reserve(numLines);
+	for (int i = 0; i < numLines; ++i)
+	{
+		std::string line = "2024-06-11 12:" + std::to_string(10 + random() % 50) + ":" + std::to_string(10 + random() % 50) + " ";
+		line += levels[random() % 7];
+		line += " ";
+		line += sources[random() % 5];
+		line += ": id=" + std::to_string(random()) + " user=u" + std::to_string(random() % 1000) + " ";
+		line += endings[random() % 5];
+		corpus.lines.push_back(line);
+	}
+
+	return corpus;
+}
+
+Corpus Corpus::MakeSourceCode(int numLines, unsigned seed)
+{
+	static const char* types[] = { "int", "size_t", "auto", "const std::string&", "bool", "uint32_t" };
+	static const char* names[] = { "state", "offset", "numStates", "result", "text", "matches", "position", "input" };
+	static const char* calls[] = { "Match", "FindLine", "push_back", "size", "NextBlock", "Minimize" };
+	static const char* comments[] = { "skip the text that can not begin a match", "TODO: handle the last line",
+		"the dfa never dies before it has found a match", "return early if the line is empty" };
+
+	std::mt19937 random(seed);
+	Corpus corpus = { "source", {} };
+	corpus.lines.reserve(numLines);
+	for (int i = 0; i < numLines; ++i)
+	{
+		std::string line(random() % 4, '\t');
+		switch (random() % 8)
+		{
+		case 0:
+			line += "#include \"";
+			line += calls[random() % 6];
+			line += ".h\"";
+			break;
+		case 1:
+			line += "// ";
+			line += comments[random() % 4];
+			break;
+		case 2:
+			line += "if (";
+			line += names[random() % 8];
+			line += " == ";
+			line += std::to_string(random() % 100);
+			line += ")";
+			break;
+		case 3:
+			line += "return ";
+			line += names[random() % 8];
+			line += ";";
+			break;
+		case 4:
+			line += random() % 2 == 0 ? "{" : "}";
+			break;
+		case 5:
+			line += "std::cerr << \"grep: could not open ";
+			line += names[random() % 8];
+			line += "\" << std::endl;";
+			break;
+		default:
+			line += types[random() % 6];
+			line += " ";
+			line += names[random() % 8];
+			line += " = ";
+			line += names[random() % 8];
+			line += ".";
+			line += calls[random() % 6];
+			line += "(" + std::to_string(random() % 1000) + ");";
+			break;
+		}
+		corpus.lines.push_back(line);
+	}
+
+	return corpus;
+}
+
+Corpus Corpus::MakeLongLines(int numLines, size_t lineLength, unsigned seed)
+{
+	static const char* words[] = { "alpha", "beta", "gamma", "delta", "error", "value", "x=1;", "timeout", "a", "b" };
+
+	std::mt19937 random(seed);
+	Corpus corpus = { "long", {} };
+	corpus.lines.reserve(numLines);
+	for (int i = 0; i < numLines; ++i)
+	{
+		std::string line;
+		line.reserve(lineLength + 16);
+		while (line.size() < lineLength)
+		{
+			line += words[random() % 10];
+			line += ' ';
+		}
+		corpus.lines.push_back(line);
+	}
+
+	return corpus;
+}
+
+Corpus Corpus::MakeBinary(int numLines, unsigned seed)
+{
+	static const char* words[] = { "ERROR", "timeout", "abba", "\x7f" "ELF" };
+
+	std::mt19937 random(seed);
+	Corpus corpus = { "binary", {} };
+	corpus.lines.reserve(numLines);
+	for (int i = 0; i < numLines; ++i)
+	{
+		// the lines average 256 bytes, about as far apart as the newlines in random data. A newline
+		// that is drawn is made into a word instead, so some lines match the literal patterns
+		std::string line;
+		size_t length = random() % 512;
+		while (line.size() < length)
+		{
+			char byte = (char)(random() % 256);
+			if (byte == '\n')
+			{
+				line += words[random() % 4];
+				continue;
+			}
+			line += byte;
+		}
+		corpus.lines.push_back(line);
+	}
+
+	return corpus;
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <random>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// Made up text to search, split into lines. Each kind is made the same way on every run from a
+/// fixed seed, so the numbers of two runs can be compared.
+/// </summary>
+struct Corpus
+{
+	std::string name;
+	std::vector<std::string> lines;
+
+	/// <summary>
+	/// Returns the number of bytes in the lines, not counting newlines
+	/// </summary>
+	/// <returns></returns>
+	size_t NumBytes() const;
+
+	/// <summary>
+	/// Returns the lines joined by newlines, the way they would be read from a file
+	/// </summary>
+	/// <returns></returns>
+	std::string Text() const;
+
+	/// <summary>
+	/// Makes lines that look like the lines of a log file, such as
+	/// "2024-06-11 12:31:40 ERROR net: id=1804289383 user=u383 read timeout"
+	/// </summary>
+	/// <param name="numLines"></param>
+	/// <param name="seed"></param>
+	/// <returns></returns>
+	static Corpus MakeLogLines(int numLines, unsigned seed);
+
+	/// <summary>
+	/// Makes lines that look like C++ source code, with declarations, calls, comments and strings
+	/// </summary>
+	/// <param name="numLines"></param>
+	/// <param name="seed"></param>
+	/// <returns></returns>
+	static Corpus MakeSourceCode(int numLines, unsigned seed);
+
+	/// <summary>
+	/// Makes a few very long lines of words, such as minified files or dumps with no newlines
+	/// </summary>
+	/// <param name="numLines"></param>
+	/// <param name="lineLength">The length of each line in bytes</param>
+	/// <param name="seed"></param>
+	/// <returns></returns>
+	static Corpus MakeLongLines(int numLines, size_t lineLength, unsigned seed);
+
+	/// <summary>
+	/// Makes lines of random bytes of every value, including NUL and bytes above 127, with a few
+	/// words mixed in
+	/// </summary>
+	/// <param name="numLines"></param>
+	/// <param name="seed"></param>
+	/// <returns></returns>
+	static Corpus MakeBinary(int numLines, unsigned seed);
+};
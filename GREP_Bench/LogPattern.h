@@ -0,0 +1,1951 @@
+// Generated by grep --generate LogPattern. Do not edit, generate it again instead.
+// pattern: (ERROR|WARN|FATAL) (net|disk|auth): .*(timeout|refused)
+#pragma once
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+namespace LogPattern
+{
+	/// <summary>
+	/// The location of a match in the text that was searched
+	/// </summary>
+	struct Span
+	{
+		size_t offset;
+		size_t length;
+	};
+
+	/// <summary>
+	/// Finds the end of the leftmost-longest match that starts at or after start
+	/// </summary>
+	/// <returns>False if there is none</returns>
+	inline bool FindEnd(std::string_view text, size_t start, size_t& outEnd, bool& outEndsAfterLineEnd)
+	{
+		const unsigned char* data = (const unsigned char*)text.data();
+		size_t size = text.size();
+		size_t i = start;
+		bool found = false;
+		outEnd = 0;
+		outEndsAfterLineEnd = false;
+
+		if (start == 0)
+		{
+			goto search33;
+		}
+		goto search33;
+
+	search0:
+		found = true;
+		outEnd = i;
+		if (i == size)
+		{
+			return found;
+		}
+		switch (data[i++])
+		{
+		case 't': goto search7;
+		case 'r': goto search15;
+		default: goto search11;
+		}
+
+	search1:
+		if (i == size)
+		{
+			return found;
+		}
+		switch (data[i++])
+		{
+		case 'd': goto search0;
+		case 't': goto search7;
+		case 'r': goto search15;
+		default: goto search11;
+		}
+
+	search2:
+		if (i == size)
+		{
+			return found;
+		}
+		switch (data[i++])
+		{
+		case 't': goto search8;
+		case 'r': goto search15;
+		default: goto search11;
+		}
+
+	search3:
+		if (i == size)
+		{
+			return found;
+		}
+		switch (data[i++])
+		{
+		case 'u': goto search2;
+		case 't': goto search7;
+		case 'r': goto search15;
+		default: goto search11;
+		}
+
+	search4:
+		if (i == size)
+		{
+			return found;
+		}
+		switch (data[i++])
+		{
+		case 'o': goto search3;
+		case 't': goto search7;
+		case 'r': goto search15;
+		default: goto search11;
+		}
+
+	search5:
+		if (i == size)
+		{
+			return found;
+		}
+		switch (data[i++])
+		{
+		case 'e': goto search4;
+		case 't': goto search7;
+		case 'r': goto search15;
+		default: goto search11;
+		}
+
+	search6:
+		if (i == size)
+		{
+			return found;
+		}
+		switch (data[i++])
+		{
+		case 'm': goto search5;
+		case 't': goto search7;
+		case 'r': goto search15;
+		default: goto search11;
+		}
+
+	search7:
+		if (i == size)
+		{
+			return found;
+		}
+		switch (data[i++])
+		{
+		case 'i': goto search6;
+		case 't': goto search7;
+		case 'r': goto search15;
+		default: goto search11;
+		}
+
+	search8:
+		found = true;
+		outEnd = i;
+		if (i == size)
+		{
+			return found;
+		}
+		switch (data[i++])
+		{
+		case 'i': goto search6;
+		case 't': goto search7;
+		case 'r': goto search15;
+		default: goto search11;
+		}
+
+	search9:
+		if (i == size)
+		{
+			return found;
+		}
+		switch (data[i++])
+		{
+		case 'e': goto search1;
+		case 't': goto search7;
+		case 'r': goto search15;
+		default: goto search11;
+		}
+
+	search10:
+		if (i == size)
+		{
+			return found;
+		}
+		switch (data[i++])
+		{
+		case 'E': goto search28;
+		case ' ': goto search34;
+		case 'W': goto search49;
+		case 'F': goto search51;
+		default: goto search33;
+		}
+
+	search11:
+		if (i == size)
+		{
+			return found;
+		}
+		switch (data[i++])
+		{
+		case 't': goto search7;
+		case 'r': goto search15;
+		default: goto search11;
+		}
+
+	search12:
+		if (i == size)
+		{
+			return found;
+		}
+		switch (data[i++])
+		{
+		case 't': goto search7;
+		case 's': goto search9;
+		case 'r': goto search15;
+		default: goto search11;
+		}
+
+	search13:
+		if (i == size)
+		{
+			return found;
+		}
+		switch (data[i++])
+		{
+		case 't': goto search7;
+		case 'u': goto search12;
+		case 'r': goto search15;
+		default: goto search11;
+		}
+
+	search14:
+		if (i == size)
+		{
+			return found;
+		}
+		switch (data[i++])
+		{
+		case 't': goto search7;
+		case 'f': goto search13;
+		case 'r': goto search15;
+		default: goto search11;
+		}
+
+	search15:
+		if (i == size)
+		{
+			return found;
+		}
+		switch (data[i++])
+		{
+		case 't': goto search7;
+		case 'e': goto search14;
+		case 'r': goto search15;
+		default: goto search11;
+		}
+
+	search16:
+		if (i == size)
+		{
+			return found;
+		}
+		switch (data[i++])
+		{
+		case ':': goto search10;
+		case 'E': goto search28;
+		case 'W': goto search49;
+		case 'F': goto search51;
+		default: goto search33;
+		}
+
+	search17:
+		if (i == size)
+		{
+			return found;
+		}
+		switch (data[i++])
+		{
+		case 'h': goto search16;
+		case 'E': goto search28;
+		case 'W': goto search49;
+		case 'F': goto search51;
+		default: goto search33;
+		}
+
+	search18:
+		if (i == size)
+		{
+			return found;
+		}
+		switch (data[i++])
+		{
+		case 'k': goto search16;
+		case 'E': goto search28;
+		case 'W': goto search49;
+		case 'F': goto search51;
+		default: goto search33;
+		}
+
+	search19:
+		if (i == size)
+		{
+			return found;
+		}
+		switch (data[i++])
+		{
+		case 't': goto search16;
+		case 'E': goto search28;
+		case 'W': goto search49;
+		case 'F': goto search51;
+		default: goto search33;
+		}
+
+	search20:
+		if (i == size)
+		{
+			return found;
+		}
+		switch (data[i++])
+		{
+		case 'e': goto search19;
+		case 'E': goto search28;
+		case 'W': goto search49;
+		case 'F': goto search51;
+		default: goto search33;
+		}
+
+	search21:
+		if (i == size)
+		{
+			return found;
+		}
+		switch (data[i++])
+		{
+		case 'n': goto search20;
+		case 'E': goto search28;
+		case 'a': goto search47;
+		case 'd': goto search48;
+		case 'W': goto search49;
+		case 'F': goto search51;
+		default: goto search33;
+		}
+
+	search22:
+		if (i == size)
+		{
+			return found;
+		}
+		switch (data[i++])
+		{
+		case ' ': goto search21;
+		case 'E': goto search28;
+		case 'W': goto search49;
+		case 'F': goto search51;
+		default: goto search33;
+		}
+
+	search23:
+		if (i == size)
+		{
+			return found;
+		}
+		switch (data[i++])
+		{
+		case 'L': goto search22;
+		case 'E': goto search28;
+		case 'W': goto search49;
+		case 'F': goto search51;
+		default: goto search33;
+		}
+
+	search24:
+		if (i == size)
+		{
+			return found;
+		}
+		switch (data[i++])
+		{
+		case 'N': goto search22;
+		case 'E': goto search28;
+		case 'W': goto search49;
+		case 'F': goto search51;
+		default: goto search33;
+		}
+
+	search25:
+		if (i == size)
+		{
+			return found;
+		}
+		switch (data[i++])
+		{
+		case 'R': goto search22;
+		case 'E': goto search28;
+		case 'W': goto search49;
+		case 'F': goto search51;
+		default: goto search33;
+		}
+
+	search26:
+		if (i == size)
+		{
+			return found;
+		}
+		switch (data[i++])
+		{
+		case 'O': goto search25;
+		case 'E': goto search28;
+		case 'W': goto search49;
+		case 'F': goto search51;
+		default: goto search33;
+		}
+
+	search27:
+		if (i == size)
+		{
+			return found;
+		}
+		switch (data[i++])
+		{
+		case 'R': goto search26;
+		case 'E': goto search28;
+		case 'W': goto search49;
+		case 'F': goto search51;
+		default: goto search33;
+		}
+
+	search28:
+		if (i == size)
+		{
+			return found;
+		}
+		switch (data[i++])
+		{
+		case 'R': goto search27;
+		case 'E': goto search28;
+		case 'W': goto search49;
+		case 'F': goto search51;
+		default: goto search33;
+		}
+
+	search29:
+		if (i == size)
+		{
+			return found;
+		}
+		switch (data[i++])
+		{
+		case 'A': goto search23;
+		case 'E': goto search28;
+		case 'W': goto search49;
+		case 'F': goto search51;
+		default: goto search33;
+		}
+
+	search30:
+		if (i == size)
+		{
+			return found;
+		}
+		switch (data[i++])
+		{
+		case 'R': goto search24;
+		case 'E': goto search28;
+		case 'W': goto search49;
+		case 'F': goto search51;
+		default: goto search33;
+		}
+
+	search31:
+		if (i == size)
+		{
+			return found;
+		}
+		switch (data[i++])
+		{
+		case 's': goto search18;
+		case 'E': goto search28;
+		case 'W': goto search49;
+		case 'F': goto search51;
+		default: goto search33;
+		}
+
+	search32:
+		if (i == size)
+		{
+			return found;
+		}
+		switch (data[i++])
+		{
+		case 't': goto search17;
+		case 'E': goto search28;
+		case 'W': goto search49;
+		case 'F': goto search51;
+		default: goto search33;
+		}
+
+	search33:
+		if (i == size)
+		{
+			return found;
+		}
+		switch (data[i++])
+		{
+		case 'E': goto search28;
+		case 'W': goto search49;
+		case 'F': goto search51;
+		default: goto search33;
+		}
+
+	search34:
+		if (i == size)
+		{
+			return found;
+		}
+		switch (data[i++])
+		{
+		case 'r': goto search35;
+		case 't': goto search36;
+		default: goto search34;
+		}
+
+	search35:
+		if (i == size)
+		{
+			return found;
+		}
+		switch (data[i++])
+		{
+		case 'r': goto search35;
+		case 't': goto search36;
+		case 'e': goto search37;
+		default: goto search34;
+		}
+
+	search36:
+		if (i == size)
+		{
+			return found;
+		}
+		switch (data[i++])
+		{
+		case 'r': goto search35;
+		case 't': goto search36;
+		case 'i': goto search38;
+		default: goto search34;
+		}
+
+	search37:
+		if (i == size)
+		{
+			return found;
+		}
+		switch (data[i++])
+		{
+		case 'r': goto search35;
+		case 't': goto search36;
+		case 'f': goto search39;
+		default: goto search34;
+		}
+
+	search38:
+		if (i == size)
+		{
+			return found;
+		}
+		switch (data[i++])
+		{
+		case 'r': goto search35;
+		case 't': goto search36;
+		case 'm': goto search40;
+		default: goto search34;
+		}
+
+	search39:
+		if (i == size)
+		{
+			return found;
+		}
+		switch (data[i++])
+		{
+		case 'r': goto search35;
+		case 't': goto search36;
+		case 'u': goto search41;
+		default: goto search34;
+		}
+
+	search40:
+		if (i == size)
+		{
+			return found;
+		}
+		switch (data[i++])
+		{
+		case 'r': goto search35;
+		case 't': goto search36;
+		case 'e': goto search42;
+		default: goto search34;
+		}
+
+	search41:
+		if (i == size)
+		{
+			return found;
+		}
+		switch (data[i++])
+		{
+		case 'r': goto search35;
+		case 't': goto search36;
+		case 's': goto search43;
+		default: goto search34;
+		}
+
+	search42:
+		if (i == size)
+		{
+			return found;
+		}
+		switch (data[i++])
+		{
+		case 'r': goto search35;
+		case 't': goto search36;
+		case 'o': goto search44;
+		default: goto search34;
+		}
+
+	search43:
+		if (i == size)
+		{
+			return found;
+		}
+		switch (data[i++])
+		{
+		case 'r': goto search35;
+		case 't': goto search36;
+		case 'e': goto search45;
+		default: goto search34;
+		}
+
+	search44:
+		if (i == size)
+		{
+			return found;
+		}
+		switch (data[i++])
+		{
+		case 'r': goto search35;
+		case 't': goto search36;
+		case 'u': goto search46;
+		default: goto search34;
+		}
+
+	search45:
+		if (i == size)
+		{
+			return found;
+		}
+		switch (data[i++])
+		{
+		case 'd': goto search0;
+		case 'r': goto search35;
+		case 't': goto search36;
+		default: goto search34;
+		}
+
+	search46:
+		if (i == size)
+		{
+			return found;
+		}
+		switch (data[i++])
+		{
+		case 't': goto search8;
+		case 'r': goto search35;
+		default: goto search34;
+		}
+
+	search47:
+		if (i == size)
+		{
+			return found;
+		}
+		switch (data[i++])
+		{
+		case 'E': goto search28;
+		case 'u': goto search32;
+		case 'W': goto search49;
+		case 'F': goto search51;
+		default: goto search33;
+		}
+
+	search48:
+		if (i == size)
+		{
+			return found;
+		}
+		switch (data[i++])
+		{
+		case 'E': goto search28;
+		case 'i': goto search31;
+		case 'W': goto search49;
+		case 'F': goto search51;
+		default: goto search33;
+		}
+
+	search49:
+		if (i == size)
+		{
+			return found;
+		}
+		switch (data[i++])
+		{
+		case 'E': goto search28;
+		case 'A': goto search30;
+		case 'W': goto search49;
+		case 'F': goto search51;
+		default: goto search33;
+		}
+
+	search50:
+		if (i == size)
+		{
+			return found;
+		}
+		switch (data[i++])
+		{
+		case 'E': goto search28;
+		case 'T': goto search29;
+		case 'W': goto search49;
+		case 'F': goto search51;
+		default: goto search33;
+		}
+
+	search51:
+		if (i == size)
+		{
+			return found;
+		}
+		switch (data[i++])
+		{
+		case 'E': goto search28;
+		case 'W': goto search49;
+		case 'A': goto search50;
+		case 'F': goto search51;
+		default: goto search33;
+		}
+
+	}
+
+	/// <summary>
+	/// Finds the start of the leftmost-longest match that ends at end
+	/// </summary>
+	/// <returns></returns>
+	inline size_t FindStart(std::string_view text, size_t start, size_t end, bool endsAfterLineEnd)
+	{
+		const unsigned char* data = (const unsigned char*)text.data();
+		size_t i = end;
+		size_t matchStart = end;
+
+		if (endsAfterLineEnd)
+		{
+			return matchStart;
+		}
+		goto reverse27;
+
+	reverse0:
+		matchStart = i;
+		if (i == start)
+		{
+			return matchStart;
+		}
+		switch (data[--i])
+		{
+		case ' ': goto reverse13;
+		default: goto reverse20;
+		}
+
+	reverse1:
+		if (i == start)
+		{
+			return matchStart;
+		}
+		switch (data[--i])
+		{
+		case 'E': goto reverse0;
+		case ' ': goto reverse13;
+		default: goto reverse20;
+		}
+
+	reverse2:
+		if (i == start)
+		{
+			return matchStart;
+		}
+		switch (data[--i])
+		{
+		case 'F': goto reverse0;
+		case ' ': goto reverse13;
+		default: goto reverse20;
+		}
+
+	reverse3:
+		if (i == start)
+		{
+			return matchStart;
+		}
+		switch (data[--i])
+		{
+		case 'W': goto reverse0;
+		case ' ': goto reverse13;
+		default: goto reverse20;
+		}
+
+	reverse4:
+		if (i == start)
+		{
+			return matchStart;
+		}
+		switch (data[--i])
+		{
+		case 'A': goto reverse3;
+		case ' ': goto reverse13;
+		default: goto reverse20;
+		}
+
+	reverse5:
+		if (i == start)
+		{
+			return matchStart;
+		}
+		switch (data[--i])
+		{
+		case 'R': goto reverse4;
+		case ' ': goto reverse13;
+		default: goto reverse20;
+		}
+
+	reverse6:
+		if (i == start)
+		{
+			return matchStart;
+		}
+		switch (data[--i])
+		{
+		case 'N': goto reverse5;
+		case ':': goto reverse12;
+		case ' ': goto reverse13;
+		case 'R': goto reverse35;
+		case 'L': goto reverse37;
+		default: goto reverse20;
+		}
+
+	reverse7:
+		if (i == start)
+		{
+			return matchStart;
+		}
+		switch (data[--i])
+		{
+		case ' ': goto reverse6;
+		default: goto reverse20;
+		}
+
+	reverse8:
+		if (i == start)
+		{
+			return matchStart;
+		}
+		switch (data[--i])
+		{
+		case 'a': goto reverse7;
+		case ' ': goto reverse13;
+		default: goto reverse20;
+		}
+
+	reverse9:
+		if (i == start)
+		{
+			return matchStart;
+		}
+		switch (data[--i])
+		{
+		case 'd': goto reverse7;
+		case ' ': goto reverse13;
+		default: goto reverse20;
+		}
+
+	reverse10:
+		if (i == start)
+		{
+			return matchStart;
+		}
+		switch (data[--i])
+		{
+		case 'n': goto reverse7;
+		case ' ': goto reverse13;
+		default: goto reverse20;
+		}
+
+	reverse11:
+		if (i == start)
+		{
+			return matchStart;
+		}
+		switch (data[--i])
+		{
+		case 'e': goto reverse10;
+		case ' ': goto reverse13;
+		default: goto reverse20;
+		}
+
+	reverse12:
+		if (i == start)
+		{
+			return matchStart;
+		}
+		switch (data[--i])
+		{
+		case 't': goto reverse11;
+		case ' ': goto reverse13;
+		case 'h': goto reverse21;
+		case 'k': goto reverse33;
+		default: goto reverse20;
+		}
+
+	reverse13:
+		if (i == start)
+		{
+			return matchStart;
+		}
+		switch (data[--i])
+		{
+		case ':': goto reverse12;
+		case ' ': goto reverse13;
+		default: goto reverse20;
+		}
+
+	reverse14:
+		if (i == start)
+		{
+			return matchStart;
+		}
+		switch (data[--i])
+		{
+		case 'A': goto reverse2;
+		case ' ': goto reverse13;
+		default: goto reverse20;
+		}
+
+	reverse15:
+		if (i == start)
+		{
+			return matchStart;
+		}
+		switch (data[--i])
+		{
+		case 'R': goto reverse1;
+		case ' ': goto reverse13;
+		default: goto reverse20;
+		}
+
+	reverse16:
+		if (i == start)
+		{
+			return matchStart;
+		}
+		switch (data[--i])
+		{
+		case 'i': goto reverse9;
+		case ' ': goto reverse13;
+		default: goto reverse20;
+		}
+
+	reverse17:
+		if (i == start)
+		{
+			return matchStart;
+		}
+		switch (data[--i])
+		{
+		case 'u': goto reverse8;
+		case ' ': goto reverse13;
+		default: goto reverse20;
+		}
+
+	reverse18:
+		if (i == start)
+		{
+			return matchStart;
+		}
+		switch (data[--i])
+		{
+		case 'r': goto reverse20;
+		default: return matchStart;
+		}
+
+	reverse19:
+		if (i == start)
+		{
+			return matchStart;
+		}
+		switch (data[--i])
+		{
+		case 't': goto reverse20;
+		default: return matchStart;
+		}
+
+	reverse20:
+		if (i == start)
+		{
+			return matchStart;
+		}
+		switch (data[--i])
+		{
+		case ' ': goto reverse13;
+		default: goto reverse20;
+		}
+
+	reverse21:
+		if (i == start)
+		{
+			return matchStart;
+		}
+		switch (data[--i])
+		{
+		case ' ': goto reverse13;
+		case 't': goto reverse17;
+		default: goto reverse20;
+		}
+
+	reverse22:
+		if (i == start)
+		{
+			return matchStart;
+		}
+		switch (data[--i])
+		{
+		case 'i': goto reverse19;
+		default: return matchStart;
+		}
+
+	reverse23:
+		if (i == start)
+		{
+			return matchStart;
+		}
+		switch (data[--i])
+		{
+		case 'm': goto reverse22;
+		default: return matchStart;
+		}
+
+	reverse24:
+		if (i == start)
+		{
+			return matchStart;
+		}
+		switch (data[--i])
+		{
+		case 'e': goto reverse23;
+		default: return matchStart;
+		}
+
+	reverse25:
+		if (i == start)
+		{
+			return matchStart;
+		}
+		switch (data[--i])
+		{
+		case 'o': goto reverse24;
+		default: return matchStart;
+		}
+
+	reverse26:
+		if (i == start)
+		{
+			return matchStart;
+		}
+		switch (data[--i])
+		{
+		case 'u': goto reverse25;
+		default: return matchStart;
+		}
+
+	reverse27:
+		if (i == start)
+		{
+			return matchStart;
+		}
+		switch (data[--i])
+		{
+		case 't': goto reverse26;
+		case 'd': goto reverse32;
+		default: return matchStart;
+		}
+
+	reverse28:
+		if (i == start)
+		{
+			return matchStart;
+		}
+		switch (data[--i])
+		{
+		case 'e': goto reverse18;
+		default: return matchStart;
+		}
+
+	reverse29:
+		if (i == start)
+		{
+			return matchStart;
+		}
+		switch (data[--i])
+		{
+		case 'f': goto reverse28;
+		default: return matchStart;
+		}
+
+	reverse30:
+		if (i == start)
+		{
+			return matchStart;
+		}
+		switch (data[--i])
+		{
+		case 'u': goto reverse29;
+		default: return matchStart;
+		}
+
+	reverse31:
+		if (i == start)
+		{
+			return matchStart;
+		}
+		switch (data[--i])
+		{
+		case 's': goto reverse30;
+		default: return matchStart;
+		}
+
+	reverse32:
+		if (i == start)
+		{
+			return matchStart;
+		}
+		switch (data[--i])
+		{
+		case 'e': goto reverse31;
+		default: return matchStart;
+		}
+
+	reverse33:
+		if (i == start)
+		{
+			return matchStart;
+		}
+		switch (data[--i])
+		{
+		case ' ': goto reverse13;
+		case 's': goto reverse16;
+		default: goto reverse20;
+		}
+
+	reverse34:
+		if (i == start)
+		{
+			return matchStart;
+		}
+		switch (data[--i])
+		{
+		case ' ': goto reverse13;
+		case 'R': goto reverse15;
+		default: goto reverse20;
+		}
+
+	reverse35:
+		if (i == start)
+		{
+			return matchStart;
+		}
+		switch (data[--i])
+		{
+		case ' ': goto reverse13;
+		case 'O': goto reverse34;
+		default: goto reverse20;
+		}
+
+	reverse36:
+		if (i == start)
+		{
+			return matchStart;
+		}
+		switch (data[--i])
+		{
+		case ' ': goto reverse13;
+		case 'T': goto reverse14;
+		default: goto reverse20;
+		}
+
+	reverse37:
+		if (i == start)
+		{
+			return matchStart;
+		}
+		switch (data[--i])
+		{
+		case ' ': goto reverse13;
+		case 'A': goto reverse36;
+		default: goto reverse20;
+		}
+
+	}
+
+	/// <summary>
+	/// Matches a line of text, see Regex::Match
+	/// </summary>
+	/// <param name="text">The line to match, without a line terminator</param>
+	/// <param name="outMatches">Output parameter that is cleared, then filled with the non-overlapping,
+	/// leftmost-longest matches in the order they appear. Empty matches are not reported.</param>
+	/// <returns>The number of matches found</returns>
+	inline size_t Match(std::string_view text, std::vector<Span>& outMatches)
+	{
+		outMatches.clear();
+
+		size_t start = 0;
+		while (start <= text.size())
+		{
+			size_t end;
+			bool endsAfterLineEnd;
+			if (!FindEnd(text, start, end, endsAfterLineEnd))
+			{
+				break;
+			}
+
+			size_t matchStart = FindStart(text, start, end, endsAfterLineEnd);
+			if (end > matchStart)
+			{
+				outMatches.push_back({ matchStart, end - matchStart });
+			}
+
+			// continue after this match, or one past it if it was empty
+			start = end > matchStart ? end : end + 1;
+		}
+
+		return outMatches.size();
+	}
+
+	/// <summary>
+	/// Returns true if Match would find a match in a line, so an empty match does not count
+	/// </summary>
+	/// <param name="text">The line to match, without a line terminator</param>
+	/// <returns></returns>
+	inline bool IsMatch(std::string_view text)
+	{
+		const unsigned char* data = (const unsigned char*)text.data();
+		size_t size = text.size();
+		size_t i = 0;
+
+		goto accept33;
+
+	accept0:
+		return true;
+		if (i == size)
+		{
+			return false;
+		}
+		switch (data[i++])
+		{
+		case 't': goto accept7;
+		case 'r': goto accept15;
+		default: goto accept11;
+		}
+
+	accept1:
+		if (i == size)
+		{
+			return false;
+		}
+		switch (data[i++])
+		{
+		case 'd': goto accept0;
+		case 't': goto accept7;
+		case 'r': goto accept15;
+		default: goto accept11;
+		}
+
+	accept2:
+		if (i == size)
+		{
+			return false;
+		}
+		switch (data[i++])
+		{
+		case 't': goto accept8;
+		case 'r': goto accept15;
+		default: goto accept11;
+		}
+
+	accept3:
+		if (i == size)
+		{
+			return false;
+		}
+		switch (data[i++])
+		{
+		case 'u': goto accept2;
+		case 't': goto accept7;
+		case 'r': goto accept15;
+		default: goto accept11;
+		}
+
+	accept4:
+		if (i == size)
+		{
+			return false;
+		}
+		switch (data[i++])
+		{
+		case 'o': goto accept3;
+		case 't': goto accept7;
+		case 'r': goto accept15;
+		default: goto accept11;
+		}
+
+	accept5:
+		if (i == size)
+		{
+			return false;
+		}
+		switch (data[i++])
+		{
+		case 'e': goto accept4;
+		case 't': goto accept7;
+		case 'r': goto accept15;
+		default: goto accept11;
+		}
+
+	accept6:
+		if (i == size)
+		{
+			return false;
+		}
+		switch (data[i++])
+		{
+		case 'm': goto accept5;
+		case 't': goto accept7;
+		case 'r': goto accept15;
+		default: goto accept11;
+		}
+
+	accept7:
+		if (i == size)
+		{
+			return false;
+		}
+		switch (data[i++])
+		{
+		case 'i': goto accept6;
+		case 't': goto accept7;
+		case 'r': goto accept15;
+		default: goto accept11;
+		}
+
+	accept8:
+		return true;
+		if (i == size)
+		{
+			return false;
+		}
+		switch (data[i++])
+		{
+		case 'i': goto accept6;
+		case 't': goto accept7;
+		case 'r': goto accept15;
+		default: goto accept11;
+		}
+
+	accept9:
+		if (i == size)
+		{
+			return false;
+		}
+		switch (data[i++])
+		{
+		case 'e': goto accept1;
+		case 't': goto accept7;
+		case 'r': goto accept15;
+		default: goto accept11;
+		}
+
+	accept10:
+		if (i == size)
+		{
+			return false;
+		}
+		switch (data[i++])
+		{
+		case 'E': goto accept28;
+		case ' ': goto accept34;
+		case 'W': goto accept49;
+		case 'F': goto accept51;
+		default: goto accept33;
+		}
+
+	accept11:
+		if (i == size)
+		{
+			return false;
+		}
+		switch (data[i++])
+		{
+		case 't': goto accept7;
+		case 'r': goto accept15;
+		default: goto accept11;
+		}
+
+	accept12:
+		if (i == size)
+		{
+			return false;
+		}
+		switch (data[i++])
+		{
+		case 't': goto accept7;
+		case 's': goto accept9;
+		case 'r': goto accept15;
+		default: goto accept11;
+		}
+
+	accept13:
+		if (i == size)
+		{
+			return false;
+		}
+		switch (data[i++])
+		{
+		case 't': goto accept7;
+		case 'u': goto accept12;
+		case 'r': goto accept15;
+		default: goto accept11;
+		}
+
+	accept14:
+		if (i == size)
+		{
+			return false;
+		}
+		switch (data[i++])
+		{
+		case 't': goto accept7;
+		case 'f': goto accept13;
+		case 'r': goto accept15;
+		default: goto accept11;
+		}
+
+	accept15:
+		if (i == size)
+		{
+			return false;
+		}
+		switch (data[i++])
+		{
+		case 't': goto accept7;
+		case 'e': goto accept14;
+		case 'r': goto accept15;
+		default: goto accept11;
+		}
+
+	accept16:
+		if (i == size)
+		{
+			return false;
+		}
+		switch (data[i++])
+		{
+		case ':': goto accept10;
+		case 'E': goto accept28;
+		case 'W': goto accept49;
+		case 'F': goto accept51;
+		default: goto accept33;
+		}
+
+	accept17:
+		if (i == size)
+		{
+			return false;
+		}
+		switch (data[i++])
+		{
+		case 'h': goto accept16;
+		case 'E': goto accept28;
+		case 'W': goto accept49;
+		case 'F': goto accept51;
+		default: goto accept33;
+		}
+
+	accept18:
+		if (i == size)
+		{
+			return false;
+		}
+		switch (data[i++])
+		{
+		case 'k': goto accept16;
+		case 'E': goto accept28;
+		case 'W': goto accept49;
+		case 'F': goto accept51;
+		default: goto accept33;
+		}
+
+	accept19:
+		if (i == size)
+		{
+			return false;
+		}
+		switch (data[i++])
+		{
+		case 't': goto accept16;
+		case 'E': goto accept28;
+		case 'W': goto accept49;
+		case 'F': goto accept51;
+		default: goto accept33;
+		}
+
+	accept20:
+		if (i == size)
+		{
+			return false;
+		}
+		switch (data[i++])
+		{
+		case 'e': goto accept19;
+		case 'E': goto accept28;
+		case 'W': goto accept49;
+		case 'F': goto accept51;
+		default: goto accept33;
+		}
+
+	accept21:
+		if (i == size)
+		{
+			return false;
+		}
+		switch (data[i++])
+		{
+		case 'n': goto accept20;
+		case 'E': goto accept28;
+		case 'a': goto accept47;
+		case 'd': goto accept48;
+		case 'W': goto accept49;
+		case 'F': goto accept51;
+		default: goto accept33;
+		}
+
+	accept22:
+		if (i == size)
+		{
+			return false;
+		}
+		switch (data[i++])
+		{
+		case ' ': goto accept21;
+		case 'E': goto accept28;
+		case 'W': goto accept49;
+		case 'F': goto accept51;
+		default: goto accept33;
+		}
+
+	accept23:
+		if (i == size)
+		{
+			return false;
+		}
+		switch (data[i++])
+		{
+		case 'L': goto accept22;
+		case 'E': goto accept28;
+		case 'W': goto accept49;
+		case 'F': goto accept51;
+		default: goto accept33;
+		}
+
+	accept24:
+		if (i == size)
+		{
+			return false;
+		}
+		switch (data[i++])
+		{
+		case 'N': goto accept22;
+		case 'E': goto accept28;
+		case 'W': goto accept49;
+		case 'F': goto accept51;
+		default: goto accept33;
+		}
+
+	accept25:
+		if (i == size)
+		{
+			return false;
+		}
+		switch (data[i++])
+		{
+		case 'R': goto accept22;
+		case 'E': goto accept28;
+		case 'W': goto accept49;
+		case 'F': goto accept51;
+		default: goto accept33;
+		}
+
+	accept26:
+		if (i == size)
+		{
+			return false;
+		}
+		switch (data[i++])
+		{
+		case 'O': goto accept25;
+		case 'E': goto accept28;
+		case 'W': goto accept49;
+		case 'F': goto accept51;
+		default: goto accept33;
+		}
+
+	accept27:
+		if (i == size)
+		{
+			return false;
+		}
+		switch (data[i++])
+		{
+		case 'R': goto accept26;
+		case 'E': goto accept28;
+		case 'W': goto accept49;
+		case 'F': goto accept51;
+		default: goto accept33;
+		}
+
+	accept28:
+		if (i == size)
+		{
+			return false;
+		}
+		switch (data[i++])
+		{
+		case 'R': goto accept27;
+		case 'E': goto accept28;
+		case 'W': goto accept49;
+		case 'F': goto accept51;
+		default: goto accept33;
+		}
+
+	accept29:
+		if (i == size)
+		{
+			return false;
+		}
+		switch (data[i++])
+		{
+		case 'A': goto accept23;
+		case 'E': goto accept28;
+		case 'W': goto accept49;
+		case 'F': goto accept51;
+		default: goto accept33;
+		}
+
+	accept30:
+		if (i == size)
+		{
+			return false;
+		}
+		switch (data[i++])
+		{
+		case 'R': goto accept24;
+		case 'E': goto accept28;
+		case 'W': goto accept49;
+		case 'F': goto accept51;
+		default: goto accept33;
+		}
+
+	accept31:
+		if (i == size)
+		{
+			return false;
+		}
+		switch (data[i++])
+		{
+		case 's': goto accept18;
+		case 'E': goto accept28;
+		case 'W': goto accept49;
+		case 'F': goto accept51;
+		default: goto accept33;
+		}
+
+	accept32:
+		if (i == size)
+		{
+			return false;
+		}
+		switch (data[i++])
+		{
+		case 't': goto accept17;
+		case 'E': goto accept28;
+		case 'W': goto accept49;
+		case 'F': goto accept51;
+		default: goto accept33;
+		}
+
+	accept33:
+		if (i == size)
+		{
+			return false;
+		}
+		switch (data[i++])
+		{
+		case 'E': goto accept28;
+		case 'W': goto accept49;
+		case 'F': goto accept51;
+		default: goto accept33;
+		}
+
+	accept34:
+		if (i == size)
+		{
+			return false;
+		}
+		switch (data[i++])
+		{
+		case 'r': goto accept35;
+		case 't': goto accept36;
+		default: goto accept34;
+		}
+
+	accept35:
+		if (i == size)
+		{
+			return false;
+		}
+		switch (data[i++])
+		{
+		case 'r': goto accept35;
+		case 't': goto accept36;
+		case 'e': goto accept37;
+		default: goto accept34;
+		}
+
+	accept36:
+		if (i == size)
+		{
+			return false;
+		}
+		switch (data[i++])
+		{
+		case 'r': goto accept35;
+		case 't': goto accept36;
+		case 'i': goto accept38;
+		default: goto accept34;
+		}
+
+	accept37:
+		if (i == size)
+		{
+			return false;
+		}
+		switch (data[i++])
+		{
+		case 'r': goto accept35;
+		case 't': goto accept36;
+		case 'f': goto accept39;
+		default: goto accept34;
+		}
+
+	accept38:
+		if (i == size)
+		{
+			return false;
+		}
+		switch (data[i++])
+		{
+		case 'r': goto accept35;
+		case 't': goto accept36;
+		case 'm': goto accept40;
+		default: goto accept34;
+		}
+
+	accept39:
+		if (i == size)
+		{
+			return false;
+		}
+		switch (data[i++])
+		{
+		case 'r': goto accept35;
+		case 't': goto accept36;
+		case 'u': goto accept41;
+		default: goto accept34;
+		}
+
+	accept40:
+		if (i == size)
+		{
+			return false;
+		}
+		switch (data[i++])
+		{
+		case 'r': goto accept35;
+		case 't': goto accept36;
+		case 'e': goto accept42;
+		default: goto accept34;
+		}
+
+	accept41:
+		if (i == size)
+		{
+			return false;
+		}
+		switch (data[i++])
+		{
+		case 'r': goto accept35;
+		case 't': goto accept36;
+		case 's': goto accept43;
+		default: goto accept34;
+		}
+
+	accept42:
+		if (i == size)
+		{
+			return false;
+		}
+		switch (data[i++])
+		{
+		case 'r': goto accept35;
+		case 't': goto accept36;
+		case 'o': goto accept44;
+		default: goto accept34;
+		}
+
+	accept43:
+		if (i == size)
+		{
+			return false;
+		}
+		switch (data[i++])
+		{
+		case 'r': goto accept35;
+		case 't': goto accept36;
+		case 'e': goto accept45;
+		default: goto accept34;
+		}
+
+	accept44:
+		if (i == size)
+		{
+			return false;
+		}
+		switch (data[i++])
+		{
+		case 'r': goto accept35;
+		case 't': goto accept36;
+		case 'u': goto accept46;
+		default: goto accept34;
+		}
+
+	accept45:
+		if (i == size)
+		{
+			return false;
+		}
+		switch (data[i++])
+		{
+		case 'd': goto accept0;
+		case 'r': goto accept35;
+		case 't': goto accept36;
+		default: goto accept34;
+		}
+
+	accept46:
+		if (i == size)
+		{
+			return false;
+		}
+		switch (data[i++])
+		{
+		case 't': goto accept8;
+		case 'r': goto accept35;
+		default: goto accept34;
+		}
+
+	accept47:
+		if (i == size)
+		{
+			return false;
+		}
+		switch (data[i++])
+		{
+		case 'E': goto accept28;
+		case 'u': goto accept32;
+		case 'W': goto accept49;
+		case 'F': goto accept51;
+		default: goto accept33;
+		}
+
+	accept48:
+		if (i == size)
+		{
+			return false;
+		}
+		switch (data[i++])
+		{
+		case 'E': goto accept28;
+		case 'i': goto accept31;
+		case 'W': goto accept49;
+		case 'F': goto accept51;
+		default: goto accept33;
+		}
+
+	accept49:
+		if (i == size)
+		{
+			return false;
+		}
+		switch (data[i++])
+		{
+		case 'E': goto accept28;
+		case 'A': goto accept30;
+		case 'W': goto accept49;
+		case 'F': goto accept51;
+		default: goto accept33;
+		}
+
+	accept50:
+		if (i == size)
+		{
+			return false;
+		}
+		switch (data[i++])
+		{
+		case 'E': goto accept28;
+		case 'T': goto accept29;
+		case 'W': goto accept49;
+		case 'F': goto accept51;
+		default: goto accept33;
+		}
+
+	accept51:
+		if (i == size)
+		{
+			return false;
+		}
+		switch (data[i++])
+		{
+		case 'E': goto accept28;
+		case 'W': goto accept49;
+		case 'A': goto accept50;
+		case 'F': goto accept51;
+		default: goto accept33;
+		}
+
+	}
+}
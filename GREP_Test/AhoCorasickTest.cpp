@@ -0,0 +1,76 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "../GREP/AhoCorasick.h"
+#include "../GREP/Regex.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace GREPTest
+{
+	TEST_CLASS(AhoCorasickTest)
+	{
+	public:
+
+		TEST_METHOD(TestAhoCorasick)
+		{
+			AhoCorasick literals({ { "he", "she", "hers" }, { "his" } });
+			Assert::IsTrue(literals.IsDense());
+
+			// she starts first, and hers is left over once she is taken
+			std::vector<Regex::Span> matches;
+			Assert::AreEqual((size_t)2, literals.Match("ushers his", matches));
+			Assert::AreEqual((size_t)1, matches[0].offset);
+			Assert::AreEqual((size_t)3, matches[0].length);
+			Assert::AreEqual((size_t)7, matches[1].offset);
+
+			// the longest literal at the leftmost position wins, even though he ends first
+			Assert::AreEqual((size_t)1, literals.Match("xhersx", matches));
+			Assert::AreEqual((size_t)1, matches[0].offset);
+			Assert::AreEqual((size_t)4, matches[0].length);
+
+			Assert::AreEqual((size_t)0, literals.Match("hi sh", matches));
+		}
+
+		TEST_METHOD(TestAhoCorasickFindLine)
+		{
+			AhoCorasick literals(std::vector<std::vector<std::string>>{ { "abc", "bcd" } });
+			std::string text = "ab\nc\nxbcd\nabc";
+			Regex::Span line;
+
+			// a literal never spans a newline
+			Assert::IsTrue(literals.FindLine(text, 0, line));
+			Assert::AreEqual(std::string("xbcd"), text.substr(line.offset, line.length));
+			Assert::IsTrue(literals.FindLine(text, line.offset + line.length + 1, line));
+			Assert::AreEqual(std::string("abc"), text.substr(line.offset, line.length));
+			Assert::IsFalse(literals.FindLine(text, text.size(), line));
+		}
+
+		TEST_METHOD(TestAhoCorasickPatterns)
+		{
+			AhoCorasick literals({ { "abcd" }, { "bc", "xy" }, { "c" }, { "zz" } });
+
+			// literals inside other literals count too
+			std::vector<int> patterns;
+			Assert::AreEqual((size_t)3, literals.MatchingPatterns("abcd", patterns));
+			Assert::AreEqual(0, patterns[0]);
+			Assert::AreEqual(1, patterns[1]);
+			Assert::AreEqual(2, patterns[2]);
+
+			Assert::AreEqual((size_t)1, literals.MatchingPatterns("axyz", patterns));
+			Assert::AreEqual(1, patterns[0]);
+		}
+
+		TEST_METHOD(TestAhoCorasickRegex)
+		{
+			// alternations of literals skip the dfas
+			Regex literals = Regex::Parse("foo|bar|(baz|qux)");
+			Assert::IsTrue(literals.GetStatistics().literalStates > 0);
+			Assert::AreEqual(0, literals.GetStatistics().searchStates);
+			Assert::AreEqual((size_t)2, literals.Match("a bar and a qux").size());
+
+			Assert::AreEqual(0, Regex::Parse("foo|ba.").GetStatistics().literalStates);
+			Assert::AreEqual(0, Regex::Parse("foo|^bar").GetStatistics().literalStates);
+			Assert::AreEqual(0, Regex::Parse("foo|").GetStatistics().literalStates);
+		}
+	};
+}
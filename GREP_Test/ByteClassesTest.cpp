@@ -0,0 +1,42 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "../GREP/ByteClasses.h"
+#include "../GREP/Regex.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace GREPTest
+{
+	TEST_CLASS(ByteClassesTest)
+	{
+	public:
+
+		TEST_METHOD(TestByteClasses)
+		{
+			ByteClasses classes({ 'c', 'a', Regex::ANY, Regex::LINE_START });
+
+			// 'a' and 'c' each have a class, every other byte is in class 0
+			Assert::AreEqual(3, classes.NumClasses());
+			Assert::AreEqual(1, (int)classes.Get('a'));
+			Assert::AreEqual(2, (int)classes.Get('c'));
+			Assert::AreEqual(0, (int)classes.Get('b'));
+			Assert::AreEqual(0, (int)classes.Get('\0'));
+			Assert::AreEqual(0, (int)classes.Get(Regex::ANY));
+			Assert::AreEqual(0, (int)classes.Get((char)0xff));
+			Assert::AreEqual('c', classes.Representative(2));
+
+			Assert::AreEqual(1, ByteClasses().NumClasses());
+		}
+
+		TEST_METHOD(TestDFAByteClasses)
+		{
+			Regex r = Regex::Parse("ab.c");
+
+			// class 0 and one class each for 'a', 'b' and 'c'
+			Assert::AreEqual(4, r.GetStatistics().byteClasses);
+			Assert::AreEqual(1, (int)r.Match("xxab\xff" "c").size());
+			Assert::AreEqual(1, (int)r.Match("abbc").size());
+			Assert::AreEqual(0, (int)r.Match("abxd").size());
+		}
+	};
+}
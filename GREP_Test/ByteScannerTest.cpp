@@ -0,0 +1,74 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "../GREP/ByteScanner.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace GREPTest
+{
+	TEST_CLASS(ByteScannerTest)
+	{
+	public:
+
+		TEST_METHOD(TestByteScanner)
+		{
+			ByteScanner scanner("xz", ByteScanner::Kernel::Scalar);
+			std::string text = "aaaaybbbzxx";
+
+			Assert::AreEqual((size_t)8, scanner.Find(text.data(), text.size()));
+			Assert::AreEqual((size_t)5, scanner.Find(text.data(), 5));
+			Assert::AreEqual((size_t)0, scanner.Find(text.data() + 9, 2));
+
+			// a scanner for no bytes finds nothing
+			Assert::AreEqual(text.size(), ByteScanner().Find(text.data(), text.size()));
+		}
+
+		TEST_METHOD(TestByteScannerKernels)
+		{
+			const ByteScanner::Kernel kernels[] = {
+				ByteScanner::Kernel::Scalar,
+				ByteScanner::Kernel::SSE2,
+				ByteScanner::Kernel::AVX2
+			};
+
+			// bytes that only differ in the high bit catch signed comparisons
+			const std::string sets[] = { "\n", "\x80", "a\n", "\xff\x7f\n", std::string("a\0b\n", 4) };
+
+			// long enough to cover several vectors, and the tail after them. The bytes in the sets
+			// are rare, so most vectors have no hit.
+			const std::string alphabet = std::string("ab\n\x80\xff\x7f\0", 7) + std::string(57, 'q');
+			std::string text;
+			unsigned int seed = 1;
+			for (int i = 0; i < 300; ++i)
+			{
+				seed = seed * 1103515245 + 12345;
+				text += alphabet[(seed >> 16) % alphabet.size()];
+			}
+
+			for (const std::string& set : sets)
+			{
+				ByteScanner scalar(set, ByteScanner::Kernel::Scalar);
+
+				for (ByteScanner::Kernel kernel : kernels)
+				{
+					if (!ByteScanner::IsSupported(kernel))
+					{
+						continue;
+					}
+
+					// every start and length, so a hit lands in every lane and in the tail
+					ByteScanner vector(set, kernel);
+					for (size_t start = 0; start < 70; ++start)
+					{
+						for (size_t length = 0; start + length <= text.size(); length += 7)
+						{
+							Assert::AreEqual(
+								scalar.Find(text.data() + start, length),
+								vector.Find(text.data() + start, length));
+						}
+					}
+				}
+			}
+		}
+	};
+}
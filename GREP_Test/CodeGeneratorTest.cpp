@@ -0,0 +1,99 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "../GREP/CodeGenerator.h"
+#include "../GREP/Parser.h"
+#include "../GREP/Regex.h"
+
+// the code the benchmark runs, written by CodeGenerator
+#include "../GREP_Bench/LogPattern.h"
+
+// written by grep --generate StarPattern "x*|b+$", a pattern that matches the empty string
+#include "StarPattern.h"
+
+#include <sstream>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace GREPTest
+{
+	TEST_CLASS(CodeGeneratorTest)
+	{
+	public:
+
+		TEST_METHOD(TestCodeGeneratorIdentifier)
+		{
+			Assert::IsTrue(CodeGenerator::IsIdentifier("LogPattern"));
+			Assert::IsTrue(CodeGenerator::IsIdentifier("_log2"));
+			Assert::IsFalse(CodeGenerator::IsIdentifier(""));
+			Assert::IsFalse(CodeGenerator::IsIdentifier("2log"));
+			Assert::IsFalse(CodeGenerator::IsIdentifier("log::pattern"));
+		}
+
+		TEST_METHOD(TestCodeGenerator)
+		{
+			std::ostringstream code;
+			Assert::IsTrue(CodeGenerator::Generate({ "ab*c", "^x" }, "Words", code));
+			Assert::IsTrue(code.str().find("namespace Words") != std::string::npos);
+			Assert::IsTrue(code.str().find("inline size_t Match(") != std::string::npos);
+			Assert::IsTrue(code.str().find("inline bool IsMatch(") != std::string::npos);
+
+			// a dfa that has to remember the last 12 inputs has thousands of states
+			std::string pattern = "(a|b)*a";
+			for (int i = 0; i < 11; ++i)
+			{
+				pattern += "(a|b)";
+			}
+
+			std::ostringstream tooBig;
+			Assert::IsFalse(CodeGenerator::Generate({ pattern }, "TooBig", tooBig));
+			Assert::IsTrue(tooBig.str().empty());
+
+			Assert::ExpectException<ParseError>([] { std::ostringstream out; CodeGenerator::Generate({ "a(b" }, "Bad", out); });
+		}
+
+		TEST_METHOD(TestCodeGeneratorAgainstRegex)
+		{
+			Regex regex = Regex::Parse("(ERROR|WARN|FATAL) (net|disk|auth): .*(timeout|refused)");
+			std::vector<std::string> lines = {
+				"12:00 ERROR net: read timeout",
+				"12:00 WARN disk: connection refused, refused again",
+				"12:00 INFO net: read timeout",
+				"ERROR auth: timeout WARN net: refused",
+				"ERROR auth:",
+				""
+			};
+
+			for (const std::string& line : lines)
+			{
+				std::vector<Regex::Span> expected;
+				std::vector<LogPattern::Span> actual;
+				Assert::AreEqual(regex.Match(line, expected), LogPattern::Match(line, actual));
+				for (size_t i = 0; i < expected.size(); ++i)
+				{
+					Assert::AreEqual(expected[i].offset, actual[i].offset);
+					Assert::AreEqual(expected[i].length, actual[i].length);
+				}
+
+				Assert::AreEqual(regex.IsMatch(line), LogPattern::IsMatch(line));
+			}
+		}
+
+		TEST_METHOD(TestCodeGeneratorEmptyMatch)
+		{
+			// IsMatch does not count the empty matches, which Match does not report
+			Regex regex = Regex::Parse("x*|b+$");
+			const std::string lines[] = { "", "a", "ax", "xxa", "ab", "abba", "bab" };
+			for (const std::string& line : lines)
+			{
+				std::vector<Regex::Span> expected;
+				std::vector<StarPattern::Span> actual;
+				Assert::AreEqual(regex.Match(line, expected), StarPattern::Match(line, actual));
+				Assert::AreEqual(!actual.empty(), StarPattern::IsMatch(line));
+				Assert::AreEqual(regex.IsMatch(line), StarPattern::IsMatch(line));
+			}
+
+			Assert::IsFalse(StarPattern::IsMatch("abc"));
+			Assert::IsTrue(StarPattern::IsMatch("abcb"));
+		}
+	};
+}
@@ -84,5 +84,128 @@ namespace GREPTest
 
 			Assert::AreEqual(false, result2);
 		}
+
+		TEST_METHOD(TestDeadState)
+		{
+			std::set<int> q = { 1, 2 };
+			int q0 = 1;
+			std::set<int> f = { 2 };
+
+			std::vector<std::tuple<int, char, int>> easyTransitions = {
+				{ 1, Regex::ANY, 2 },
+				{ 1, 'x', 1 },
+			};
+
+			DFA dfa(q, DFA::MakeTransitionMap(easyTransitions), q0, f);
+
+			// explicit transitions win over ANY
+			dfa.BeginSimulation();
+			dfa.OnNextAll("xxa");
+			Assert::AreEqual(false, dfa.HasFailed());
+			Assert::AreEqual(true, dfa.EndSimulation());
+
+			// no transitions out of state 2, so the dfa can never recover
+			dfa.BeginSimulation();
+			dfa.OnNextAll("aa");
+			Assert::AreEqual(true, dfa.HasFailed());
+			dfa.OnNext('x');
+			Assert::AreEqual(true, dfa.HasFailed());
+			Assert::AreEqual(false, dfa.EndSimulation());
+
+			// ANY never matches the line start or line end, but does match any byte
+			dfa.BeginSimulation();
+			dfa.OnLineStart();
+			Assert::AreEqual(true, dfa.HasFailed());
+			dfa.EndSimulation();
+
+			dfa.BeginSimulation();
+			dfa.OnNext(Regex::LINE_END);
+			Assert::AreEqual(true, dfa.EndSimulation());
+
+			// the dead state is reset when a new simulation begins
+			dfa.BeginSimulation();
+			Assert::AreEqual(false, dfa.HasFailed());
+		}
+	
+		TEST_METHOD(TestMinimize)
+		{
+			// accepts strings of a and b that end in ab. States 2 and 4 behave the same, and
+			// state 5 can never reach a final state
+			std::set<int> q = { 1, 2, 3, 4, 5 };
+			int q0 = 1;
+			std::set<int> f = { 3 };
+
+			std::vector<std::tuple<int, char, int>> easyTransitions = {
+				{ 1, 'a', 2 },
+				{ 1, 'b', 1 },
+				{ 1, 'c', 5 },
+				{ 2, 'a', 4 },
+				{ 2, 'b', 3 },
+				{ 3, 'a', 2 },
+				{ 3, 'b', 1 },
+				{ 4, 'a', 4 },
+				{ 4, 'b', 3 },
+				{ 5, 'a', 5 },
+			};
+
+			DFA dfa(q, DFA::MakeTransitionMap(easyTransitions), q0, f);
+			dfa.Minimize();
+
+			Assert::AreEqual(3, dfa.NumStates());
+
+			const std::pair<std::string, bool> inputs[] = {
+				{ "ab", true },
+				{ "aaab", true },
+				{ "abbab", true },
+				{ "aba", false },
+				{ "", false },
+				{ "acab", false },
+			};
+
+			for (auto& input : inputs)
+			{
+				dfa.BeginSimulation();
+				dfa.OnNextAll(input.first);
+				Assert::AreEqual(input.second, dfa.EndSimulation());
+			}
+
+			// the state that can never accept became the dead state
+			dfa.BeginSimulation();
+			dfa.OnNext('c');
+			Assert::AreEqual(true, dfa.HasFailed());
+		}
+
+		TEST_METHOD(TestDFASerialize)
+		{
+			std::set<int> q = { 1, 2, 3 };
+			std::vector<std::tuple<int, char, int>> easyTransitions = {
+				{ 1, 'a', 2 },
+				{ 2, Regex::ANY, 3 },
+				{ 3, Regex::LINE_END, 3 },
+			};
+
+			DFA dfa(q, DFA::MakeTransitionMap(easyTransitions), 1, { 3 }, { { 3, { 0, 2 } } });
+			std::string data;
+			dfa.Serialize(data);
+
+			size_t offset = 0;
+			DFA loaded = DFA::GenerateEmpty();
+			Assert::IsTrue(DFA::Load(data, offset, nullptr, loaded));
+			Assert::AreEqual(data.size(), offset);
+			Assert::AreEqual(dfa.NumStates(), loaded.NumStates());
+			Assert::AreEqual(dfa.NumByteClasses(), loaded.NumByteClasses());
+
+			uint32_t state = loaded.Next(loaded.Next(loaded.StartState(), 'a'), 'z');
+			Assert::IsTrue(loaded.IsAccepting(loaded.NextLineEnd(state)));
+			Assert::AreEqual((size_t)2, loaded.Patterns(state).size());
+			Assert::AreEqual(2, loaded.Patterns(state)[1]);
+			Assert::IsTrue(loaded.IsDead(loaded.Next(loaded.StartState(), 'b')));
+
+			// data that was cut short, or is from another version, is not loaded
+			offset = 0;
+			Assert::IsFalse(DFA::Load(std::string_view(data).substr(0, data.size() - 4), offset, nullptr, loaded));
+			data[4]++;
+			Assert::IsFalse(DFA::Load(data, offset, nullptr, loaded));
+		}
 	};
 }
@@ -0,0 +1,73 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "../GREP/LazyDFA.h"
+#include "../GREP/Regex.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace GREPTest
+{
+	TEST_CLASS(LazyDFATest)
+	{
+	public:
+
+		TEST_METHOD(TestLazyDFA)
+		{
+			NFA nfa = NFA::Concatenate(
+				NFA::KleeneStar(NFA::Union(NFA::GenerateSingle('a'), NFA::GenerateSingle('b'))),
+				NFA::GenerateSingle('c'));
+
+			DFA dfa = nfa.ConvertToDFA();
+			LazyDFA lazy(nfa, NFA::Search::Anchored);
+			LazyDFA::Runner runner = lazy.Begin();
+
+			// nothing is built before the first input except the dead state and the start state.
+			// The start of a line leads to the dead state, since the NFA has no ^
+			Assert::AreEqual((size_t)2, runner.NumStates());
+
+			const std::string inputs[] = { "c", "abbac", "ab", "abca", "", "x" };
+			for (const std::string& input : inputs)
+			{
+				uint32_t expected = dfa.StartState();
+				uint32_t state = runner.StartState();
+				for (char c : input)
+				{
+					expected = dfa.Next(expected, c);
+					state = runner.Next(state, c);
+				}
+
+				Assert::AreEqual(dfa.IsAccepting(expected), runner.IsAccepting(state));
+				Assert::AreEqual(dfa.IsDead(expected), runner.IsDead(state));
+			}
+		}
+
+		TEST_METHOD(TestLazyDFAFlush)
+		{
+			NFA nfa = NFA::Concatenate(
+				NFA::KleeneStar(NFA::Union(NFA::GenerateSingle('a'), NFA::GenerateSingle('b'))),
+				NFA::GenerateSingle('a'));
+			for (int i = 0; i < 3; ++i)
+			{
+				nfa = NFA::Concatenate(nfa, NFA::Union(NFA::GenerateSingle('a'), NFA::GenerateSingle('b')));
+			}
+
+			// a cache too small for any new state is flushed at almost every input
+			DFA dfa = nfa.ConvertToDFA();
+			LazyDFA lazy(nfa, NFA::Search::Anchored, 1);
+			LazyDFA::Runner runner = lazy.Begin();
+
+			std::string input = "abbbaabababbbaaabbbbabaababba";
+			uint32_t expected = dfa.StartState();
+			uint32_t state = runner.StartState();
+			for (char c : input)
+			{
+				expected = dfa.Next(expected, c);
+				state = runner.Next(state, c);
+				Assert::AreEqual(dfa.IsAccepting(expected), runner.IsAccepting(state));
+			}
+
+			Assert::IsTrue(runner.NumFlushes() > 0);
+			Assert::IsTrue(runner.NumStates() <= 4);
+		}
+	};
+}
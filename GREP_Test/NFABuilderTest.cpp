@@ -0,0 +1,76 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "../GREP/NFABuilder.h"
+#include "../GREP/DFA.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace GREPTest
+{
+	TEST_CLASS(NFABuilderTest)
+	{
+	public:
+
+		TEST_METHOD(TestBuilder)
+		{
+			// (ab)+|c*
+			NFABuilder builder;
+			NFABuilder::Fragment ab = builder.Concatenate(builder.Single('a'), builder.Single('b'));
+			NFABuilder::Fragment plus = builder.OneOrMore(ab);
+			NFABuilder::Fragment star = builder.KleeneStar(builder.Single('c'));
+			NFABuilder::Fragment both = builder.Union({ plus, star });
+
+			// the repeated fragment is looped, not copied, so each operator adds two states
+			Assert::AreEqual(12, builder.NumStates());
+
+			DFA dfa = builder.Build(both).ConvertToDFA();
+
+			const std::pair<std::string, bool> inputs[] = {
+				{ "ab", true },
+				{ "ababab", true },
+				{ "", true },
+				{ "ccc", true },
+				{ "aba", false },
+				{ "abc", false },
+			};
+
+			for (auto& input : inputs)
+			{
+				dfa.BeginSimulation();
+				dfa.OnNextAll(input.first);
+				Assert::AreEqual(input.second, dfa.EndSimulation());
+			}
+		}
+
+		TEST_METHOD(TestBuilderManyAlternatives)
+		{
+			// every alternative hangs off the same start state
+			NFABuilder builder;
+			std::vector<NFABuilder::Fragment> alternatives;
+			for (char c = 'a'; c <= 'z'; ++c)
+			{
+				alternatives.push_back(builder.Optional(builder.Single(c)));
+			}
+			NFABuilder::Fragment any = builder.Union(alternatives);
+
+			Assert::AreEqual(26 * 4 + 2, builder.NumStates());
+
+			DFA dfa = builder.Build(any).ConvertToDFA();
+
+			const std::pair<std::string, bool> inputs[] = {
+				{ "a", true },
+				{ "q", true },
+				{ "", true },
+				{ "ab", false },
+				{ "A", false },
+			};
+
+			for (auto& input : inputs)
+			{
+				dfa.BeginSimulation();
+				dfa.OnNextAll(input.first);
+				Assert::AreEqual(input.second, dfa.EndSimulation());
+			}
+		}
+	};
+}
@@ -51,6 +51,77 @@ namespace GREPTest
 			Assert::AreEqual(false, result2);
 		}
 
+		TEST_METHOD(TestNFAToDFASparseStates)
+		{
+			// states do not have to be numbered from zero, or be listed in q if only arrows reach them
+			std::set<int> q = { 7, 300 };
+			int q0 = 7;
+			int f = 1000;
+
+			std::vector<std::tuple<int, char, std::set<int>>> easyTransitions = {
+				{ 7, 'a', {300} },
+				{ 7, '\0', {300} },
+
+				{ 300, 'b', {300, 1000} },
+			};
+
+			NFA nfa(q, NFA::MakeTransitionMap(easyTransitions), q0, f);
+			DFA dfa = nfa.ConvertToDFA();
+
+			const std::pair<std::string, bool> inputs[] = {
+				{ "ab", true },
+				{ "bbb", true },
+				{ "a", false },
+				{ "aab", false },
+			};
+
+			for (auto& input : inputs)
+			{
+				dfa.BeginSimulation();
+				dfa.OnNextAll(input.first);
+				Assert::AreEqual(input.second, dfa.EndSimulation());
+			}
+		}
+
+		TEST_METHOD(TestNulInput)
+		{
+			// with the epsilon arrows given separately, a NUL byte is an ordinary input
+			std::set<int> q = { 0, 1, 2 };
+			int q0 = 0;
+			int f = 2;
+
+			std::vector<std::tuple<int, char, std::set<int>>> easyTransitions = {
+				{ 0, '\0', {1} },
+				{ 1, 'a', {2} },
+			};
+			std::map<int, std::set<int>> epsilonTransitions = {
+				{ 0, {1} },
+			};
+
+			NFA nfa(q, NFA::MakeTransitionMap(easyTransitions), epsilonTransitions, q0, f);
+			DFA dfa = nfa.ConvertToDFA();
+
+			const std::pair<std::string, bool> inputs[] = {
+				{ std::string("\0a", 2), true },
+				{ "a", true },
+				{ std::string("\0", 1), false },
+				{ std::string("\0\0a", 3), false },
+			};
+
+			for (auto& input : inputs)
+			{
+				dfa.BeginSimulation();
+				dfa.OnNextAll(input.first);
+				Assert::AreEqual(input.second, dfa.EndSimulation());
+			}
+
+			// the single character NFA for NUL matches it too
+			DFA single = NFA::GenerateSingle('\0').ConvertToDFA();
+			single.BeginSimulation();
+			single.OnNext('\0');
+			Assert::AreEqual(true, single.EndSimulation());
+		}
+
 		TEST_METHOD(TestSingle)
 		{
 			NFA single = NFA::GenerateSingle('b');
@@ -245,5 +316,35 @@ namespace GREPTest
 
 			Assert::AreEqual(false, result3);
 		}
+
+		TEST_METHOD(TestPatternDFA)
+		{
+			NFA patterns = NFA::Union({ NFA::GenerateSingle('a'), NFA::GenerateSingle('b'),
+				NFA::Concatenate(NFA::GenerateSingle('a'), NFA::GenerateSingle('b')) });
+			DFA dfa = patterns.ConvertToPatternDFA();
+			dfa.Minimize();
+
+			// each final state holds the patterns whose matches end there
+			uint32_t a = dfa.Next(dfa.StartState(), 'a');
+			Assert::IsTrue(dfa.IsAccepting(a));
+			Assert::AreEqual((size_t)1, dfa.Patterns(a).size());
+			Assert::AreEqual(0, dfa.Patterns(a)[0]);
+
+			uint32_t ab = dfa.Next(a, 'b');
+			Assert::AreEqual((size_t)2, dfa.Patterns(ab).size());
+			Assert::AreEqual(1, dfa.Patterns(ab)[0]);
+			Assert::AreEqual(2, dfa.Patterns(ab)[1]);
+
+			// b matches wherever it is, so minimizing must not merge it with ab
+			uint32_t b = dfa.Next(dfa.StartState(), 'b');
+			Assert::IsTrue(b != ab);
+			Assert::AreEqual((size_t)1, dfa.Patterns(b).size());
+
+			// the search never dies
+			uint32_t x = dfa.Next(ab, 'x');
+			Assert::IsFalse(dfa.IsDead(x));
+			Assert::IsFalse(dfa.IsAccepting(x));
+			Assert::AreEqual(a, dfa.Next(x, 'a'));
+		}
 	};
 }
@@ -0,0 +1,88 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "../GREP/OutputBuffer.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace GREPTest
+{
+	TEST_CLASS(OutputBufferTest)
+	{
+	public:
+
+		TEST_METHOD(TestOutputBufferHighlight)
+		{
+			std::string input = "an apple\nbanana";
+			std::vector<Regex::Span> matches = { { 3, 1 }, { 7, 1 } };
+
+			OutputBuffer none(OutputBuffer::Highlight::None);
+			none.AddLine(std::string_view(input).substr(0, 8), true, matches);
+			Assert::AreEqual(std::string("an apple\n"), none.ToString());
+
+			OutputBuffer upper(OutputBuffer::Highlight::UpperCase);
+			upper.AddLine(std::string_view(input).substr(0, 8), true, matches);
+			Assert::AreEqual(std::string("an ApplE\n"), upper.ToString());
+
+			// the last line of a file gets a newline even though it has none in the input
+			OutputBuffer color(OutputBuffer::Highlight::Color);
+			color.Add("file:");
+			color.AddLine(std::string_view(input).substr(9), false, { { 0, 1 }, { 5, 1 } });
+			std::string start = OutputBuffer::COLOR_START;
+			std::string end = OutputBuffer::COLOR_END;
+			Assert::AreEqual("file:" + start + "b" + end + "anan" + start + "a" + end + "\n", color.ToString());
+			Assert::AreEqual(color.ToString().size(), color.Size());
+
+			// a long line is not copied unless asked to be, a short one always is
+			std::string longLine(300, 'x');
+			OutputBuffer inPlace;
+			inPlace.AddLine(longLine, false, {});
+			inPlace.AddLine(std::string_view(input).substr(0, 8), true, {});
+			longLine[0] = 'y';
+			input[0] = 'A';
+			Assert::AreEqual(longLine + "\nan apple\n", inPlace.ToString());
+
+			inPlace.Keep();
+			longLine[0] = 'z';
+			Assert::AreEqual("y" + longLine.substr(1) + "\nan apple\n", inPlace.ToString());
+
+			color.Clear();
+			Assert::IsTrue(color.Empty());
+		}
+
+		TEST_METHOD(TestOutputBufferLinesInPlace)
+		{
+			// the lines are written from the input with their own newlines
+			std::string input = "one\ntwo\nthree\n";
+			OutputBuffer output;
+			output.AddLine(std::string_view(input).substr(0, 3), true, {});
+			output.AddLine(std::string_view(input).substr(4, 3), true, {});
+			output.AddLine(std::string_view(input).substr(8, 5), true, {});
+			Assert::AreEqual(input, output.ToString());
+			Assert::AreEqual(input.size(), output.Size());
+		}
+
+		TEST_METHOD(TestOutputBufferKeepGrowing)
+		{
+			// each block of a file is kept before the next is read over it, and what was kept before
+			// must not change
+			std::string expected;
+			OutputBuffer output;
+			for (int block = 0; block < 4; ++block)
+			{
+				std::string input = std::string(300, (char)('a' + block)) + "\nshort\n";
+				output.Add("file:");
+				output.AddLine(std::string_view(input).substr(0, 300), true, {});
+				output.AddLine(std::string_view(input).substr(301, 5), true, {});
+				output.Keep();
+				expected += "file:" + input;
+
+				input.assign(input.size(), '?');
+				Assert::AreEqual(expected, output.ToString());
+				Assert::AreEqual(expected.size(), output.Size());
+			}
+
+			output.Keep();
+			Assert::AreEqual(expected, output.ToString());
+		}
+	};
+}
@@ -0,0 +1,81 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "../GREP/Parser.h"
+#include "../GREP/Regex.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace GREPTest
+{
+	TEST_CLASS(ParserTest)
+	{
+	public:
+
+		TEST_METHOD(TestParser)
+		{
+			Ast ast = Parser::Parse("ab|(c.)*|");
+
+			// a union of three alternatives, the last of them empty
+			const Ast::Node& root = ast.GetNode(ast.Root());
+			Assert::IsTrue(root.kind == Ast::Kind::Union);
+			Assert::AreEqual(3, root.numChildren);
+
+			const Ast::Node& ab = ast.GetNode(ast.Child(ast.Root(), 0));
+			Assert::IsTrue(ab.kind == Ast::Kind::Concatenate);
+			Assert::AreEqual(2, ab.numChildren);
+			Assert::AreEqual('b', ast.GetNode(ast.Child(ast.Child(ast.Root(), 0), 1)).input);
+
+			// the group needs no node of its own
+			int star = ast.Child(ast.Root(), 1);
+			Assert::IsTrue(ast.GetNode(star).kind == Ast::Kind::KleeneStar);
+			int group = ast.Child(star, 0);
+			Assert::IsTrue(ast.GetNode(group).kind == Ast::Kind::Concatenate);
+			Assert::AreEqual(Regex::ANY, ast.GetNode(ast.Child(group, 1)).input);
+
+			Assert::IsTrue(ast.GetNode(ast.Child(ast.Root(), 2)).kind == Ast::Kind::Empty);
+		}
+
+		TEST_METHOD(TestParserRepetition)
+		{
+			// a chain of operators becomes one node
+			Ast plus = Parser::Parse("a++");
+			Assert::IsTrue(plus.GetNode(plus.Root()).kind == Ast::Kind::OneOrMore);
+			Assert::AreEqual(2, plus.NumNodes());
+
+			Ast mixed = Parser::Parse("a+?");
+			Assert::IsTrue(mixed.GetNode(mixed.Root()).kind == Ast::Kind::KleeneStar);
+
+			// escaped operators are plain characters
+			Ast escaped = Parser::Parse("\\*\\(");
+			Assert::AreEqual('*', escaped.GetNode(escaped.Child(escaped.Root(), 0)).input);
+			Assert::AreEqual('(', escaped.GetNode(escaped.Child(escaped.Root(), 1)).input);
+		}
+
+		TEST_METHOD(TestParserErrors)
+		{
+			auto errorAt = [](const std::string& regex) {
+				try
+				{
+					Parser::Parse(regex);
+				}
+				catch (const ParseError& e)
+				{
+					return e.Position();
+				}
+				return std::string::npos;
+			};
+
+			Assert::AreEqual((size_t)0, errorAt("*a"));
+			Assert::AreEqual((size_t)3, errorAt("ab|+"));
+			Assert::AreEqual((size_t)2, errorAt("a(?)"));
+			Assert::AreEqual((size_t)1, errorAt("a(b(c)"));
+			Assert::AreEqual((size_t)2, errorAt("ab)c"));
+			Assert::AreEqual((size_t)1, errorAt("a\\"));
+			Assert::AreEqual(std::string::npos, errorAt("a(b)c\\)"));
+
+			// nesting deeper than the parser allows is an error, not a stack overflow
+			std::string deep = std::string(5000, '(') + "a" + std::string(5000, ')');
+			Assert::ExpectException<ParseError>([&]() { Parser::Parse(deep); });
+		}
+	};
+}
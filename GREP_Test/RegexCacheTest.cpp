@@ -0,0 +1,44 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "../GREP/RegexCache.h"
+
+#include <filesystem>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace GREPTest
+{
+	TEST_CLASS(RegexCacheTest)
+	{
+	public:
+
+		TEST_METHOD(TestRegexCache)
+		{
+			std::filesystem::path directory = std::filesystem::temp_directory_path() / "GREP_Test_RegexCache";
+			std::filesystem::remove_all(directory);
+			RegexCache cache(directory.string());
+
+			std::vector<std::string> patterns = { "ab*c", "^x" };
+			Regex regex;
+			Assert::IsFalse(cache.Load(patterns, true, regex));
+
+			Assert::IsTrue(cache.Store(patterns, true, Regex::Parse(patterns)));
+			Assert::IsTrue(cache.Load(patterns, true, regex));
+
+			std::vector<Regex::Span> matches;
+			Assert::AreEqual((size_t)2, regex.Match("xabbc", matches));
+			Assert::AreEqual((size_t)1, matches[1].offset);
+			std::vector<int> ids;
+			Assert::AreEqual((size_t)2, regex.MatchingPatterns("xabbc", ids));
+
+			// only the same patterns, compiled the same way, are found
+			Assert::IsFalse(cache.Load({ "ab*", "c^x" }, true, regex));
+			Assert::IsFalse(cache.Load(patterns, false, regex));
+
+			// plain literals are not kept
+			Assert::IsFalse(cache.Store({ "abc" }, true, Regex::Parse(std::vector<std::string>{ "abc", "de" })));
+
+			std::filesystem::remove_all(directory);
+		}
+	};
+}
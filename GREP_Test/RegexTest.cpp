@@ -97,5 +97,202 @@ namespace GREPTest
 			Assert::AreEqual(std::string("qwer"), matches[1].first);
 			Assert::AreEqual(std::string("abc"), matches[2].first);
 		}
+
+		TEST_METHOD(TestRegexLeftmostLongest)
+		{
+			Regex regex = Regex::Parse("a*");
+			std::vector<std::pair<std::string, int>> matches = regex.Match(std::string(10000, 'a'));
+
+			Assert::AreEqual(1, (int)matches.size());
+			Assert::AreEqual(10000, (int)matches[0].first.size());
+			Assert::AreEqual(0, matches[0].second);
+
+			// the match starting first wins, even if a later one ends first
+			regex = Regex::Parse("ab|bcde");
+			matches = regex.Match("abcde");
+
+			Assert::AreEqual(1, (int)matches.size());
+			Assert::AreEqual(std::string("ab"), matches[0].first);
+			Assert::AreEqual(0, matches[0].second);
+
+			regex = Regex::Parse("abcd|c");
+			matches = regex.Match("xabcdc");
+
+			Assert::AreEqual(2, (int)matches.size());
+			Assert::AreEqual(std::string("abcd"), matches[0].first);
+			Assert::AreEqual(1, matches[0].second);
+			Assert::AreEqual(std::string("c"), matches[1].first);
+			Assert::AreEqual(5, matches[1].second);
+
+			regex = Regex::Parse("^ab");
+			matches = regex.Match("abab");
+
+			Assert::AreEqual(1, (int)matches.size());
+			Assert::AreEqual(0, matches[0].second);
+		}
+
+		TEST_METHOD(TestRegexSpans)
+		{
+			Regex regex = Regex::Parse("^a.|b$");
+			std::vector<Regex::Span> matches;
+
+			Assert::AreEqual((size_t)2, regex.Match("axxb", matches));
+			Assert::AreEqual((size_t)0, matches[0].offset);
+			Assert::AreEqual((size_t)2, matches[0].length);
+			Assert::AreEqual((size_t)3, matches[1].offset);
+			Assert::AreEqual((size_t)1, matches[1].length);
+
+			// the buffer is reused, and bytes that used to be line markers are ordinary input
+			std::string text = "a";
+			text += Regex::LINE_END;
+			Assert::AreEqual((size_t)1, regex.Match(text, matches));
+			Assert::AreEqual((size_t)2, matches[0].length);
+
+			Assert::AreEqual((size_t)0, regex.Match("xaxbx", matches));
+			Assert::AreEqual((size_t)0, matches.size());
+		}
+
+		TEST_METHOD(TestRegexFindLine)
+		{
+			Regex regex = Regex::Parse("b.$|^d");
+			std::string text = "aaa\nxbxx\nabc\nbad\ndd";
+			Regex::Span line;
+
+			Assert::AreEqual(true, regex.FindLine(text, 0, line));
+			Assert::AreEqual(std::string("abc"), text.substr(line.offset, line.length));
+
+			Assert::AreEqual(true, regex.FindLine(text, line.offset + line.length + 1, line));
+			Assert::AreEqual(std::string("dd"), text.substr(line.offset, line.length));
+
+			Assert::AreEqual(false, regex.FindLine(text, line.offset + line.length + 1, line));
+
+			// every line is found when the regex can match the empty string
+			regex = Regex::Parse("x*");
+			Assert::AreEqual(true, regex.FindLine(text, 4, line));
+			Assert::AreEqual(std::string("xbxx"), text.substr(line.offset, line.length));
+		}
+	
+		TEST_METHOD(TestRegexRequiredLiteral)
+		{
+			Assert::AreEqual(std::string("timeout"), Regex::Parse("ERROR.*timeout").RequiredLiteral());
+			Assert::AreEqual(std::string("ERROR"), Regex::Parse("ERROR.*to").RequiredLiteral());
+			Assert::AreEqual(std::string("abcd"), Regex::Parse("^ab(cd)+e*").RequiredLiteral());
+			Assert::AreEqual(std::string("xyz"), Regex::Parse("(axyz|bxyz)q?").RequiredLiteral());
+			Assert::AreEqual(std::string("a.b"), Regex::Parse("a\\.b").RequiredLiteral());
+			Assert::AreEqual(std::string(""), Regex::Parse("ab|cd").RequiredLiteral());
+			Assert::AreEqual(std::string(""), Regex::Parse("(abc)*").RequiredLiteral());
+
+			// lines without the literal are skipped, lines with it are still checked by the dfa
+			Regex regex = Regex::Parse("ERROR.*timeout");
+			std::string text = "timeout\nERROR only\nERROR: read timeout\nERROR";
+			Regex::Span line;
+
+			Assert::AreEqual(true, regex.FindLine(text, 0, line));
+			Assert::AreEqual(std::string("ERROR: read timeout"), text.substr(line.offset, line.length));
+			Assert::AreEqual(false, regex.FindLine(text, line.offset + line.length + 1, line));
+		}
+	
+		TEST_METHOD(TestRegexLazy)
+		{
+			// the dfa for this has 2^16 states, too many to build before matching
+			std::string pattern = "(a|b)*a";
+			for (int i = 0; i < 15; ++i)
+			{
+				pattern += "(a|b)";
+			}
+			Regex regex = Regex::Parse(pattern);
+
+			std::vector<Regex::Span> matches;
+			Assert::AreEqual((size_t)1, regex.Match("cabbbbbbbbbbbbbbbbc", matches));
+			Assert::AreEqual((size_t)1, matches[0].offset);
+			Assert::AreEqual((size_t)16, matches[0].length);
+
+			// the match starts at the leftmost b, which the (a|b)* can take
+			Assert::AreEqual((size_t)1, regex.Match("cbabbbbbbbbbbbbbbbc", matches));
+			Assert::AreEqual((size_t)1, matches[0].offset);
+			Assert::AreEqual((size_t)17, matches[0].length);
+
+			Assert::AreEqual((size_t)0, regex.Match("cabbbbbbbbbbbbbbc", matches));
+		}
+
+		TEST_METHOD(TestRegexIsMatch)
+		{
+			// the lazy pattern has too many states to build up front, and the literals are found
+			// with Aho-Corasick. x*, ^ and a*$ match the empty string, which IsMatch does not count
+			std::string lazy = "(a|b)*a";
+			for (int i = 0; i < 12; ++i)
+			{
+				lazy += "(a|b)";
+			}
+
+			std::vector<std::string> patterns = { "ab+c|^x|y$", "ERROR.*timeout", "abc|bcd", "x*", "^", "a*$", lazy };
+			std::vector<std::string> lines = { "", "x", "zzabbc", "xyz", "zy", "ERROR: read timeout", "ERROR",
+				"bcdx", "qqq", "aaa", "abbbbbbbbbbbbbb", "ab" };
+
+			std::vector<Regex::Span> matches;
+			for (const std::string& pattern : patterns)
+			{
+				Regex regex = Regex::Parse(pattern);
+				for (const std::string& line : lines)
+				{
+					Assert::AreEqual(regex.Match(line, matches) > 0, regex.IsMatch(line));
+				}
+			}
+
+			Regex regex = Regex::Parse("x*");
+			Assert::IsTrue(regex.IsMatch("abxc"));
+			Assert::IsFalse(regex.IsMatch("abc"));
+		}
+
+		TEST_METHOD(TestRegexPatterns)
+		{
+			Regex regex = Regex::Parse(std::vector<std::string>{ "ab", "bc", "^x", "ab" });
+			Assert::AreEqual(4, regex.NumPatterns());
+
+			// the leftmost-longest match is ab, but bc still matches where it overlaps it
+			std::vector<int> patterns;
+			Assert::AreEqual((size_t)3, regex.MatchingPatterns("abc", patterns));
+			Assert::AreEqual(0, patterns[0]);
+			Assert::AreEqual(1, patterns[1]);
+			Assert::AreEqual(3, patterns[2]);
+
+			Assert::AreEqual((size_t)2, regex.MatchingPatterns("xbc", patterns));
+			Assert::AreEqual(1, patterns[0]);
+			Assert::AreEqual(2, patterns[1]);
+			Assert::AreEqual((size_t)0, regex.MatchingPatterns("axb", patterns));
+
+			// the lines are found by one search for all of the patterns
+			std::vector<Regex::Span> matches;
+			Assert::AreEqual((size_t)3, regex.Match("xbc ab", matches));
+			Assert::AreEqual((size_t)1, matches[1].offset);
+			Assert::AreEqual((size_t)4, matches[2].offset);
+		}
+
+		TEST_METHOD(TestRegexSerialize)
+		{
+			Regex regex = Regex::Parse(std::vector<std::string>{ "a.c", "^b+" });
+			auto data = std::make_shared<std::string>();
+			Assert::IsTrue(regex.Serialize(*data));
+
+			size_t offset = 0;
+			Regex loaded;
+			Assert::IsTrue(Regex::Load(*data, offset, data, loaded));
+			Assert::AreEqual(data->size(), offset);
+			Assert::AreEqual(2, loaded.NumPatterns());
+			Assert::AreEqual(regex.GetStatistics().minimizedSearchStates, loaded.GetStatistics().minimizedSearchStates);
+
+			std::vector<Regex::Span> matches;
+			Assert::AreEqual((size_t)2, loaded.Match("bbxabc", matches));
+			Assert::AreEqual((size_t)3, matches[1].offset);
+
+			std::vector<int> patterns;
+			Assert::AreEqual((size_t)2, loaded.MatchingPatterns("bbxabc", patterns));
+			Assert::AreEqual((size_t)0, loaded.MatchingPatterns("abd", patterns));
+
+			// plain literals are not found with dfas, so there are none to write
+			std::string literalData;
+			Assert::IsFalse(Regex::Parse("abc|def").Serialize(literalData));
+			Assert::IsTrue(literalData.empty());
+		}
 	};
 }
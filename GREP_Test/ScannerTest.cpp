@@ -0,0 +1,95 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "../GREP/Scanner.h"
+
+#include <algorithm>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace GREPTest
+{
+	TEST_CLASS(ScannerTest)
+	{
+	public:
+
+		/// <summary>
+		/// Feeds text to a scanner in pieces of the same size, and collects the matches
+		/// </summary>
+		static std::vector<std::pair<size_t, size_t>> Scan(Scanner& scanner, const std::string& text, size_t pieceSize)
+		{
+			std::vector<std::pair<size_t, size_t>> matches;
+			for (size_t offset = 0; offset < text.size(); offset += pieceSize)
+			{
+				scanner.Feed(text.data() + offset, std::min(pieceSize, text.size() - offset));
+				for (const Regex::Span& match : scanner.Matches())
+				{
+					matches.push_back({ match.offset, match.length });
+				}
+			}
+
+			scanner.Finish();
+			for (const Regex::Span& match : scanner.Matches())
+			{
+				matches.push_back({ match.offset, match.length });
+			}
+
+			return matches;
+		}
+
+		TEST_METHOD(TestScanner)
+		{
+			// ^ and $ apply to each line, and the matches are found wherever the pieces split them
+			Regex regex = Regex::Parse("ab+c|^x|y$");
+			std::string text = "xabbbc\nzzabc\nxyzy\ny";
+			std::vector<std::pair<size_t, size_t>> expected = { { 0, 1 }, { 1, 5 }, { 9, 3 }, { 13, 1 }, { 16, 1 }, { 18, 1 } };
+
+			for (size_t pieceSize = 1; pieceSize <= text.size(); ++pieceSize)
+			{
+				Scanner scanner(regex);
+				Assert::IsTrue(expected == Scan(scanner, text, pieceSize));
+
+				// the offsets of the next stream start from 0 again
+				Assert::IsTrue(expected == Scan(scanner, text, pieceSize));
+			}
+		}
+
+		TEST_METHOD(TestScannerLiterals)
+		{
+			Regex regex = Regex::Parse(std::vector<std::string>{ "abc", "bcd|xy" });
+			std::string text = "abcd\nzxy\n";
+			std::vector<std::pair<size_t, size_t>> expected = { { 0, 3 }, { 6, 2 } };
+
+			for (size_t pieceSize = 1; pieceSize <= text.size(); ++pieceSize)
+			{
+				Scanner scanner(regex);
+				Assert::IsTrue(expected == Scan(scanner, text, pieceSize));
+			}
+		}
+
+		TEST_METHOD(TestScannerAgainstMatch)
+		{
+			Regex regex = Regex::Parse("(a|b)*a(a|b)|b?");
+			std::string text = "ababbaab\nbbb\n\naaaa\nbab";
+
+			std::vector<std::pair<size_t, size_t>> expected;
+			size_t lineStart = 0;
+			while (lineStart <= text.size())
+			{
+				size_t lineEnd = std::min(text.find('\n', lineStart), text.size());
+				std::vector<Regex::Span> matches;
+				regex.Match(std::string_view(text).substr(lineStart, lineEnd - lineStart), matches);
+				for (const Regex::Span& match : matches)
+				{
+					expected.push_back({ lineStart + match.offset, match.length });
+				}
+				lineStart = lineEnd + 1;
+			}
+
+			for (size_t pieceSize = 1; pieceSize <= text.size(); ++pieceSize)
+			{
+				Scanner scanner(regex);
+				Assert::IsTrue(expected == Scan(scanner, text, pieceSize));
+			}
+		}
+	};
+}
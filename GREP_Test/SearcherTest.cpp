@@ -0,0 +1,81 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "../GREP/Searcher.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#ifdef _WIN32
+#define fileno _fileno
+#endif
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace GREPTest
+{
+	TEST_CLASS(SearcherTest)
+	{
+	public:
+
+		TEST_METHOD(TestSearcherFileOrder)
+		{
+			std::filesystem::path directory = std::filesystem::temp_directory_path() / "GREP_Test_Searcher";
+			std::filesystem::remove_all(directory);
+			std::filesystem::create_directories(directory / "sub");
+
+			// the files are of very different sizes, so they finish searching out of order
+			std::vector<std::string> paths;
+			std::string expected;
+			for (int i = 0; i < 40; ++i)
+			{
+				std::filesystem::path path = directory / ((i % 4 == 0 ? "sub/f" : "f") + std::to_string(i));
+				int numLines = (i * 7919 % 40) * 2000;
+				std::ofstream file(path, std::ios::binary);
+				for (int line = 0; line < numLines; ++line)
+				{
+					file << "a match\n";
+				}
+
+				if (i % 4 != 0)
+				{
+					paths.push_back(path.string());
+					expected += path.string() + ":" + std::to_string(numLines) + "\n";
+				}
+			}
+
+			// the files of a directory come after the files listed before it, in the order it lists them
+			paths.push_back((directory / "sub").string());
+			for (const auto& entry : std::filesystem::directory_iterator(directory / "sub"))
+			{
+				std::ifstream file(entry.path(), std::ios::binary);
+				std::stringstream text;
+				text << file.rdbuf();
+				std::string lines = text.str();
+				size_t numLines = std::count(lines.begin(), lines.end(), '\n');
+				expected += entry.path().string() + ":" + std::to_string(numLines) + "\n";
+			}
+
+			Regex regex = Regex::Parse("match");
+			Searcher searcher(regex, 4, false, OutputBuffer::Highlight::None, Searcher::Mode::Count);
+			for (int run = 0; run < 3; ++run)
+			{
+				std::filesystem::path outputPath = directory / "output";
+				std::FILE* output = std::fopen(outputPath.string().c_str(), "wb");
+				bool found = false;
+				Assert::IsTrue(searcher.Search(paths, true, fileno(output), found));
+				Assert::IsTrue(found);
+				std::fclose(output);
+
+				std::ifstream file(outputPath, std::ios::binary);
+				std::stringstream text;
+				text << file.rdbuf();
+				Assert::AreEqual(expected, text.str());
+			}
+
+			std::filesystem::remove_all(directory);
+		}
+	};
+}
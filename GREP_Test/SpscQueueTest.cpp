@@ -0,0 +1,79 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "../GREP/SpscQueue.h"
+
+#include <memory>
+#include <string>
+#include <thread>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace GREPTest
+{
+	TEST_CLASS(SpscQueueTest)
+	{
+	public:
+
+		TEST_METHOD(TestSpscQueueFullAndEmpty)
+		{
+			// the capacity is rounded up to a power of two
+			SpscQueue<std::unique_ptr<int>> queue(3);
+			Assert::AreEqual((size_t)4, queue.Capacity());
+
+			std::unique_ptr<int> item;
+			Assert::IsFalse(queue.TryPop(item));
+
+			for (int i = 0; i < 4; ++i)
+			{
+				item = std::make_unique<int>(i);
+				Assert::IsTrue(queue.TryPush(item));
+				Assert::IsTrue(item == nullptr);
+			}
+
+			// an item that does not fit is left where it was
+			item = std::make_unique<int>(4);
+			Assert::IsFalse(queue.TryPush(item));
+			Assert::AreEqual(4, *item);
+
+			for (int i = 0; i < 4; ++i)
+			{
+				Assert::IsTrue(queue.TryPop(item));
+				Assert::AreEqual(i, *item);
+			}
+			Assert::IsFalse(queue.TryPop(item));
+		}
+
+		TEST_METHOD(TestSpscQueueBetweenThreads)
+		{
+			// the items arrive in order, and the buffers that come back keep their memory
+			SpscQueue<std::string> items(4);
+			SpscQueue<std::string> returned(4);
+			for (int i = 0; i < 4; ++i)
+			{
+				returned.Push(std::string());
+			}
+
+			const int numItems = 100000;
+			std::thread producer([&]()
+			{
+				for (int i = 0; i < numItems; ++i)
+				{
+					std::string item = returned.Pop();
+					item.assign(std::to_string(i));
+					items.Push(std::move(item));
+				}
+			});
+
+			bool inOrder = true;
+			for (int i = 0; i < numItems; ++i)
+			{
+				std::string item = items.Pop();
+				inOrder = inOrder && item == std::to_string(i);
+				returned.Push(std::move(item));
+			}
+			producer.join();
+
+			Assert::IsTrue(inOrder);
+		}
+	};
+}
@@ -0,0 +1,207 @@
+// Generated by grep --generate StarPattern. Do not edit, generate it again instead.
+// pattern: x*|b+$
+#pragma once
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+namespace StarPattern
+{
+	/// <summary>
+	/// The location of a match in the text that was searched
+	/// </summary>
+	struct Span
+	{
+		size_t offset;
+		size_t length;
+	};
+
+	/// <summary>
+	/// Finds the end of the leftmost-longest match that starts at or after start
+	/// </summary>
+	/// <returns>False if there is none</returns>
+	inline bool FindEnd(std::string_view text, size_t start, size_t& outEnd, bool& outEndsAfterLineEnd)
+	{
+		const unsigned char* data = (const unsigned char*)text.data();
+		size_t size = text.size();
+		size_t i = start;
+		bool found = false;
+		outEnd = 0;
+		outEndsAfterLineEnd = false;
+
+		if (start == 0)
+		{
+			goto search0;
+		}
+		goto search0;
+
+	search0:
+		found = true;
+		outEnd = i;
+		if (i == size)
+		{
+			return found;
+		}
+		switch (data[i++])
+		{
+		case 'b': goto search1;
+		case 'x': goto search3;
+		default: return found;
+		}
+
+	search1:
+		if (i == size)
+		{
+			found = true;
+			outEnd = size;
+			outEndsAfterLineEnd = true;
+			return found;
+		}
+		switch (data[i++])
+		{
+		case 'b': goto search1;
+		default: return found;
+		}
+
+	search3:
+		found = true;
+		outEnd = i;
+		if (i == size)
+		{
+			return found;
+		}
+		switch (data[i++])
+		{
+		case 'x': goto search3;
+		default: return found;
+		}
+
+	}
+
+	/// <summary>
+	/// Finds the start of the leftmost-longest match that ends at end
+	/// </summary>
+	/// <returns></returns>
+	inline size_t FindStart(std::string_view text, size_t start, size_t end, bool endsAfterLineEnd)
+	{
+		const unsigned char* data = (const unsigned char*)text.data();
+		size_t i = end;
+		size_t matchStart = end;
+
+		if (endsAfterLineEnd)
+		{
+			goto reverse1;
+		}
+		goto reverse2;
+
+	reverse0:
+		matchStart = i;
+		if (i == start)
+		{
+			return matchStart;
+		}
+		switch (data[--i])
+		{
+		case 'b': goto reverse0;
+		default: return matchStart;
+		}
+
+	reverse1:
+		if (i == start)
+		{
+			return matchStart;
+		}
+		switch (data[--i])
+		{
+		case 'b': goto reverse0;
+		default: return matchStart;
+		}
+
+	reverse2:
+		matchStart = i;
+		if (i == start)
+		{
+			return matchStart;
+		}
+		switch (data[--i])
+		{
+		case 'x': goto reverse3;
+		default: return matchStart;
+		}
+
+	reverse3:
+		matchStart = i;
+		if (i == start)
+		{
+			return matchStart;
+		}
+		switch (data[--i])
+		{
+		case 'x': goto reverse3;
+		default: return matchStart;
+		}
+
+	}
+
+	/// <summary>
+	/// Matches a line of text, see Regex::Match
+	/// </summary>
+	/// <param name="text">The line to match, without a line terminator</param>
+	/// <param name="outMatches">Output parameter that is cleared, then filled with the non-overlapping,
+	/// leftmost-longest matches in the order they appear. Empty matches are not reported.</param>
+	/// <returns>The number of matches found</returns>
+	inline size_t Match(std::string_view text, std::vector<Span>& outMatches)
+	{
+		outMatches.clear();
+
+		size_t start = 0;
+		while (start <= text.size())
+		{
+			size_t end;
+			bool endsAfterLineEnd;
+			if (!FindEnd(text, start, end, endsAfterLineEnd))
+			{
+				break;
+			}
+
+			size_t matchStart = FindStart(text, start, end, endsAfterLineEnd);
+			if (end > matchStart)
+			{
+				outMatches.push_back({ matchStart, end - matchStart });
+			}
+
+			// continue after this match, or one past it if it was empty
+			start = end > matchStart ? end : end + 1;
+		}
+
+		return outMatches.size();
+	}
+
+	/// <summary>
+	/// Returns true if Match would find a match in a line, so an empty match does not count
+	/// </summary>
+	/// <param name="text">The line to match, without a line terminator</param>
+	/// <returns></returns>
+	inline bool IsMatch(std::string_view text)
+	{
+		size_t start = 0;
+		while (start <= text.size())
+		{
+			size_t end;
+			bool endsAfterLineEnd;
+			if (!FindEnd(text, start, end, endsAfterLineEnd))
+			{
+				return false;
+			}
+
+			if (end > FindStart(text, start, end, endsAfterLineEnd))
+			{
+				return true;
+			}
+
+			start = end + 1;
+		}
+
+		return false;
+	}
+}
@@ -0,0 +1,74 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "../GREP/StaticRegex.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace GREPTest
+{
+	static constexpr char WORDS[] = "ab*c|^x.$";
+	static constexpr char GROUPS[] = "(a|b)*a(a|b)";
+	static constexpr char STARS[] = "x*|b+$";
+
+	// the dfas are built while compiling, so they can be run while compiling too
+	static_assert(StaticRegex<WORDS>::IsMatch("zzabbbc"), "a match in the middle of a line");
+	static_assert(!StaticRegex<WORDS>::IsMatch("zzabbb"), "no match");
+	static_assert(StaticRegex<WORDS>::IsMatch("xy"), "a match of the whole line");
+	static_assert(!StaticRegex<STARS>::IsMatch("abc"), "only empty matches");
+	static_assert(StaticRegex<STARS>::IsMatch("abcb"), "a match after empty ones");
+
+	TEST_CLASS(StaticRegexTest)
+	{
+	public:
+
+		TEST_METHOD(TestStaticRegex)
+		{
+			std::vector<Regex::Span> matches;
+			Assert::AreEqual((size_t)2, StaticRegex<WORDS>::Match("xabbc ac", matches));
+			Assert::AreEqual((size_t)1, matches[0].offset);
+			Assert::AreEqual((size_t)4, matches[0].length);
+			Assert::AreEqual((size_t)6, matches[1].offset);
+
+			// the line markers only match at the ends of the line
+			Assert::AreEqual((size_t)1, StaticRegex<WORDS>::Match("xy", matches));
+			Assert::AreEqual((size_t)0, StaticRegex<WORDS>::Match("axy", matches));
+		}
+
+		TEST_METHOD(TestStaticRegexAgainstRegex)
+		{
+			// the matches are the same as those of a Regex built at run time
+			Regex regex = Regex::Parse(GROUPS);
+			const std::string texts[] = { "", "a", "ab", "bbab", "cabbac", "abaabbbaab", "ccc" };
+			for (const std::string& text : texts)
+			{
+				std::vector<Regex::Span> expected;
+				std::vector<Regex::Span> actual;
+				regex.Match(text, expected);
+				StaticRegex<GROUPS>::Match(text, actual);
+
+				Assert::AreEqual(expected.size(), actual.size());
+				for (size_t i = 0; i < expected.size(); ++i)
+				{
+					Assert::AreEqual(expected[i].offset, actual[i].offset);
+					Assert::AreEqual(expected[i].length, actual[i].length);
+				}
+				Assert::AreEqual(!expected.empty(), StaticRegex<GROUPS>::IsMatch(text));
+			}
+		}
+
+		TEST_METHOD(TestStaticRegexEmptyMatch)
+		{
+			// IsMatch does not count the empty matches, which Match does not report
+			Regex regex = Regex::Parse(STARS);
+			const std::string texts[] = { "", "a", "ax", "xxa", "ab", "abba", "bab" };
+			for (const std::string& text : texts)
+			{
+				std::vector<Regex::Span> expected;
+				std::vector<Regex::Span> actual;
+				Assert::AreEqual(regex.Match(text, expected), StaticRegex<STARS>::Match(text, actual));
+				Assert::AreEqual(!actual.empty(), StaticRegex<STARS>::IsMatch(text));
+				Assert::AreEqual(regex.IsMatch(text), StaticRegex<STARS>::IsMatch(text));
+			}
+		}
+	};
+}
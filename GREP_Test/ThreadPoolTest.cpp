@@ -0,0 +1,54 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "../GREP/ThreadPool.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace GREPTest
+{
+	TEST_CLASS(ThreadPoolTest)
+	{
+	public:
+
+		TEST_METHOD(TestThreadPoolRunsTasks)
+		{
+			std::atomic<int> count{ 0 };
+
+			ThreadPool pool(4);
+			for (int i = 0; i < 1000; ++i)
+			{
+				pool.Submit([&count]() { count++; });
+			}
+			pool.Wait();
+
+			Assert::AreEqual(1000, count.load());
+		}
+
+		TEST_METHOD(TestThreadPoolNestedTasks)
+		{
+			std::atomic<int> count{ 0 };
+
+			// each task submits two more until a depth of 10, like walking a directory tree
+			ThreadPool pool(3);
+			std::function<void(int)> task = [&](int depth)
+			{
+				count++;
+				if (depth < 10)
+				{
+					pool.Submit([&task, depth]() { task(depth + 1); });
+					pool.Submit([&task, depth]() { task(depth + 1); });
+				}
+			};
+			pool.Submit([&task]() { task(0); });
+			pool.Wait();
+
+			Assert::AreEqual(2047, count.load());
+
+			// the pool can be reused after waiting
+			pool.Submit([&task]() { task(10); });
+			pool.Wait();
+
+			Assert::AreEqual(2048, count.load());
+		}
+	};
+}